@@ -0,0 +1,104 @@
+/*=====================================================================================
+
+    Filename:     activity_modes.cpp
+
+    Description:  Search speed of compensated double against long double
+                  activities
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "example_paths.h"
+#include "local_mip/Local_MIP.h"
+#include "model_data/Model_Manager.h"
+#include "model_data/Prepared_Model.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr const char kDefaultModelFile[] = "test-set/sct1.mps";
+
+struct Mode_Result
+{
+  std::size_t step_num = 0;
+  double seconds = 0.0;
+  std::vector<double> objectives;
+};
+
+Mode_Result run_mode(const std::shared_ptr<const Prepared_Model>& prepared,
+                     const char* arithmetic,
+                     std::uint32_t seed_num,
+                     std::size_t step_limit)
+{
+  Mode_Result result;
+  for (std::uint32_t seed = 1; seed <= seed_num; ++seed)
+  {
+    Local_MIP solver(prepared);
+    solver.set_random_seed(seed);
+    solver.set_time_limit(3600.0);
+    solver.set_step_limit(step_limit);
+    solver.set_activity_arithmetic(arithmetic);
+    solver.set_log_obj(false);
+    const auto start = std::chrono::steady_clock::now();
+    solver.run();
+    result.seconds += std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    result.step_num += solver.get_step_num();
+    if (solver.is_feasible())
+      result.objectives.push_back(solver.get_obj_value());
+  }
+  std::sort(result.objectives.begin(), result.objectives.end());
+  if (prepared->model_manager().is_min() < 0)
+    std::reverse(result.objectives.begin(), result.objectives.end());
+  return result;
+}
+
+void print_mode(const char* name, const Mode_Result& result)
+{
+  std::printf("%-12s steps %-10zu seconds %-8.2f steps/s %-10.0f "
+              "feasible %zu",
+              name,
+              result.step_num,
+              result.seconds,
+              static_cast<double>(result.step_num) / result.seconds,
+              result.objectives.size());
+  if (!result.objectives.empty())
+    std::printf("  best %.10g", result.objectives.front());
+  std::printf("\n");
+}
+
+} // namespace
+
+// Usage: activity_modes_demo [model] [seeds] [steps per run]
+int main(int argc, char** argv)
+{
+  const std::string model_file = example_paths::resolve_demo_model_path_or_exit(
+      argc, argv, kDefaultModelFile);
+  const std::uint32_t seed_num =
+      argc > 2 ? static_cast<std::uint32_t>(std::atoi(argv[2])) : 4;
+  const std::size_t step_limit =
+      argc > 3 ? static_cast<std::size_t>(std::atol(argv[3])) : 50000;
+
+  auto prepared = Prepared_Model::from_file(model_file);
+  const Mode_Result long_double =
+      run_mode(prepared, "long_double", seed_num, step_limit);
+  const Mode_Result compensated =
+      run_mode(prepared, "compensated", seed_num, step_limit);
+  std::printf("\n%s, %u seeds, %zu steps each\n",
+              model_file.c_str(),
+              seed_num,
+              step_limit);
+  print_mode("long_double", long_double);
+  print_mode("compensated", compensated);
+  return 0;
+}
@@ -138,6 +138,8 @@ demos=(
     "neighbor-userdata/neighbor_userdata_demo"
     "model-api/model_api_demo"
     "parallel-multiseed/parallel_multiseed_demo"
+    "equality-modes/equality_modes_demo"
+    "activity-modes/activity_modes_demo"
 )
 
 for demo in "${demos[@]}"; do
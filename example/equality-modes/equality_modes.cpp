@@ -0,0 +1,107 @@
+/*=====================================================================================
+
+    Filename:     equality_modes.cpp
+
+    Description:  Search quality of native equalities against split rows
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "example_paths.h"
+#include "local_mip/Local_MIP.h"
+#include "model_data/Model_Manager.h"
+#include "model_data/Prepared_Model.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr const char kDefaultModelFile[] = "test-set/sct1.mps";
+
+struct Mode_Result
+{
+  std::size_t row_num = 0;
+  std::size_t nnz = 0;
+  std::vector<double> objectives;
+};
+
+Mode_Result run_mode(const std::string& model_file,
+                     bool split_eq,
+                     std::uint32_t seed_num,
+                     double time_limit)
+{
+  Model_Prepare_Options options;
+  options.split_eq = split_eq;
+  auto prepared = Prepared_Model::from_file(model_file, options);
+  const Model_Manager& manager = prepared->model_manager();
+
+  Mode_Result result;
+  result.row_num = manager.matrix().row_num();
+  result.nnz = manager.matrix().nnz();
+  for (std::uint32_t seed = 1; seed <= seed_num; ++seed)
+  {
+    Local_MIP solver(prepared);
+    solver.set_random_seed(seed);
+    solver.set_time_limit(time_limit);
+    solver.set_log_obj(false);
+    solver.run();
+    if (solver.is_feasible())
+      result.objectives.push_back(solver.get_obj_value());
+  }
+  // Best first in the original objective direction.
+  std::sort(result.objectives.begin(), result.objectives.end());
+  if (manager.is_min() < 0)
+    std::reverse(result.objectives.begin(), result.objectives.end());
+  return result;
+}
+
+void print_mode(const char* name, const Mode_Result& result)
+{
+  std::printf("%-8s rows %-8zu nnz %-10zu feasible %zu",
+              name,
+              result.row_num,
+              result.nnz,
+              result.objectives.size());
+  if (!result.objectives.empty())
+  {
+    const std::size_t size = result.objectives.size();
+    const double median = (result.objectives[(size - 1) / 2] +
+                           result.objectives[size / 2]) /
+                          2.0;
+    double sum = 0.0;
+    for (double objective : result.objectives)
+      sum += objective;
+    std::printf("  best %.10g  median %.10g  mean %.10g",
+                result.objectives.front(),
+                median,
+                sum / static_cast<double>(size));
+  }
+  std::printf("\n");
+}
+
+} // namespace
+
+// Usage: equality_modes_demo [model] [seeds] [seconds per run]
+int main(int argc, char** argv)
+{
+  const std::string model_file = example_paths::resolve_demo_model_path_or_exit(
+      argc, argv, kDefaultModelFile);
+  const std::uint32_t seed_num =
+      argc > 2 ? static_cast<std::uint32_t>(std::atoi(argv[2])) : 8;
+  const double time_limit = argc > 3 ? std::atof(argv[3]) : 5.0;
+
+  const Mode_Result split = run_mode(model_file, true, seed_num, time_limit);
+  const Mode_Result native = run_mode(model_file, false, seed_num, time_limit);
+  std::printf("\n%s, %u seeds, %.1f s each\n",
+              model_file.c_str(),
+              seed_num,
+              time_limit);
+  print_mode("split", split);
+  print_mode("native", native);
+  return 0;
+}
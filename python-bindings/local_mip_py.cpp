@@ -7,6 +7,7 @@
 #include <memory>
 #include <random>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -82,6 +83,7 @@ private:
 using ReadonlyBoolVectorView = ReadonlyVectorView<bool>;
 using ReadonlyDoubleVectorView = ReadonlyVectorView<double>;
 using ReadonlySizeVectorView = ReadonlyVectorView<size_t>;
+using ReadonlyIdxVectorView = ReadonlyVectorView<Model_Idx>;
 
 class DoubleVectorView
 {
@@ -320,6 +322,19 @@ PYBIND11_MODULE(localmip_py, m)
                                       self.values().end()); },
            py::keep_alive<0, 1>());
 
+  if constexpr (!std::is_same_v<Model_Idx, size_t>)
+  {
+    py::class_<ReadonlyIdxVectorView>(m, "ReadonlyIdxVectorView")
+        .def("__len__", &ReadonlyIdxVectorView::size)
+        .def("__getitem__", &ReadonlyIdxVectorView::get)
+        .def("to_list", &ReadonlyIdxVectorView::to_list)
+        .def("__iter__",
+             [](const ReadonlyIdxVectorView& self)
+             { return py::make_iterator(self.values().begin(),
+                                        self.values().end()); },
+             py::keep_alive<0, 1>());
+  }
+
   py::class_<DoubleVectorView>(m, "DoubleVectorView")
       .def("__len__", &DoubleVectorView::size)
       .def("__getitem__", &DoubleVectorView::get)
@@ -376,7 +391,10 @@ PYBIND11_MODULE(localmip_py, m)
                      &Model_Prepare_Options::zero_tolerance)
       .def_readwrite("bound_strengthen",
                      &Model_Prepare_Options::bound_strengthen)
-      .def_readwrite("split_eq", &Model_Prepare_Options::split_eq);
+      .def_readwrite("split_eq", &Model_Prepare_Options::split_eq)
+      .def_readwrite("dup_presolve", &Model_Prepare_Options::dup_presolve)
+      .def_readwrite("presolve_threads",
+                     &Model_Prepare_Options::presolve_threads);
 
   // pybind11 holders use shared_ptr<T>; expose only const Prepared_Model
   // operations and cast away constness solely at the binding boundary.
@@ -397,6 +415,26 @@ PYBIND11_MODULE(localmip_py, m)
           },
           py::arg("path"),
           py::arg("options") = Model_Prepare_Options())
+      .def_static(
+          "load",
+          [](const std::string& path)
+          {
+            std::shared_ptr<const Prepared_Model> prepared;
+            {
+              py::gil_scoped_release release;
+              prepared = Prepared_Model::load(path);
+            }
+            return std::const_pointer_cast<Prepared_Model>(prepared);
+          },
+          py::arg("path"))
+      .def(
+          "save",
+          [](const Prepared_Model& self, const std::string& path)
+          {
+            py::gil_scoped_release release;
+            self.save(path);
+          },
+          py::arg("path"))
       .def_property_readonly(
           "model_manager",
           [](const Prepared_Model& self) -> const Model_Manager&
@@ -582,7 +620,7 @@ PYBIND11_MODULE(localmip_py, m)
       .def_property_readonly("binary_indices",
                              [](const Model_Manager& self)
                              {
-                               return ReadonlySizeVectorView(
+                               return ReadonlyIdxVectorView(
                                    &self.binary_idx_list());
                              },
                              py::keep_alive<0, 1>())
@@ -597,7 +635,7 @@ PYBIND11_MODULE(localmip_py, m)
           "non_fixed_var_indices",
           [](const Model_Manager& self)
           {
-            return ReadonlySizeVectorView(&self.non_fixed_var_idxs());
+            return ReadonlyIdxVectorView(&self.non_fixed_var_idxs());
           },
           py::keep_alive<0, 1>())
       .def_property_readonly("var_obj_cost",
@@ -662,7 +700,7 @@ PYBIND11_MODULE(localmip_py, m)
       .def_property_readonly("con_unsat_idxs",
                              [](const Readonly_Ctx& self)
                              {
-                               return ReadonlySizeVectorView(
+                               return ReadonlyIdxVectorView(
                                    &self.m_con_unsat_idxs);
                              },
                              py::keep_alive<0, 1>())
@@ -670,13 +708,13 @@ PYBIND11_MODULE(localmip_py, m)
           "con_pos_in_unsat_idxs",
           [](const Readonly_Ctx& self)
           {
-            return ReadonlySizeVectorView(&self.m_con_pos_in_unsat_idxs);
+            return ReadonlyIdxVectorView(&self.m_con_pos_in_unsat_idxs);
           },
           py::keep_alive<0, 1>())
       .def_property_readonly("con_sat_idxs",
                              [](const Readonly_Ctx& self)
                              {
-                               return ReadonlySizeVectorView(
+                               return ReadonlyIdxVectorView(
                                    &self.m_con_sat_idxs);
                              },
                              py::keep_alive<0, 1>())
@@ -736,7 +774,7 @@ PYBIND11_MODULE(localmip_py, m)
       .def_property_readonly("binary_idx_list",
                              [](const Readonly_Ctx& self)
                              {
-                               return ReadonlySizeVectorView(
+                               return ReadonlyIdxVectorView(
                                    &self.m_binary_idx_list);
                              },
                              py::keep_alive<0, 1>())
@@ -744,7 +782,7 @@ PYBIND11_MODULE(localmip_py, m)
           "non_fixed_var_idx_list",
           [](const Readonly_Ctx& self)
           {
-            return ReadonlySizeVectorView(&self.m_non_fixed_var_idx_list);
+            return ReadonlyIdxVectorView(&self.m_non_fixed_var_idx_list);
           },
           py::keep_alive<0, 1>());
 
@@ -905,6 +943,14 @@ PYBIND11_MODULE(localmip_py, m)
            py::arg("var_idx"),
            py::arg("delta"));
 
+  py::class_<Shared_Incumbent, std::shared_ptr<Shared_Incumbent>>(
+      m, "SharedIncumbent")
+      .def(py::init<>())
+      .def_property_readonly("best_obj", &Shared_Incumbent::best_obj)
+      .def_property_readonly("has_solution",
+                             &Shared_Incumbent::has_solution)
+      .def("request_stop", &Shared_Incumbent::request_stop);
+
   py::class_<Local_MIP>(m, "LocalMIP")
       .def(py::init<>())
       .def(py::init(
@@ -924,14 +970,33 @@ PYBIND11_MODULE(localmip_py, m)
            &Local_MIP::set_time_limit,
            py::arg("seconds"))
       .def("set_sol_path", &Local_MIP::set_sol_path, py::arg("path"))
+      .def("set_sol_interval",
+           &Local_MIP::set_sol_interval,
+           py::arg("seconds"))
       .def("set_start_sol_path",
            &Local_MIP::set_start_sol_path,
            py::arg("path"))
       .def("set_log_obj", &Local_MIP::set_log_obj, py::arg("enable"))
+      .def("set_obj_reference",
+           &Local_MIP::set_obj_reference,
+           py::arg("obj"))
+      .def("set_trajectory_path",
+           &Local_MIP::set_trajectory_path,
+           py::arg("path"))
+      .def("set_checkpoint_path",
+           &Local_MIP::set_checkpoint_path,
+           py::arg("path"))
+      .def("set_resume_path", &Local_MIP::set_resume_path, py::arg("path"))
+      .def("set_step_limit", &Local_MIP::set_step_limit, py::arg("steps"))
+      .def("checkpoint", &Local_MIP::checkpoint, py::arg("path"))
       .def("set_bound_strengthen",
            &Local_MIP::set_bound_strengthen,
            py::arg("level"))
       .def("set_split_eq", &Local_MIP::set_split_eq, py::arg("enable"))
+      .def("set_presolve_threads",
+           &Local_MIP::set_presolve_threads,
+           py::arg("thread_num"))
+      .def("set_dup_presolve", &Local_MIP::set_dup_presolve, py::arg("enable"))
       .def("set_random_seed", &Local_MIP::set_random_seed, py::arg("seed"))
       .def("set_feas_tolerance",
            &Local_MIP::set_feas_tolerance,
@@ -1047,6 +1112,15 @@ PYBIND11_MODULE(localmip_py, m)
       .def("set_activity_period",
            &Local_MIP::set_activity_period,
            py::arg("value"))
+      .def("set_activity_arithmetic",
+           &Local_MIP::set_activity_arithmetic,
+           py::arg("name"))
+      .def("set_score_cache",
+           &Local_MIP::set_score_cache,
+           py::arg("enable"))
+      .def("set_score_threads",
+           &Local_MIP::set_score_threads,
+           py::arg("thread_num"))
       .def("set_tabu_variation",
            &Local_MIP::set_tabu_variation,
            py::arg("value"))
@@ -1054,6 +1128,18 @@ PYBIND11_MODULE(localmip_py, m)
            &Local_MIP::set_break_eq_feas,
            py::arg("enable"))
 
+      // Portfolio
+      .def("set_threads", &Local_MIP::set_threads, py::arg("thread_num"))
+      .def("set_objective_cutoff",
+           &Local_MIP::set_objective_cutoff,
+           py::arg("obj_cutoff"))
+      .def("set_shared_incumbent",
+           &Local_MIP::set_shared_incumbent,
+           py::arg("incumbent"))
+      .def("set_incumbent_sync_period",
+           &Local_MIP::set_incumbent_sync_period,
+           py::arg("value"))
+
       // Callbacks
       .def(
           "set_start_cbk",
@@ -1277,6 +1363,18 @@ PYBIND11_MODULE(localmip_py, m)
       .def("get_obj_value", &Local_MIP::get_obj_value)
       .def("is_feasible", &Local_MIP::is_feasible)
       .def("get_solution", &Local_MIP::get_solution)
+      .def("get_trajectory",
+           [](const Local_MIP& self)
+           {
+             py::list points;
+             for (const auto& point : self.get_trajectory().points())
+               points.append(
+                   py::make_tuple(point.m_seconds, point.m_step, point.m_obj));
+             return points;
+           })
+      .def("get_primal_integral",
+           [](const Local_MIP& self)
+           { return self.get_trajectory().primal_integral(); })
       .def("get_model_manager",
            &Local_MIP::get_model_manager,
            py::return_value_policy::reference_internal);
@@ -0,0 +1,75 @@
+/*=====================================================================================
+
+    Filename:     Async_Sol_Writer.cpp
+
+    Description:  Background thread dumping improving solutions to disk
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "Async_Sol_Writer.h"
+#include "../reader/Sol_Writer.h"
+#include <cstdio>
+#include <utility>
+
+Async_Sol_Writer::Async_Sol_Writer()
+    : m_model_manager(nullptr), m_snapshot(nullptr), m_sol_path(""),
+      m_interval(0.0), m_thread(), m_mutex(), m_cv(), m_stop(true),
+      m_write_num(0), m_values(), m_buffer()
+{
+}
+
+Async_Sol_Writer::~Async_Sol_Writer()
+{
+  stop();
+}
+
+void Async_Sol_Writer::start(const Model_Manager& p_model_manager,
+                             std::shared_ptr<Incumbent_Snapshot> p_snapshot,
+                             const std::string& p_sol_path,
+                             double p_interval)
+{
+  stop();
+  m_model_manager = &p_model_manager;
+  m_snapshot = std::move(p_snapshot);
+  m_sol_path = p_sol_path;
+  m_interval = std::chrono::duration<double>(p_interval);
+  m_write_num = 0;
+  m_stop = false;
+  m_thread = std::thread(&Async_Sol_Writer::run, this);
+}
+
+void Async_Sol_Writer::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void Async_Sol_Writer::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_cv.wait_for(lock, m_interval, [this]() { return m_stop; }))
+  {
+    lock.unlock();
+    if (m_snapshot->acquire())
+      write_front();
+    lock.lock();
+  }
+}
+
+void Async_Sol_Writer::write_front()
+{
+  m_values = m_snapshot->front().m_values;
+  m_model_manager->postsolve_values(m_values);
+  Sol_Writer::format(*m_model_manager, m_values, m_buffer);
+  if (Sol_Writer::write_atomically(m_sol_path, m_buffer))
+    ++m_write_num;
+  else
+    printf("c cannot write incremental solution to %s.\n",
+           m_sol_path.c_str());
+}
@@ -0,0 +1,81 @@
+/*=====================================================================================
+
+    Filename:     Async_Sol_Writer.h
+
+    Description:  Background thread dumping improving solutions to disk
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include "../local_search/incumbent/incumbent_snapshot.h"
+#include "../model_data/Model_Manager.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Wakes up once per interval and, when the search published a newer
+// incumbent into the snapshot, postsolves a copy and writes it to the .sol
+// path with Sol_Writer::write_atomically. Postsolve, formatting and I/O all
+// run on the writer thread; the search only pays for the snapshot copy.
+// Incumbents superseded within one interval are never written.
+class Async_Sol_Writer
+{
+public:
+  Async_Sol_Writer();
+
+  Async_Sol_Writer(const Async_Sol_Writer&) = delete;
+
+  Async_Sol_Writer& operator=(const Async_Sol_Writer&) = delete;
+
+  ~Async_Sol_Writer();
+
+  void start(const Model_Manager& p_model_manager,
+             std::shared_ptr<Incumbent_Snapshot> p_snapshot,
+             const std::string& p_sol_path,
+             double p_interval);
+
+  // Joins the thread without a last write; the final solution is written
+  // by the caller after the search has stopped.
+  void stop();
+
+  inline size_t write_num() const;
+
+private:
+  const Model_Manager* m_model_manager;
+
+  std::shared_ptr<Incumbent_Snapshot> m_snapshot;
+
+  std::string m_sol_path;
+
+  std::chrono::duration<double> m_interval;
+
+  std::thread m_thread;
+
+  std::mutex m_mutex;
+
+  std::condition_variable m_cv;
+
+  bool m_stop;
+
+  size_t m_write_num;
+
+  std::vector<double> m_values;
+
+  std::string m_buffer;
+
+  void run();
+
+  void write_front();
+};
+
+inline size_t Async_Sol_Writer::write_num() const
+{
+  return m_write_num;
+}
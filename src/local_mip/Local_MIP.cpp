@@ -20,6 +20,7 @@
 #include "../utils/solver_error.h"
 #include "Local_MIP.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cmath>
@@ -27,6 +28,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -36,18 +38,39 @@
 #include <utility>
 #include <vector>
 
+namespace
+{
+
+// Improvements are drained often so the rings stay short; the objective
+// is printed at most once per log period.
+constexpr auto k_improvement_drain_period = std::chrono::milliseconds(10);
+
+constexpr auto k_obj_log_period = std::chrono::milliseconds(100);
+
+} // namespace
+
 Local_MIP::Local_MIP(
     std::unique_ptr<Model_Manager> p_owned_model_manager,
     std::shared_ptr<const Prepared_Model> p_prepared_model)
     : m_model_file(""), m_param_set_file(""), m_start_sol_path(""),
-      m_time_limit(10.0), m_run_start(), m_lifecycle_mutex(),
+      m_time_limit(10.0), m_run_start(), m_search_seconds(0.0),
+      m_lifecycle_mutex(),
       m_run_started(false), m_timeout_thread(), m_timeout_mutex(),
       m_timeout_cv(), m_cancel_timeout(true), m_obj_log_thread(),
       m_stop_obj_log(true), m_user_termination_requested(false),
-      m_log_obj_enabled(true),
+      m_log_obj_enabled(true), m_trajectory(), m_obj_reference(k_inf),
+      m_trajectory_path(""), m_checkpoint_path(""),
+      m_search_finished(false), m_improvement_cbk(nullptr),
+      m_improvement_user_data(nullptr), m_incumbent_snapshot(nullptr),
+      m_improvement_mutex(), m_notified_obj(k_inf), m_sol_interval(1.0),
+      m_sol_snapshot(nullptr), m_sol_writer(),
       m_owned_model_manager(std::move(p_owned_model_manager)),
       m_prepared_model(std::move(p_prepared_model)),
-      m_local_search(nullptr)
+      m_local_search(nullptr), m_thread_num(1), m_random_seed(0),
+      m_has_obj_cutoff(false), m_obj_cutoff(0.0),
+      m_incumbent_sync_period(100),
+      m_shared_incumbent(nullptr), m_helper_searches(),
+      m_stop_workers(false)
 {
   if (m_owned_model_manager == nullptr && m_prepared_model == nullptr)
     throw std::invalid_argument("prepared model cannot be null");
@@ -130,14 +153,32 @@ void Local_MIP::set_param_set_file(const std::string& p_param_set_file)
       throw std::logic_error(
           "parameter file split_eq does not match Prepared_Model");
     }
+    if (params.has_loaded_param("dup_presolve") &&
+        (params.dup_presolve != 0) != manager.dup_presolve())
+    {
+      throw std::logic_error(
+          "parameter file dup_presolve does not match Prepared_Model");
+    }
   }
 
   if (m_prepared_model == nullptr && params.has_loaded_param("model_file"))
     set_model_file(params.model_file);
   if (params.has_loaded_param("sol_path"))
     set_sol_path(params.sol_path);
+  if (params.has_loaded_param("sol_interval"))
+    set_sol_interval(params.sol_interval);
+  if (params.has_loaded_param("trajectory_path"))
+    set_trajectory_path(params.trajectory_path);
+  if (params.has_loaded_param("obj_reference"))
+    set_obj_reference(params.obj_reference);
   if (params.has_loaded_param("start_sol_path"))
     set_start_sol_path(params.start_sol_path);
+  if (params.has_loaded_param("checkpoint_path"))
+    set_checkpoint_path(params.checkpoint_path);
+  if (params.has_loaded_param("resume_path"))
+    set_resume_path(params.resume_path);
+  if (params.has_loaded_param("step_limit"))
+    set_step_limit(static_cast<size_t>(params.step_limit));
   if (params.has_loaded_param("time_limit"))
     set_time_limit(params.time_limit);
   if (params.has_loaded_param("random_seed"))
@@ -179,10 +220,27 @@ void Local_MIP::set_param_set_file(const std::string& p_param_set_file)
     set_tabu_variation(static_cast<size_t>(params.tabu_var));
   if (params.has_loaded_param("activity_period"))
     set_activity_period(static_cast<size_t>(params.activity_period));
+  if (params.has_loaded_param("activity_arithmetic"))
+    set_activity_arithmetic(params.activity_arithmetic);
+  if (params.has_loaded_param("score_cache"))
+    set_score_cache(params.score_cache != 0);
+  if (params.has_loaded_param("score_threads"))
+    set_score_threads(static_cast<size_t>(params.score_threads));
   if (params.has_loaded_param("break_eq_feas"))
     set_break_eq_feas(params.break_eq_feas != 0);
+  if (params.has_loaded_param("threads"))
+    set_threads(static_cast<size_t>(params.threads));
+  if (params.has_loaded_param("obj_cutoff"))
+    set_objective_cutoff(params.obj_cutoff);
+  if (params.has_loaded_param("incumbent_sync"))
+    set_incumbent_sync_period(static_cast<size_t>(params.incumbent_sync));
   if (m_prepared_model == nullptr && params.has_loaded_param("split_eq"))
     set_split_eq(params.split_eq != 0);
+  if (m_prepared_model == nullptr &&
+      params.has_loaded_param("presolve_threads"))
+    set_presolve_threads(static_cast<size_t>(params.presolve_threads));
+  if (m_prepared_model == nullptr && params.has_loaded_param("dup_presolve"))
+    set_dup_presolve(params.dup_presolve != 0);
   if (params.has_loaded_param("start"))
     set_start_method(params.start);
   if (params.has_loaded_param("restart"))
@@ -225,6 +283,21 @@ void Local_MIP::set_split_eq(bool p_enable)
          p_enable ? "true" : "false");
 }
 
+void Local_MIP::set_presolve_threads(size_t p_thread_num)
+{
+  auto config_lock = lock_configuration();
+  mutable_model_manager().set_presolve_workers(p_thread_num);
+  printf("c presolve threads is set to : %zu\n", p_thread_num);
+}
+
+void Local_MIP::set_dup_presolve(bool p_enable)
+{
+  auto config_lock = lock_configuration();
+  mutable_model_manager().set_dup_presolve(p_enable);
+  printf("c duplicate presolve is set to : %s\n",
+         p_enable ? "true" : "false");
+}
+
 void Local_MIP::set_log_obj(bool p_enable)
 {
   auto config_lock = lock_configuration();
@@ -239,6 +312,33 @@ void Local_MIP::set_sol_path(const std::string& p_sol_path)
   printf("c sol path is set to : %s\n", p_sol_path.c_str());
 }
 
+void Local_MIP::set_sol_interval(double p_seconds)
+{
+  auto config_lock = lock_configuration();
+  if (!std::isfinite(p_seconds) || p_seconds < 0.0 ||
+      p_seconds > k_max_time_limit)
+  {
+    throw std::invalid_argument(
+        "sol interval must be finite and in [0, 1e8]");
+  }
+  m_sol_interval = p_seconds;
+  printf("c sol interval is set to : %.2lf seconds\n", m_sol_interval);
+}
+
+void Local_MIP::set_obj_reference(double p_obj)
+{
+  auto config_lock = lock_configuration();
+  m_obj_reference = p_obj;
+  printf("c reference objective is set to : %.17g\n", p_obj);
+}
+
+void Local_MIP::set_trajectory_path(const std::string& p_trajectory_path)
+{
+  auto config_lock = lock_configuration();
+  m_trajectory_path = p_trajectory_path;
+  printf("c trajectory path is set to : %s\n", p_trajectory_path.c_str());
+}
+
 void Local_MIP::set_start_sol_path(const std::string& p_start_sol_path)
 {
   auto config_lock = lock_configuration();
@@ -247,10 +347,49 @@ void Local_MIP::set_start_sol_path(const std::string& p_start_sol_path)
          m_start_sol_path.c_str());
 }
 
+void Local_MIP::set_checkpoint_path(const std::string& p_checkpoint_path)
+{
+  auto config_lock = lock_configuration();
+  m_checkpoint_path = p_checkpoint_path;
+  printf("c checkpoint path is set to : %s\n", p_checkpoint_path.c_str());
+}
+
+void Local_MIP::set_resume_path(const std::string& p_resume_path)
+{
+  auto config_lock = lock_configuration();
+  m_local_search->set_resume_path(p_resume_path);
+  printf("c resume path is set to : %s\n", p_resume_path.c_str());
+}
+
+void Local_MIP::set_step_limit(size_t p_step_limit)
+{
+  auto config_lock = lock_configuration();
+  m_local_search->set_step_limit(p_step_limit);
+  printf("c step limit is set to : %zu\n", p_step_limit);
+}
+
+bool Local_MIP::checkpoint(const std::string& p_path)
+{
+  std::lock_guard<std::recursive_mutex> lock(m_lifecycle_mutex);
+  if (!m_search_finished.load(std::memory_order_acquire))
+  {
+    throw std::logic_error(
+        "checkpoint() requires a search that has finished");
+  }
+  if (!m_local_search->save_checkpoint(p_path))
+  {
+    printf("o cannot write checkpoint file %s.\n", p_path.c_str());
+    return false;
+  }
+  printf("c search state is checkpointed to %s\n", p_path.c_str());
+  return true;
+}
+
 void Local_MIP::set_random_seed(uint32_t p_seed)
 {
   auto config_lock = lock_configuration();
   m_local_search->set_random_seed(p_seed);
+  m_random_seed = p_seed;
   printf("c random seed is set to : %u%s\n",
          p_seed,
          p_seed == 0 ? " (use default internal seed)" : "");
@@ -332,6 +471,25 @@ void Local_MIP::set_restart_cbk(Local_Search::Restart_Cbk p_restart_cbk,
   printf("c custom restart callback is registered.\n");
 }
 
+void Local_MIP::set_improvement_cbk(Improvement_Cbk p_cbk, void* p_user_data)
+{
+  auto config_lock = lock_configuration();
+  m_improvement_cbk = std::move(p_cbk);
+  m_improvement_user_data = p_user_data;
+  printf("c improvement callback is registered.\n");
+}
+
+std::shared_ptr<Incumbent_Snapshot> Local_MIP::enable_incumbent_snapshot()
+{
+  auto config_lock = lock_configuration();
+  if (m_incumbent_snapshot == nullptr)
+  {
+    m_incumbent_snapshot = std::make_shared<Incumbent_Snapshot>();
+    printf("c incumbent snapshot is enabled.\n");
+  }
+  return m_incumbent_snapshot;
+}
+
 void Local_MIP::set_weight_method(const std::string& p_weight_name)
 {
   auto config_lock = lock_configuration();
@@ -488,6 +646,28 @@ void Local_MIP::set_activity_period(size_t p_value)
   printf("c constraint activity period : %zu\n", p_value);
 }
 
+void Local_MIP::set_activity_arithmetic(const std::string& p_name)
+{
+  auto config_lock = lock_configuration();
+  m_local_search->set_activity_arithmetic(p_name);
+  printf("c activity arithmetic is set to : %s\n", p_name.c_str());
+}
+
+void Local_MIP::set_score_cache(bool p_enable)
+{
+  auto config_lock = lock_configuration();
+  m_local_search->set_score_cache(p_enable);
+  printf("c incremental neighbor score cache is set to : %s\n",
+         p_enable ? "true" : "false");
+}
+
+void Local_MIP::set_score_threads(size_t p_thread_num)
+{
+  auto config_lock = lock_configuration();
+  m_local_search->set_score_threads(p_thread_num);
+  printf("c neighbor scoring threads is set to : %zu\n", p_thread_num);
+}
+
 void Local_MIP::set_tabu_variation(size_t p_value)
 {
   auto config_lock = lock_configuration();
@@ -505,6 +685,45 @@ void Local_MIP::set_break_eq_feas(bool p_enable)
          p_enable ? "true" : "false");
 }
 
+void Local_MIP::set_threads(size_t p_thread_num)
+{
+  auto config_lock = lock_configuration();
+  if (p_thread_num == 0)
+    throw std::invalid_argument("thread count must be at least 1");
+  m_thread_num = p_thread_num;
+  printf("c portfolio threads : %zu\n", p_thread_num);
+}
+
+void Local_MIP::set_objective_cutoff(double p_obj_cutoff)
+{
+  auto config_lock = lock_configuration();
+  if (!std::isfinite(p_obj_cutoff))
+    throw std::invalid_argument("objective cutoff must be finite");
+  m_has_obj_cutoff = true;
+  m_obj_cutoff = p_obj_cutoff;
+  printf("c objective cutoff is set to : %.17g\n", p_obj_cutoff);
+}
+
+void Local_MIP::set_shared_incumbent(
+    std::shared_ptr<Shared_Incumbent> p_incumbent)
+{
+  auto config_lock = lock_configuration();
+  if (p_incumbent == nullptr)
+    throw std::invalid_argument("shared incumbent cannot be null");
+  m_shared_incumbent = std::move(p_incumbent);
+  printf("c shared incumbent is attached\n");
+}
+
+void Local_MIP::set_incumbent_sync_period(size_t p_value)
+{
+  auto config_lock = lock_configuration();
+  if (p_value == 0)
+    throw std::invalid_argument("incumbent sync period must be at least 1");
+  m_incumbent_sync_period = p_value;
+  m_local_search->set_incumbent_sync_period(p_value);
+  printf("c shared incumbent sync period : %zu\n", p_value);
+}
+
 void Local_MIP::run()
 {
   {
@@ -554,6 +773,8 @@ void Local_MIP::run_impl()
                                               &start_solution_mask);
     if (!result.m_success)
       throw Solver_Error(result.m_message);
+    get_model_manager()->presolve_values(start_solution,
+                                         &start_solution_mask);
     printf("c start solution is loaded from : %s\n",
            m_start_sol_path.c_str());
     printf("c start solution values : %zu loaded, %zu unknown skipped, "
@@ -569,16 +790,30 @@ void Local_MIP::run_impl()
   }
   auto stop_background_tasks = [this]()
   {
+    m_sol_writer.stop();
     stop_obj_logger();
     request_timeout_stop();
     if (m_timeout_thread.joinable())
       m_timeout_thread.join();
   };
+  prepare_portfolio();
+  install_improvement_cbk();
+  m_trajectory.reset(get_model_manager()->is_min(), m_obj_reference);
   try
   {
     m_timeout_thread = std::thread(&Local_MIP::timeout_handler, this);
     start_obj_logger();
-    m_local_search->run_search(start_solution, start_solution_mask);
+    if (m_sol_snapshot != nullptr)
+    {
+      m_sol_writer.start(*get_model_manager(),
+                         m_sol_snapshot,
+                         m_local_search->get_sol_path(),
+                         m_sol_interval);
+    }
+    if (m_shared_incumbent != nullptr)
+      run_portfolio(start_solution, start_solution_mask);
+    else
+      m_local_search->run_search(start_solution, start_solution_mask);
   }
   catch (...)
   {
@@ -586,16 +821,173 @@ void Local_MIP::run_impl()
     throw;
   }
   stop_background_tasks();
+  m_search_seconds = elapsed_seconds();
+  m_search_finished.store(true, std::memory_order_release);
+  if (!m_checkpoint_path.empty())
+    checkpoint(m_checkpoint_path);
+  if (m_sol_snapshot != nullptr)
+  {
+    printf("c [%10.2lf] incremental solution writes : %zu\n",
+           elapsed_seconds(),
+           m_sol_writer.write_num());
+  }
   if (m_user_termination_requested.load(std::memory_order_relaxed))
   {
     printf("c [%10.2lf] local search is terminated by user.\n",
            elapsed_seconds());
   }
-  if (m_local_search->finalize_result())
+  if (m_has_obj_cutoff && m_shared_incumbent != nullptr &&
+      m_shared_incumbent->best_obj() <= m_shared_incumbent->cutoff())
+  {
+    printf("c [%10.2lf] objective cutoff %.17g is reached.\n",
+           elapsed_seconds(),
+           m_obj_cutoff);
+  }
+  const bool verified = m_local_search->finalize_result();
+  m_solution = m_local_search->get_solution();
+  get_model_manager()->postsolve_values(m_solution);
+  if (verified)
     m_local_search->output_result();
   else
     printf("o solution verify failed.\n");
+  finish_trajectory();
   printf("c [%10.2lf] local search is finished.\n", elapsed_seconds());
+  if constexpr (k_telemetry_enabled)
+    get_telemetry().print();
+}
+
+// Workers report their own improvements; only those that beat every
+// earlier report reach the callback and the snapshots.
+void Local_MIP::install_improvement_cbk()
+{
+  m_sol_snapshot = nullptr;
+  if (m_sol_interval > 0.0 && !m_local_search->get_sol_path().empty())
+    m_sol_snapshot = std::make_shared<Incumbent_Snapshot>();
+  if (!m_improvement_cbk && m_incumbent_snapshot == nullptr &&
+      m_sol_snapshot == nullptr)
+    return;
+  const int is_min = get_model_manager()->is_min();
+  m_notified_obj = k_inf;
+  auto forward = [this, is_min](const Improvement_Ctx& p_ctx, void*)
+  {
+    std::lock_guard<std::mutex> lock(m_improvement_mutex);
+    if (is_min * p_ctx.m_obj >= m_notified_obj)
+      return;
+    m_notified_obj = is_min * p_ctx.m_obj;
+    if (m_incumbent_snapshot != nullptr)
+      m_incumbent_snapshot->publish(
+          p_ctx.m_values, p_ctx.m_obj, p_ctx.m_step);
+    if (m_sol_snapshot != nullptr)
+      m_sol_snapshot->publish(p_ctx.m_values, p_ctx.m_obj, p_ctx.m_step);
+    if (m_improvement_cbk)
+      m_improvement_cbk(p_ctx, m_improvement_user_data);
+  };
+  m_local_search->set_improvement_cbk(forward);
+  for (auto& helper : m_helper_searches)
+    helper->set_improvement_cbk(forward);
+}
+
+void Local_MIP::prepare_portfolio()
+{
+  if (m_shared_incumbent == nullptr && m_thread_num <= 1 &&
+      !m_has_obj_cutoff)
+    return;
+  const Model_Manager* manager = get_model_manager();
+  if (m_shared_incumbent == nullptr)
+    m_shared_incumbent = std::make_shared<Shared_Incumbent>();
+  if (m_has_obj_cutoff)
+  {
+    m_shared_incumbent->set_cutoff(m_obj_cutoff * manager->is_min() -
+                                   manager->obj_offset());
+  }
+  m_local_search->set_shared_incumbent(m_shared_incumbent.get());
+  m_local_search->set_group_stop(&m_stop_workers);
+
+  // Helper workers start from the default configuration and cycle through
+  // the built-in strategies; the primary worker keeps every user setting,
+  // callback and the start solution.
+  static const char* const k_start_methods[] = {
+      "random", "objective", "locks", "zero"};
+  static const char* const k_restart_methods[] = {"hybrid", "random", "best"};
+  static const char* const k_weight_methods[] = {"smooth", "monotone"};
+  static const char* const k_neighbor_methods[] = {
+      "progress_age", "progress_bonus"};
+  m_helper_searches.clear();
+  m_helper_searches.reserve(m_thread_num - 1);
+  for (size_t worker_idx = 1; worker_idx < m_thread_num; ++worker_idx)
+  {
+    const size_t mix = worker_idx - 1;
+    const char* start = k_start_methods[mix % 4];
+    const char* restart = k_restart_methods[mix % 3];
+    const char* weight = k_weight_methods[mix % 2];
+    const char* neighbor = k_neighbor_methods[(mix / 2) % 2];
+    const uint32_t seed =
+        m_random_seed + static_cast<uint32_t>(worker_idx);
+    auto helper = std::make_unique<Local_Search>(
+        manager, m_local_search->opt_tolerance());
+    helper->set_random_seed(seed);
+    helper->set_start_method(start);
+    helper->set_restart_method(restart);
+    helper->set_weight_method(weight);
+    helper->set_neighbor_scoring_method(neighbor);
+    helper->set_incumbent_sync_period(m_incumbent_sync_period);
+    helper->set_shared_incumbent(m_shared_incumbent.get());
+    helper->set_group_stop(&m_stop_workers);
+    printf("c portfolio worker %zu : start=%s restart=%s weight=%s "
+           "neighbor_scoring=%s seed=%u\n",
+           worker_idx,
+           start,
+           restart,
+           weight,
+           neighbor,
+           seed);
+    m_helper_searches.push_back(std::move(helper));
+  }
+}
+
+void Local_MIP::run_portfolio(const std::vector<double>& p_start_solution,
+                              const std::vector<char>& p_start_mask)
+{
+  std::vector<std::exception_ptr> errors(m_helper_searches.size());
+  std::vector<std::thread> workers;
+  workers.reserve(m_helper_searches.size());
+  for (size_t helper_idx = 0; helper_idx < m_helper_searches.size();
+       ++helper_idx)
+  {
+    workers.emplace_back(
+        [this, &errors, helper_idx]()
+        {
+          try
+          {
+            m_helper_searches[helper_idx]->run_search();
+          }
+          catch (...)
+          {
+            errors[helper_idx] = std::current_exception();
+            m_stop_workers.store(true, std::memory_order_relaxed);
+          }
+        });
+  }
+  std::exception_ptr primary_error;
+  try
+  {
+    m_local_search->run_search(p_start_solution, p_start_mask);
+  }
+  catch (...)
+  {
+    primary_error = std::current_exception();
+  }
+  m_stop_workers.store(true, std::memory_order_relaxed);
+  for (auto& worker : workers)
+    worker.join();
+  if (primary_error != nullptr)
+    std::rethrow_exception(primary_error);
+  for (const auto& error : errors)
+  {
+    if (error != nullptr)
+      std::rethrow_exception(error);
+  }
+  m_local_search->import_shared_incumbent();
 }
 
 std::unique_lock<std::recursive_mutex> Local_MIP::lock_configuration()
@@ -618,6 +1010,7 @@ void Local_MIP::terminate()
 void Local_MIP::request_termination() noexcept
 {
   m_user_termination_requested.store(true, std::memory_order_relaxed);
+  m_stop_workers.store(true, std::memory_order_relaxed);
   m_local_search->terminate();
 }
 
@@ -632,6 +1025,7 @@ void Local_MIP::timeout_handler()
     if (cancelled)
       return;
   }
+  m_stop_workers.store(true, std::memory_order_relaxed);
   m_local_search->terminate();
   printf("c [%10.2lf] local search is terminated by timeout.\n",
          elapsed_seconds());
@@ -646,10 +1040,10 @@ void Local_MIP::request_timeout_stop()
   m_timeout_cv.notify_all();
 }
 
+// The logger always runs so the trajectory is recorded; printing follows
+// set_log_obj.
 void Local_MIP::start_obj_logger()
 {
-  if (!m_log_obj_enabled)
-    return;
   stop_obj_logger();
   m_stop_obj_log.store(false, std::memory_order_relaxed);
   m_obj_log_thread = std::thread(&Local_MIP::obj_log_handler, this);
@@ -657,33 +1051,102 @@ void Local_MIP::start_obj_logger()
 
 void Local_MIP::stop_obj_logger()
 {
-  m_stop_obj_log.store(true, std::memory_order_relaxed);
+  m_stop_obj_log.store(true, std::memory_order_release);
   if (m_obj_log_thread.joinable())
     m_obj_log_thread.join();
 }
 
 void Local_MIP::obj_log_handler()
 {
-  double last_value = std::numeric_limits<double>::quiet_NaN();
-  bool has_value = false;
+  std::vector<Improvement_Event> batch;
+  size_t printed_num = 0;
+  auto next_print = std::chrono::steady_clock::now();
   while (true)
   {
-    double current_value = m_local_search->get_obj_value();
-    if (!std::isnan(current_value) &&
-        (!has_value || current_value != last_value))
+    const bool stop = m_stop_obj_log.load(std::memory_order_acquire);
+    drain_improvements(batch);
+    const auto& points = m_trajectory.points();
+    const auto now = std::chrono::steady_clock::now();
+    if (m_log_obj_enabled && points.size() > printed_num &&
+        (stop || now >= next_print))
     {
-      last_value = current_value;
-      has_value = true;
       printf("c [%10.2lf] obj*: %-22.17g\n",
-             elapsed_seconds(),
-             current_value);
+             points.back().m_seconds,
+             points.back().m_obj);
+      printed_num = points.size();
+      next_print = now + k_obj_log_period;
     }
-    if (m_stop_obj_log.load(std::memory_order_relaxed))
+    if (stop)
       break;
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::this_thread::sleep_for(k_improvement_drain_period);
+  }
+}
+
+// Events of all workers are merged in time order; only those improving on
+// the best objective so far enter the trajectory.
+void Local_MIP::drain_improvements(std::vector<Improvement_Event>& p_batch)
+{
+  p_batch.clear();
+  Improvement_Event event;
+  while (m_local_search->pop_improvement(event))
+    p_batch.push_back(event);
+  for (const auto& helper : m_helper_searches)
+    while (helper->pop_improvement(event))
+      p_batch.push_back(event);
+  std::sort(p_batch.begin(),
+            p_batch.end(),
+            [](const Improvement_Event& p_lhs, const Improvement_Event& p_rhs)
+            { return p_lhs.m_time < p_rhs.m_time; });
+  for (const auto& improvement : p_batch)
+  {
+    const size_t reached_num = m_trajectory.reached_target_num();
+    const double seconds = std::max(
+        0.0,
+        std::chrono::duration<double>(improvement.m_time - m_run_start)
+            .count());
+    if (!m_trajectory.record(seconds, improvement.m_step, improvement.m_obj) ||
+        !m_log_obj_enabled)
+      continue;
+    for (size_t target_idx = reached_num;
+         target_idx < m_trajectory.reached_target_num();
+         ++target_idx)
+      printf("c [%10.2lf] within %g%% of the reference objective\n",
+             seconds,
+             100.0 * m_trajectory.target_gaps()[target_idx]);
   }
 }
 
+void Local_MIP::finish_trajectory()
+{
+  if (m_local_search->is_feasible())
+    m_trajectory.record(
+        m_search_seconds, get_step_num(), m_local_search->get_obj_value());
+  m_trajectory.finish(m_search_seconds);
+  size_t dropped_events = m_local_search->dropped_improvements();
+  for (const auto& helper : m_helper_searches)
+    dropped_events += helper->dropped_improvements();
+  m_trajectory.set_dropped_events(dropped_events);
+  if (m_log_obj_enabled && !m_trajectory.points().empty())
+    printf("c primal integral: %.6g (reference objective %.17g)\n",
+           m_trajectory.primal_integral(),
+           m_trajectory.reference());
+  if (!m_trajectory_path.empty())
+    write_trajectory();
+}
+
+void Local_MIP::write_trajectory() const
+{
+  FILE* trajectory_file = fopen(m_trajectory_path.c_str(), "w");
+  if (trajectory_file == nullptr)
+  {
+    printf("o cannot open trajectory file %s.\n", m_trajectory_path.c_str());
+    return;
+  }
+  m_trajectory.write_json(trajectory_file);
+  fclose(trajectory_file);
+  printf("c trajectory is written to %s\n", m_trajectory_path.c_str());
+}
+
 double Local_MIP::elapsed_seconds() const
 {
   return std::chrono::duration_cast<std::chrono::duration<double>>(
@@ -703,7 +1166,30 @@ bool Local_MIP::is_feasible() const
 
 const std::vector<double>& Local_MIP::get_solution() const
 {
-  return m_local_search->get_solution();
+  return m_solution;
+}
+
+size_t Local_MIP::get_step_num() const
+{
+  size_t step_num = m_local_search->get_step_num();
+  for (const auto& helper : m_helper_searches)
+    step_num += helper->get_step_num();
+  return step_num;
+}
+
+Search_Telemetry Local_MIP::get_telemetry() const
+{
+  Search_Telemetry telemetry = m_local_search->get_telemetry();
+  for (const auto& helper : m_helper_searches)
+    telemetry.merge(helper->get_telemetry());
+  if constexpr (k_telemetry_enabled)
+    telemetry.search_seconds = m_search_seconds;
+  return telemetry;
+}
+
+const Primal_Trajectory& Local_MIP::get_trajectory() const
+{
+  return m_trajectory;
 }
 
 const Model_Manager* Local_MIP::get_model_manager() const
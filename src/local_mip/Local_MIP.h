@@ -13,6 +13,8 @@
 
 #pragma once
 #include "../local_search/Local_Search.h"
+#include "Async_Sol_Writer.h"
+#include "../local_search/incumbent/shared_incumbent.h"
 #include "../model_data/Model_Manager.h"
 #include "../model_data/Prepared_Model.h"
 #include "utils/global_defs.h"
@@ -40,6 +42,8 @@ private:
 
   std::chrono::steady_clock::time_point m_run_start;
 
+  double m_search_seconds;
+
   std::recursive_mutex m_lifecycle_mutex;
 
   bool m_run_started;
@@ -60,12 +64,62 @@ private:
 
   bool m_log_obj_enabled;
 
+  // Written by the objective logger while the search runs.
+  Primal_Trajectory m_trajectory;
+
+  double m_obj_reference;
+
+  std::string m_trajectory_path;
+
+  std::string m_checkpoint_path;
+
+  std::atomic<bool> m_search_finished;
+
+  Improvement_Cbk m_improvement_cbk;
+
+  void* m_improvement_user_data;
+
+  std::shared_ptr<Incumbent_Snapshot> m_incumbent_snapshot;
+
+  // Serializes improvements reported by portfolio workers; m_notified_obj
+  // is the best one forwarded so far, in the minimization direction.
+  std::mutex m_improvement_mutex;
+
+  double m_notified_obj;
+
+  double m_sol_interval;
+
+  // Own snapshot of the writer, separate from the user-facing one so the
+  // two readers never consume each other's incumbents.
+  std::shared_ptr<Incumbent_Snapshot> m_sol_snapshot;
+
+  Async_Sol_Writer m_sol_writer;
+
   std::unique_ptr<Model_Manager> m_owned_model_manager;
 
   std::shared_ptr<const Prepared_Model> m_prepared_model;
 
   std::unique_ptr<Local_Search> m_local_search;
 
+  // Best solution in the original columns, filled when run() finishes.
+  std::vector<double> m_solution;
+
+  size_t m_thread_num;
+
+  uint32_t m_random_seed;
+
+  bool m_has_obj_cutoff;
+
+  double m_obj_cutoff;
+
+  size_t m_incumbent_sync_period;
+
+  std::shared_ptr<Shared_Incumbent> m_shared_incumbent;
+
+  std::vector<std::unique_ptr<Local_Search>> m_helper_searches;
+
+  std::atomic<bool> m_stop_workers;
+
   Local_MIP(std::unique_ptr<Model_Manager> p_owned_model_manager,
             std::shared_ptr<const Prepared_Model> p_prepared_model);
 
@@ -79,6 +133,14 @@ private:
 
   void obj_log_handler();
 
+  void drain_improvements(std::vector<Improvement_Event>& p_batch);
+
+  void finish_trajectory();
+
+  void write_trajectory() const;
+
+  void install_improvement_cbk();
+
   double elapsed_seconds() const;
 
   Model_Manager& mutable_model_manager();
@@ -87,6 +149,11 @@ private:
 
   void run_impl();
 
+  void prepare_portfolio();
+
+  void run_portfolio(const std::vector<double>& p_start_solution,
+                     const std::vector<char>& p_start_mask);
+
 public:
   Local_MIP();
 
@@ -105,12 +172,48 @@ public:
 
   void set_split_eq(bool p_enable);
 
+  // Threads for the row and column passes of presolve; 0 uses all
+  // hardware threads. The prepared model does not depend on it.
+  void set_presolve_threads(size_t p_thread_num);
+
+  void set_dup_presolve(bool p_enable);
+
   void set_log_obj(bool p_enable);
 
   void set_sol_path(const std::string& p_sol_path);
 
+  // While the search runs, the best solution is also written to the sol
+  // path at most once per p_seconds, replacing the file atomically. 0
+  // writes it only at the end.
+  void set_sol_interval(double p_seconds);
+
+  // Reference objective of the primal integral and time-to-target metrics,
+  // in the original direction. 1e20 (the default) uses the best objective
+  // of the run.
+  void set_obj_reference(double p_obj);
+
+  // Writes the incumbent trajectory and its metrics as JSON after the run.
+  void set_trajectory_path(const std::string& p_trajectory_path);
+
   void set_start_sol_path(const std::string& p_start_sol_path);
 
+  // Saves the search state to p_checkpoint_path when the run ends, also
+  // when it is ended by the time limit or terminate().
+  void set_checkpoint_path(const std::string& p_checkpoint_path);
+
+  // Continues the search from a checkpoint instead of a start solution.
+  // With the same model and parameters, a run resumed from a checkpoint
+  // taken at step n makes the same moves as an uninterrupted run from
+  // step n on. With threads > 1 only the primary worker is restored.
+  void set_resume_path(const std::string& p_resume_path);
+
+  // Total search steps over all resumed slices; 0 means no limit.
+  void set_step_limit(size_t p_step_limit);
+
+  // Writes the search state of the finished run to p_path; returns false
+  // when the file cannot be written.
+  bool checkpoint(const std::string& p_path);
+
   void set_random_seed(uint32_t p_seed);
 
   void set_feas_tolerance(double p_value);
@@ -148,6 +251,16 @@ public:
   void set_neighbor_scoring_cbk(Local_Search::Neighbor_Scoring_Cbk p_cbk,
                                 void* p_user_data = nullptr);
 
+  // Called from the search thread with every solution that improves on the
+  // best one so far, portfolio workers included; calls never overlap. The
+  // values are not copied, so the callback should return quickly.
+  void set_improvement_cbk(Improvement_Cbk p_cbk,
+                           void* p_user_data = nullptr);
+
+  // Creates (once) the buffered incumbent that every improvement is copied
+  // into; a consumer thread polls it with acquire() while run() executes.
+  std::shared_ptr<Incumbent_Snapshot> enable_incumbent_snapshot();
+
   void terminate();
 
   void request_termination() noexcept;
@@ -182,10 +295,30 @@ public:
 
   void set_activity_period(size_t p_value);
 
+  // Arithmetic of the activities when the model fails the exact-double
+  // certificate: "long_double" (default) or "compensated", a double with a
+  // compensation term whose error bound triggers row recomputations.
+  void set_activity_arithmetic(const std::string& p_name);
+
+  void set_score_cache(bool p_enable);
+
+  // Threads of the primary worker that score the candidate moves of one
+  // neighborhood together; 0 uses all hardware threads. The search makes
+  // the same moves for every thread count.
+  void set_score_threads(size_t p_thread_num);
+
   void set_tabu_variation(size_t p_value);
 
   void set_break_eq_feas(bool p_enable);
 
+  void set_threads(size_t p_thread_num);
+
+  void set_objective_cutoff(double p_obj_cutoff);
+
+  void set_shared_incumbent(std::shared_ptr<Shared_Incumbent> p_incumbent);
+
+  void set_incumbent_sync_period(size_t p_value);
+
   void run();
 
   double get_obj_value() const;
@@ -194,5 +327,16 @@ public:
 
   const std::vector<double>& get_solution() const;
 
+  // Search steps of the last run, summed over portfolio workers.
+  size_t get_step_num() const;
+
+  // Hot-path counters of the last run, merged over portfolio workers. They
+  // stay zero unless the library is built with LOCAL_MIP_TELEMETRY.
+  Search_Telemetry get_telemetry() const;
+
+  // Every improvement of the last run with its time and step, merged over
+  // portfolio workers.
+  const Primal_Trajectory& get_trajectory() const;
+
   const Model_Manager* get_model_manager() const;
 };
@@ -13,7 +13,9 @@
 
 #include "../model_data/Model_Con.h"
 #include "../model_data/Model_Var.h"
+#include "../reader/Sol_Writer.h"
 #include "../utils/global_defs.h"
+#include "../utils/parallel_tasks.h"
 #include "../utils/solver_error.h"
 #include "Local_Search.h"
 #include "neighbor/neighbor.h"
@@ -29,6 +31,7 @@
 #include <random>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -37,6 +40,9 @@ namespace
 
 constexpr uint64_t k_max_exact_binary64_integer = uint64_t{1} << 53;
 
+// Improvements a search may push before the logger drains them.
+constexpr size_t k_improvement_ring_capacity = size_t{1} << 14;
+
 bool exact_binary64_integer(double p_value, int64_t& p_integer)
 {
   const double limit = static_cast<double>(k_max_exact_binary64_integer);
@@ -63,22 +69,99 @@ bool exact_bound_product(uint64_t p_lhs,
   return true;
 }
 
+// Largest integer a within the exact range with fl(a - p_constant) <=
+// p_bound, or an infinity when all or none qualify. The rounded difference
+// is monotone in a, so a bisection finds it.
+double largest_integer_within(double p_constant, double p_bound)
+{
+  const int64_t limit = static_cast<int64_t>(k_max_exact_binary64_integer);
+  auto qualifies = [&](int64_t p_value)
+  { return static_cast<double>(p_value) - p_constant <= p_bound; };
+  if (qualifies(limit))
+    return std::numeric_limits<double>::infinity();
+  if (!qualifies(-limit))
+    return -std::numeric_limits<double>::infinity();
+  int64_t low = -limit;
+  int64_t high = limit;
+  while (high - low > 1)
+  {
+    const int64_t mid = low + (high - low) / 2;
+    if (qualifies(mid))
+      low = mid;
+    else
+      high = mid;
+  }
+  return static_cast<double>(low);
+}
+
+// Smallest integer a within the exact range with fl(a - p_constant) >=
+// p_bound, or an infinity when all or none qualify.
+double smallest_integer_within(double p_constant, double p_bound)
+{
+  const int64_t limit = static_cast<int64_t>(k_max_exact_binary64_integer);
+  auto qualifies = [&](int64_t p_value)
+  { return static_cast<double>(p_value) - p_constant >= p_bound; };
+  if (qualifies(-limit))
+    return -std::numeric_limits<double>::infinity();
+  if (!qualifies(limit))
+    return std::numeric_limits<double>::infinity();
+  int64_t low = -limit;
+  int64_t high = limit;
+  while (high - low > 1)
+  {
+    const int64_t mid = low + (high - low) / 2;
+    if (qualifies(mid))
+      high = mid;
+    else
+      low = mid;
+  }
+  return static_cast<double>(high);
+}
+
 } // namespace
 
 int Local_Search::run_search(const std::vector<double>& p_start_solution,
                              const std::vector<char>& p_start_mask)
 {
   init_data();
+  m_telemetry = Search_Telemetry();
   if (solve_objective_only())
     return 0;
-  m_start.set_up_start_values(m_start_ctx, p_start_solution, p_start_mask);
-  normalize_domain_values(m_var_current_value, "initial solution");
-  init_state();
+  if (!m_resume_path.empty())
+    load_checkpoint();
+  else
+  {
+    m_start.set_up_start_values(
+        m_start_ctx, p_start_solution, p_start_mask);
+    normalize_domain_values(m_var_current_value, "initial solution");
+    init_state();
+  }
 
   while (!m_terminated.load(std::memory_order_relaxed))
   {
+    if (m_cur_step >= m_step_limit)
+      break;
+    if (m_group_stop != nullptr &&
+        m_group_stop->load(std::memory_order_relaxed))
+      break;
+    if (m_shared_incumbent != nullptr)
+    {
+      if (m_shared_incumbent->stop_requested())
+        break;
+      if (m_cur_step >= m_next_incumbent_sync_step)
+        tighten_to_shared_incumbent();
+      if (m_restart.should_restart(m_restart_ctx))
+        import_shared_incumbent();
+    }
+    sync_con_sat_idxs();
+    const uint64_t restart_start = k_telemetry_enabled ? read_cycles() : 0;
     if (m_restart.execute(m_restart_ctx))
     {
+      if constexpr (k_telemetry_enabled)
+      {
+        ++m_telemetry.restart.calls;
+        m_telemetry.restart.cycles += read_cycles() - restart_start;
+      }
       if (m_restart.has_user_callback())
         normalize_domain_values(m_var_current_value, "restart solution");
       reset_after_restart();
@@ -99,13 +182,26 @@ int Local_Search::run_search(const std::vector<double>& p_start_solution,
         update_best_solution();
         m_is_found_feasible = true;
         if (!m_has_objective)
+        {
+          if (m_shared_incumbent != nullptr)
+            m_shared_incumbent->request_stop();
           return 0;
+        }
+      }
+      sync_con_sat_idxs();
+      bool lift_move_successful = false;
+      {
+        Phase_Timer lift_timer(m_telemetry.lift_move);
+        lift_move_successful = lift_move();
       }
-      bool lift_move_successful = lift_move();
       ++m_cur_step;
       if (lift_move_successful)
+      {
+        telemetry_add(m_telemetry.lift_moves);
         continue;
+      }
     }
+    sync_con_sat_idxs();
     const bool validate_selected_move =
         explore_neighbor(m_explore_neighbor_list);
     if (validate_selected_move)
@@ -119,6 +215,14 @@ int Local_Search::run_search(const std::vector<double>& p_start_solution,
   return 0;
 }
 
+Search_Telemetry Local_Search::get_telemetry() const
+{
+  Search_Telemetry telemetry = m_telemetry;
+  if constexpr (k_telemetry_enabled)
+    telemetry.steps = m_cur_step;
+  return telemetry;
+}
+
 bool Local_Search::finalize_result()
 {
   if (m_is_unbounded || !m_is_found_feasible || verify_solution())
@@ -151,13 +255,12 @@ void Local_Search::output_result() const
 }
 
 template <typename Accumulator>
-Accumulator
-Local_Search::compute_activity(const Model_Con& p_con,
-                               const double* p_var_values) const
+Accumulator Local_Search::compute_activity(size_t p_con_idx,
+                                           const double* p_var_values) const
 {
   Accumulator activity = static_cast<Accumulator>(0.0);
-  const auto& coeffs = p_con.coeff_set();
-  const auto& var_idxs = p_con.var_idx_set();
+  const auto coeffs = m_matrix->row_coeffs(p_con_idx);
+  const auto var_idxs = m_matrix->row_var_idxs(p_con_idx);
   for (size_t term_idx = 0; term_idx < coeffs.size(); ++term_idx)
   {
     activity += static_cast<Accumulator>(coeffs[term_idx]) *
@@ -170,39 +273,71 @@ template <typename Accumulator>
 void Local_Search::refresh_activities_impl()
 {
   m_con_unsat_idxs.clear();
-  m_con_sat_idxs.clear();
   std::fill(m_con_pos_in_unsat_idxs.begin(),
             m_con_pos_in_unsat_idxs.end(),
-            SIZE_MAX);
-  std::fill(m_con_pos_in_sat_idxs.begin(),
-            m_con_pos_in_sat_idxs.end(),
-            SIZE_MAX);
-  const auto& model_obj = m_model_manager->obj();
+            k_null_idx);
+  std::fill(m_con_is_sat.begin(), m_con_is_sat.end(), false);
+  m_con_sat_idxs_stale = true;
   const double* var_values = m_var_current_value.data();
-  Accumulator activity =
-      compute_activity<Accumulator>(model_obj, var_values);
-  m_current_obj_breakthrough =
-      activity <= static_cast<Accumulator>(m_con_constant[0]);
-  m_con_activity[0] = static_cast<double>(activity);
-  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+  if constexpr (std::is_same_v<Accumulator, double>)
   {
-    const auto& model_con = m_model_manager->con(con_idx);
-    activity = compute_activity<Accumulator>(model_con, var_values);
-    const bool is_sat = con_sat(con_idx, activity);
-    m_con_activity[con_idx] = static_cast<double>(activity);
-    if (is_sat)
-      insert_sat(con_idx);
-    else
-      insert_unsat(con_idx);
+    // Exact sums do not depend on the term order, so the vector kernel and
+    // the row split give the activities of the scalar loop.
+    assert(m_matrix->row_num() == m_con_num);
+    m_row_activity.compute_all(
+        *m_matrix, var_values, m_con_activity.data(), m_worker_pool.get());
+    m_current_obj_breakthrough = m_con_activity[0] <= m_con_constant[0];
+    for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+    {
+      if (m_con_sat_interval[con_idx].contains(m_con_activity[con_idx]))
+        m_con_is_sat[con_idx] = true;
+      else
+        insert_unsat(con_idx);
+    }
+  }
+  else if constexpr (std::is_same_v<Accumulator, Compensated_Double>)
+  {
+    for (size_t con_idx = 0; con_idx < m_con_num; ++con_idx)
+      recompute_compensated_activity(con_idx);
+    m_current_obj_breakthrough = m_con_activity[0] <= m_con_constant[0];
+    for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+    {
+      if (con_sat(con_idx, m_con_activity[con_idx]))
+        m_con_is_sat[con_idx] = true;
+      else
+        insert_unsat(con_idx);
+    }
+  }
+  else
+  {
+    Accumulator activity = compute_activity<Accumulator>(0, var_values);
+    m_current_obj_breakthrough =
+        activity <= static_cast<Accumulator>(m_con_constant[0]);
+    m_con_activity[0] = static_cast<double>(activity);
+    for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+    {
+      activity = compute_activity<Accumulator>(con_idx, var_values);
+      const bool is_sat = con_sat(con_idx, activity);
+      m_con_activity[con_idx] = static_cast<double>(activity);
+      if (is_sat)
+        m_con_is_sat[con_idx] = true;
+      else
+        insert_unsat(con_idx);
+    }
   }
   m_activity_hits = 0;
   m_activity_dirty = false;
+  if (m_use_score_cache)
+    m_score_cache.invalidate_all();
 }
 
 void Local_Search::refresh_activities()
 {
+  Phase_Timer refresh_timer(m_telemetry.refresh_activities);
   if (m_use_exact_double_activity)
     refresh_activities_impl<double>();
+  else if (m_use_compensated_activity)
+    refresh_activities_impl<Compensated_Double>();
   else
     refresh_activities_impl<long double>();
 }
@@ -224,48 +359,87 @@ void Local_Search::reset_after_restart()
 }
 
 template <typename Accumulator>
-void Local_Search::update_affected_activities(const Model_Var& p_model_var,
+void Local_Search::update_affected_activities(size_t p_var_idx,
                                               double p_delta)
 {
-  for (size_t term_idx = 0; term_idx < p_model_var.term_num(); ++term_idx)
+  for (const auto& term : m_matrix->col(p_var_idx))
   {
-    const size_t con_idx = p_model_var.con_idx(term_idx);
-    const auto& model_con = m_model_manager->con(con_idx);
-    const size_t pos_in_con = p_model_var.pos_in_con(term_idx);
-    const double coeff = model_con.coeff(pos_in_con);
+    const size_t con_idx = term.con_idx;
+    const double coeff = term.coeff;
     const bool maintain_status = (con_idx != 0);
+    const double old_activity = m_con_activity[con_idx];
     bool was_sat = false;
     if (maintain_status)
     {
-      was_sat = m_con_pos_in_sat_idxs[con_idx] != SIZE_MAX;
-      assert(was_sat != (m_con_pos_in_unsat_idxs[con_idx] != SIZE_MAX));
-    }
-    const Accumulator updated_activity =
-        static_cast<Accumulator>(m_con_activity[con_idx]) +
-        static_cast<Accumulator>(coeff) *
-            static_cast<Accumulator>(p_delta);
-    const bool now_sat =
-        maintain_status ? con_sat(con_idx, updated_activity) : false;
-    if (con_idx == 0)
-    {
-      m_current_obj_breakthrough =
-          updated_activity <= static_cast<Accumulator>(m_con_constant[0]);
+      was_sat = m_con_is_sat[con_idx];
+      assert(was_sat != (m_con_pos_in_unsat_idxs[con_idx] != k_null_idx));
     }
-    m_con_activity[con_idx] = static_cast<double>(updated_activity);
-    if (maintain_status)
+    if constexpr (std::is_same_v<Accumulator, Compensated_Double>)
     {
-      if (was_sat && !now_sat)
+      // The value change and the product round once each, 3u leaves room
+      // for the second-order terms; the compensated addition reports the
+      // rest of the error.
+      const double term_value = coeff * p_delta;
+      Activity_Tail& tail = m_con_activity_tail[con_idx];
+      tail.m_err +=
+          3.0 * k_unit_roundoff * std::fabs(term_value) +
+          compensated_add(m_con_activity[con_idx], tail.m_comp, term_value);
+      const double tolerance =
+          maintain_status ? m_model_manager->feas_tolerance() : 0.0;
+      if (activity_is_uncertain(con_idx, tolerance))
       {
-        delete_sat(con_idx);
-        insert_unsat(con_idx);
+        recompute_compensated_activity(con_idx);
+        ++m_uncertain_row_refreshes;
       }
-      else if (!was_sat && now_sat)
+      if (con_idx == 0)
+        m_current_obj_breakthrough =
+            m_con_activity[0] <= m_con_constant[0];
+      else
+        update_con_status(
+            con_idx, was_sat, con_sat(con_idx, m_con_activity[con_idx]));
+    }
+    else
+    {
+      const Accumulator updated_activity =
+          static_cast<Accumulator>(m_con_activity[con_idx]) +
+          static_cast<Accumulator>(coeff) *
+              static_cast<Accumulator>(p_delta);
+      bool now_sat = false;
+      if constexpr (std::is_same_v<Accumulator, double>)
+        now_sat = maintain_status &&
+                  m_con_sat_interval[con_idx].contains(updated_activity);
+      else
+        now_sat = maintain_status && con_sat(con_idx, updated_activity);
+      if (con_idx == 0)
       {
-        insert_sat(con_idx);
-        delete_unsat(con_idx);
+        m_current_obj_breakthrough =
+            updated_activity <= static_cast<Accumulator>(m_con_constant[0]);
       }
+      m_con_activity[con_idx] = static_cast<double>(updated_activity);
+      if (maintain_status)
+        update_con_status(con_idx, was_sat, now_sat);
     }
+    if (maintain_status && m_use_score_cache)
+      m_scoring.patch_score_cache(
+          m_scoring_ctx, con_idx, old_activity, m_con_weight[con_idx]);
+  }
+}
+
+void Local_Search::recompute_compensated_activity(size_t p_con_idx)
+{
+  const auto coeffs = m_matrix->row_coeffs(p_con_idx);
+  const auto var_idxs = m_matrix->row_var_idxs(p_con_idx);
+  double activity = 0.0;
+  double activity_comp = 0.0;
+  for (size_t term_idx = 0; term_idx < coeffs.size(); ++term_idx)
+  {
+    compensated_add(activity,
+                    activity_comp,
+                    coeffs[term_idx] *
+                        m_var_current_value[var_idxs[term_idx]]);
   }
+  m_con_activity[p_con_idx] = activity;
+  m_con_activity_tail[p_con_idx] = Activity_Tail{activity_comp, 0.0};
 }
 
 void Local_Search::apply_move(size_t p_var_idx, double p_delta)
@@ -282,13 +456,21 @@ void Local_Search::apply_move(size_t p_var_idx, double p_delta)
         model_var.lower_bound() - m_var_current_value[p_var_idx],
         model_var.upper_bound() - m_var_current_value[p_var_idx]);
   }
+  const double old_value = m_var_current_value[p_var_idx];
   m_var_current_value[p_var_idx] += p_delta;
   m_activity_dirty = true;
+  telemetry_add(m_telemetry.moves);
   if (m_use_exact_double_activity)
-    update_affected_activities<double>(model_var, p_delta);
+    update_affected_activities<double>(p_var_idx, p_delta);
+  else if (m_use_compensated_activity)
+  {
+    // The rows follow the change the rounded value really made.
+    update_affected_activities<Compensated_Double>(
+        p_var_idx, m_var_current_value[p_var_idx] - old_value);
+  }
   else
   {
-    update_affected_activities<long double>(model_var, p_delta);
+    update_affected_activities<long double>(p_var_idx, p_delta);
     ++m_activity_hits;
     if (m_activity_hits >= m_activity_period)
       refresh_activities();
@@ -364,7 +546,7 @@ bool Local_Search::verify_solution() const
   {
     const auto& model_con = m_model_manager->con(con_idx);
     const long double activity =
-        compute_activity<long double>(model_con, m_var_best_value.data());
+        compute_activity<long double>(con_idx, m_var_best_value.data());
     if (con_sat(con_idx, activity))
       continue;
     printf(m_con_is_equality[con_idx]
@@ -375,9 +557,8 @@ bool Local_Search::verify_solution() const
            m_con_constant[con_idx]);
     return false;
   }
-  const auto& model_obj = m_model_manager->obj();
   const long double obj_value =
-      compute_activity<long double>(model_obj, m_var_best_value.data());
+      compute_activity<long double>(0, m_var_best_value.data());
   if (std::fabs(static_cast<double>(obj_value) - m_best_obj) >
       m_readonly_ctx.m_opt_tolerance)
   {
@@ -396,26 +577,16 @@ void Local_Search::write_sol() const
     printf("o refusing to write an invalid solution.\n");
     return;
   }
-  printf("c best-found solution is written to %s\n", m_sol_path.c_str());
-  FILE* sol_file = fopen(m_sol_path.c_str(), "w");
-  if (sol_file == nullptr)
+  std::vector<double> values = m_var_best_value;
+  m_model_manager->postsolve_values(values);
+  std::string buffer;
+  Sol_Writer::format(*m_model_manager, values, buffer);
+  if (!Sol_Writer::write_atomically(m_sol_path, buffer))
   {
     printf("o cannot open solution file %s.\n", m_sol_path.c_str());
     return;
   }
-  fprintf(
-      sol_file, "%-50s        %s\n", "Variable name", "Variable value");
-  for (size_t var_idx = 0; var_idx < m_var_num; var_idx++)
-  {
-    const auto& model_var = m_model_manager->var(var_idx);
-    if (m_var_best_value[var_idx])
-      fprintf(sol_file,
-              "%-50s        %.*g\n",
-              model_var.name().c_str(),
-              std::numeric_limits<double>::max_digits10,
-              m_var_best_value[var_idx]);
-  }
-  fclose(sol_file);
+  printf("c best-found solution is written to %s\n", m_sol_path.c_str());
 }
 
 bool Local_Search::can_use_exact_double_activity() const
@@ -501,14 +672,50 @@ bool Local_Search::can_use_exact_double_activity() const
   return true;
 }
 
+// Certified activities are integers no larger than 2^53 in magnitude, so
+// the interval only has to agree with con_sat() on those.
+void Local_Search::build_sat_intervals()
+{
+  if (!m_use_exact_double_activity)
+  {
+    m_con_sat_interval.clear();
+    m_readonly_ctx.m_con_sat_interval = nullptr;
+    return;
+  }
+  const double tolerance = m_model_manager->feas_tolerance();
+  m_con_sat_interval.assign(
+      m_con_num,
+      Sat_Interval{-std::numeric_limits<double>::infinity(),
+                   std::numeric_limits<double>::infinity()});
+  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+  {
+    Sat_Interval& interval = m_con_sat_interval[con_idx];
+    const double constant = m_con_constant[con_idx];
+    interval.m_upper = largest_integer_within(constant, tolerance);
+    if (m_con_is_equality[con_idx])
+      interval.m_lower = smallest_integer_within(constant, -tolerance);
+  }
+  m_readonly_ctx.m_con_sat_interval = m_con_sat_interval.data();
+}
+
 void Local_Search::configure_activity_arithmetic()
 {
   m_use_exact_double_activity = can_use_exact_double_activity();
+  m_use_compensated_activity =
+      !m_use_exact_double_activity && m_prefer_compensated_activity;
+  m_uncertain_row_refreshes = 0;
   if (m_use_exact_double_activity)
   {
     printf("c activity arithmetic: exact double (certified)\n");
+    printf("c activity kernel: %s\n",
+           Row_Activity::kernel_name(m_row_activity.kernel()));
     printf("c periodic activity recomputation: disabled (T=infinity)\n");
   }
+  else if (m_use_compensated_activity)
+  {
+    printf("c activity arithmetic: compensated double\n");
+    printf("c periodic activity recomputation: disabled (error bound)\n");
+  }
   else
     printf("c activity arithmetic: long double\n");
 }
@@ -527,6 +734,7 @@ void Local_Search::init_data()
       std::max<size_t>(m_activity_period, static_cast<size_t>(1));
   m_activity_hits = 0;
   m_activity_dirty = false;
+  m_next_incumbent_sync_step = 0;
   configure_activity_arithmetic();
   m_var_current_value.resize(m_var_num, 0.0);
   m_var_best_value.resize(m_var_num, 0.0);
@@ -539,18 +747,40 @@ void Local_Search::init_data()
   m_feas_touch_vars.reserve(m_var_num);
   m_binary_op_stamp.assign(m_var_num, 0);
   m_binary_op_stamp_token = 0;
+  if (m_use_score_cache)
+    m_score_cache.resize(m_var_num);
+  const size_t score_thread_num = resolve_worker_num(m_score_thread_num);
+  if (score_thread_num <= 1)
+  {
+    m_parallel_scoring = nullptr;
+    m_worker_pool = nullptr;
+  }
+  else if (m_worker_pool == nullptr ||
+           m_worker_pool->thread_num() != score_thread_num)
+  {
+    m_parallel_scoring = nullptr;
+    m_worker_pool = std::make_unique<Worker_Pool>(score_thread_num);
+    m_parallel_scoring = std::make_unique<Parallel_Scoring>(*m_worker_pool);
+  }
   m_var_LB_feas_delta.resize(m_obj_var_num, 0.0);
   m_var_UB_feas_delta.resize(m_obj_var_num, 0.0);
   m_var_lift_delta.resize(m_obj_var_num, 0.0);
   m_con_weight.resize(m_con_num, 1);
-  m_con_pos_in_unsat_idxs.resize(m_con_num, SIZE_MAX);
-  m_con_pos_in_sat_idxs.resize(m_con_num, SIZE_MAX);
+  m_con_pos_in_unsat_idxs.resize(m_con_num, k_null_idx);
+  m_con_is_sat.resize(m_con_num, false);
+  m_readonly_ctx.m_con_is_sat = &m_con_is_sat;
   m_con_unsat_idxs.reserve(m_con_num);
-  m_con_sat_idxs.reserve(m_con_num);
+  if (m_publish_con_sat_idxs)
+    m_con_sat_idxs.reserve(m_con_num);
   m_con_constant.resize(m_con_num, 0.0);
   m_con_activity.resize(m_con_num, 0.0);
+  if (m_use_compensated_activity)
+    m_con_activity_tail.resize(m_con_num, Activity_Tail{0.0, 0.0});
+  else
+    m_con_activity_tail.clear();
   for (size_t con_idx = 1; con_idx < m_con_num; con_idx++)
     m_con_constant[con_idx] = m_model_manager->con(con_idx).rhs();
+  build_sat_intervals();
   if (m_explore_neighbor_list.empty())
   {
     m_explore_neighbor_list = {
@@ -639,8 +869,8 @@ bool Local_Search::solve_objective_only_impl()
     m_var_current_value[var_idx] = value;
     m_var_best_value[var_idx] = value;
   }
-  const Accumulator best_obj = compute_activity<Accumulator>(
-      m_model_manager->obj(), m_var_current_value.data());
+  const Accumulator best_obj =
+      compute_activity<Accumulator>(0, m_var_current_value.data());
   m_best_obj = static_cast<double>(best_obj);
   m_con_activity[0] = m_best_obj;
   m_is_found_feasible = true;
@@ -728,19 +958,33 @@ bool Local_Search::verify_domain_values(
 Local_Search::Local_Search(const Model_Manager* p_model_manager,
                            double p_opt_tolerance)
     : m_model_manager(p_model_manager),
+      m_matrix(&p_model_manager->matrix()),
       m_con_is_equality(p_model_manager->con_is_equality()),
       m_var_obj_cost(p_model_manager->var_obj_cost()),
       m_is_keep_feas(false), m_strct_feas(true), m_break_eq_feas(false),
-      m_binary_op_stamp_token(0), m_activity_period(100000),
+      m_binary_op_stamp_token(0), m_con_sat_idxs_stale(true),
+      m_publish_con_sat_idxs(false), m_activity_period(100000),
       m_activity_hits(0), m_activity_dirty(false),
-      m_use_exact_double_activity(false), m_cur_step(0), m_tabu_base(4),
+      m_use_exact_double_activity(false),
+      m_prefer_compensated_activity(false),
+      m_use_compensated_activity(false), m_con_activity_tail(),
+      m_uncertain_row_refreshes(0), m_row_activity(),
+      m_use_score_cache(false), m_score_thread_num(1),
+      m_worker_pool(nullptr), m_parallel_scoring(nullptr),
+      m_cur_step(0), m_tabu_base(4),
       m_tabu_variation(7), m_is_found_feasible(false),
       m_current_obj_breakthrough(false), m_last_improve_step(0),
       m_bms_unsat_con(10), m_bms_mtm_unsat_op(2250), m_bms_sat_con(1),
       m_bms_mtm_sat_op(80), m_bms_flip_op(0), m_bms_easy_op(5),
       m_bms_random_op(250), m_best_obj(k_inf),
       m_logged_obj_value(std::numeric_limits<double>::quiet_NaN()),
-      m_terminated(false), m_sol_path(""), m_min_unsat_con(SIZE_MAX),
+      m_improvement_ring(k_improvement_ring_capacity),
+      m_improvement_cbk(nullptr), m_improvement_user_data(nullptr),
+      m_terminated(false), m_shared_incumbent(nullptr),
+      m_group_stop(nullptr), m_incumbent_sync_period(100),
+      m_next_incumbent_sync_step(0), m_sol_path(""), m_resume_path(""),
+      m_step_limit(SIZE_MAX),
+      m_min_unsat_con(SIZE_MAX),
       m_has_objective(false), m_is_unbounded(false),
       m_readonly_ctx(*m_model_manager,
                      m_var_current_value,
@@ -809,11 +1053,78 @@ void Local_Search::set_opt_tolerance(double p_value) noexcept
   m_readonly_ctx.m_opt_tolerance = p_value;
 }
 
+double Local_Search::opt_tolerance() const noexcept
+{
+  return m_readonly_ctx.m_opt_tolerance;
+}
+
+void Local_Search::set_shared_incumbent(
+    Shared_Incumbent* p_incumbent) noexcept
+{
+  m_shared_incumbent = p_incumbent;
+}
+
+void Local_Search::set_group_stop(
+    const std::atomic<bool>* p_group_stop) noexcept
+{
+  m_group_stop = p_group_stop;
+}
+
+void Local_Search::set_incumbent_sync_period(size_t p_value)
+{
+  m_incumbent_sync_period = std::max<size_t>(1, p_value);
+}
+
+// Tightens the objective constraint to the best objective published by any
+// attached search, so moves that cannot beat it are no longer rewarded.
+// Only the bound is adopted here; the solution itself is imported at the
+// next restart.
+void Local_Search::tighten_to_shared_incumbent()
+{
+  m_next_incumbent_sync_step = m_cur_step + m_incumbent_sync_period;
+  if (!m_shared_incumbent->has_solution())
+    return;
+  const double shared_constant =
+      m_shared_incumbent->best_obj() - m_readonly_ctx.m_opt_tolerance;
+  if (!(shared_constant < m_con_constant[0]))
+    return;
+  m_con_constant[0] = shared_constant;
+  m_current_obj_breakthrough = m_con_activity[0] <= m_con_constant[0];
+}
+
+bool Local_Search::import_shared_incumbent()
+{
+  if (m_shared_incumbent == nullptr || m_is_unbounded)
+    return false;
+  auto snapshot = m_shared_incumbent->snapshot();
+  if (snapshot == nullptr || snapshot->m_values.size() != m_var_num ||
+      (m_is_found_feasible && !(snapshot->m_obj < m_best_obj)))
+    return false;
+  memcpy(m_var_best_value.data(),
+         snapshot->m_values.data(),
+         m_var_num * sizeof(double));
+  m_best_obj = snapshot->m_obj;
+  m_con_constant[0] = m_best_obj - m_readonly_ctx.m_opt_tolerance;
+  m_is_found_feasible = true;
+  publish_best_obj();
+  return true;
+}
+
 void Local_Search::set_sol_path(const std::string& p_sol_path)
 {
   m_sol_path = p_sol_path;
 }
 
+void Local_Search::set_resume_path(const std::string& p_resume_path)
+{
+  m_resume_path = p_resume_path;
+}
+
+void Local_Search::set_step_limit(size_t p_value)
+{
+  m_step_limit = p_value == 0 ? SIZE_MAX : p_value;
+}
+
 void Local_Search::set_random_seed(uint32_t p_seed)
 {
   if (p_seed == 0)
@@ -838,6 +1149,7 @@ void Local_Search::set_restart_cbk(Restart::Restart_Cbk p_restart_cbk,
                                    void* p_user_data)
 {
   m_restart.set_cbk(std::move(p_restart_cbk), p_user_data);
+  m_publish_con_sat_idxs = true;
 }
 
 void Local_Search::set_restart_method(const std::string& p_restart_name)
@@ -854,6 +1166,7 @@ void Local_Search::set_weight_cbk(Weight_Cbk p_weight_cbk,
                                   void* p_user_data)
 {
   m_weight.set_cbk(std::move(p_weight_cbk), p_user_data);
+  m_publish_con_sat_idxs = true;
 }
 
 void Local_Search::set_weight_method(const std::string& p_method_name)
@@ -883,12 +1196,21 @@ void Local_Search::set_lift_scoring_cbk(Lift_Scoring_Cbk p_cbk,
                                         void* p_user_data)
 {
   m_scoring.set_lift_cbk(std::move(p_cbk), p_user_data);
+  m_publish_con_sat_idxs = true;
 }
 
 void Local_Search::set_neighbor_scoring_cbk(Neighbor_Scoring_Cbk p_cbk,
                                             void* p_user_data)
 {
   m_scoring.set_neighbor_cbk(std::move(p_cbk), p_user_data);
+  m_publish_con_sat_idxs = true;
+}
+
+void Local_Search::set_improvement_cbk(Improvement_Cbk p_cbk,
+                                       void* p_user_data)
+{
+  m_improvement_cbk = std::move(p_cbk);
+  m_improvement_user_data = p_user_data;
 }
 
 void Local_Search::set_bms_unsat_con(size_t p_value)
@@ -945,6 +1267,7 @@ void Local_Search::add_custom_neighbor(const std::string& p_neighbor_name,
 {
   m_explore_neighbor_list.emplace_back(
       p_neighbor_name, std::move(p_neighbor_cbk), p_user_data);
+  m_publish_con_sat_idxs = true;
 }
 
 void Local_Search::reset_default_neighbor_list()
@@ -968,6 +1291,32 @@ void Local_Search::set_activity_period(size_t p_value)
   m_activity_period = std::max<size_t>(1, p_value);
 }
 
+void Local_Search::set_activity_arithmetic(const std::string& p_name)
+{
+  if (p_name == "compensated")
+    m_prefer_compensated_activity = true;
+  else if (p_name == "long_double")
+    m_prefer_compensated_activity = false;
+  else
+  {
+    printf("c unsupported activity arithmetic %s, fallback to "
+           "long_double.\n",
+           p_name.c_str());
+    m_prefer_compensated_activity = false;
+  }
+}
+
+void Local_Search::set_score_cache(bool p_enable)
+{
+  m_use_score_cache = p_enable;
+  m_scoring_ctx.m_score_cache = p_enable ? &m_score_cache : nullptr;
+}
+
+void Local_Search::set_score_threads(size_t p_value)
+{
+  m_score_thread_num = p_value;
+}
+
 void Local_Search::set_tabu_variation(size_t p_value)
 {
   m_tabu_variation = std::max<size_t>(1, p_value);
@@ -16,21 +16,33 @@
 #include "../model_data/Model_Manager.h"
 #include "../utils/global_defs.h"
 #include "../utils/solver_error.h"
+#include "../utils/spsc_ring.h"
+#include "../utils/worker_pool.h"
+#include "activity/compensated_sum.h"
+#include "activity/row_activity.h"
 #include "context/context.h"
+#include "incumbent/incumbent_snapshot.h"
+#include "incumbent/primal_trajectory.h"
+#include "incumbent/shared_incumbent.h"
 #include "neighbor/neighbor.h"
 #include "restart/restart.h"
+#include "scoring/parallel_scoring.h"
+#include "scoring/score_cache.h"
 #include "scoring/scoring.h"
 #include "start/start.h"
+#include "telemetry/telemetry.h"
 #include "weight/weight.h"
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <limits>
+#include <memory>
 #include <random>
 #include <string>
 #include <unordered_set>
@@ -41,6 +53,8 @@ class Local_Search
 private:
   const Model_Manager* m_model_manager;
 
+  const Model_Matrix* m_matrix;
+
   const std::vector<bool>& m_con_is_equality;
 
   const std::vector<double>& m_var_obj_cost;
@@ -87,13 +101,24 @@ private:
 
   std::vector<double> m_con_constant;
 
-  std::vector<size_t> m_con_unsat_idxs;
+  std::vector<Model_Idx> m_con_unsat_idxs;
+
+  std::vector<Model_Idx> m_con_pos_in_unsat_idxs;
+
+  // One bit per constraint; the unsat list above is its complement over
+  // rows 1..m_con_num-1.
+  std::vector<bool> m_con_is_sat;
 
-  std::vector<size_t> m_con_pos_in_unsat_idxs;
+  // Kept for user callbacks only, in step with the bitset by
+  // update_con_status(); see sync_con_sat_idxs() for bulk changes.
+  std::vector<Model_Idx> m_con_sat_idxs;
 
-  std::vector<size_t> m_con_sat_idxs;
+  std::vector<Model_Idx> m_con_pos_in_sat_idxs;
 
-  std::vector<size_t> m_con_pos_in_sat_idxs;
+  bool m_con_sat_idxs_stale;
+
+  // Set once a callback that can read m_con_sat_idxs is registered.
+  bool m_publish_con_sat_idxs;
 
   size_t m_activity_period;
 
@@ -103,6 +128,39 @@ private:
 
   bool m_use_exact_double_activity;
 
+  // Setting: uncertified models use compensated double instead of long
+  // double.
+  bool m_prefer_compensated_activity;
+
+  bool m_use_compensated_activity;
+
+  // Compensated mode only: the activity of row i is the unevaluated sum
+  // m_con_activity[i] + m_con_activity_tail[i].m_comp, within
+  // m_con_activity_tail[i].m_err of the value a recomputation of the row
+  // gives.
+  std::vector<Activity_Tail> m_con_activity_tail;
+
+  // Rows recomputed because their error bound could flip a decision.
+  size_t m_uncertain_row_refreshes;
+
+  // Built by init_data() for certified models; see Sat_Interval.
+  std::vector<Sat_Interval> m_con_sat_interval;
+
+  // Kernel of the exact-double refresh, chosen for the running CPU.
+  Row_Activity m_row_activity;
+
+  Score_Cache m_score_cache;
+
+  bool m_use_score_cache;
+
+  size_t m_score_thread_num;
+
+  // Created by init_data() when more than one scoring thread is set; the
+  // pool also splits the exact-double activity refresh across rows.
+  std::unique_ptr<Worker_Pool> m_worker_pool;
+
+  std::unique_ptr<Parallel_Scoring> m_parallel_scoring;
+
   size_t m_cur_step;
 
   std::mt19937 m_rng;
@@ -135,10 +193,32 @@ private:
 
   std::atomic<double> m_logged_obj_value;
 
+  // Improvements of this search, drained by the objective logger of
+  // Local_MIP.
+  Spsc_Ring<Improvement_Event> m_improvement_ring;
+
+  Improvement_Cbk m_improvement_cbk;
+
+  void* m_improvement_user_data;
+
   std::atomic<bool> m_terminated;
 
+  Shared_Incumbent* m_shared_incumbent;
+
+  const std::atomic<bool>* m_group_stop;
+
+  size_t m_incumbent_sync_period;
+
+  size_t m_next_incumbent_sync_step;
+
   std::string m_sol_path;
 
+  // Checkpoint restored by the next run_search() instead of a start
+  // solution.
+  std::string m_resume_path;
+
+  size_t m_step_limit;
+
   size_t m_min_unsat_con;
 
   size_t m_var_num;
@@ -187,6 +267,8 @@ private:
 
   std::vector<Neighbor> m_explore_neighbor_list;
 
+  Search_Telemetry m_telemetry;
+
   template <typename Activity>
   inline bool con_sat(size_t p_con_idx, Activity p_activity) const;
 
@@ -198,6 +280,25 @@ private:
 
   inline void delete_sat(size_t p_con_idx);
 
+  // Moves a constraint between sat and unsat after its activity changed.
+  inline void update_con_status(size_t p_con_idx,
+                                bool p_was_sat,
+                                bool p_now_sat);
+
+  // Rebuilds the sat list and its positions from the bitset when a
+  // registered callback may read it and a full refresh or a resume rewrote
+  // the bitset since the last rebuild. Single flips in between are applied
+  // to the list directly, so the rebuild cost is only paid where the
+  // refresh already visits every row.
+  inline void sync_con_sat_idxs();
+
+  // Compensated mode: true when the tracked error of the row could place
+  // its exact activity on the other side of a p_tolerance gap threshold.
+  inline bool activity_is_uncertain(size_t p_con_idx,
+                                    double p_tolerance) const;
+
+  void recompute_compensated_activity(size_t p_con_idx);
+
   inline bool tabu(size_t p_var_idx, double p_delta);
 
   inline bool tabu_latest(size_t p_var_idx, double p_delta);
@@ -206,8 +307,14 @@ private:
 
   inline void update_best_solution();
 
+  // Hands m_var_best_value to the logger, the shared incumbent and the
+  // improvement callback.
+  inline void report_best_solution();
+
   inline void publish_best_obj();
 
+  void tighten_to_shared_incumbent();
+
   void normalize_domain_values(std::vector<double>& p_values,
                                const char* p_source) const;
 
@@ -228,15 +335,16 @@ private:
   void refresh_activities_impl();
 
   template <typename Accumulator>
-  Accumulator compute_activity(const Model_Con& p_con,
+  Accumulator compute_activity(size_t p_con_idx,
                                const double* p_var_values) const;
 
   template <typename Accumulator>
-  void update_affected_activities(const Model_Var& p_model_var,
-                                  double p_delta);
+  void update_affected_activities(size_t p_var_idx, double p_delta);
 
   bool can_use_exact_double_activity() const;
 
+  void build_sat_intervals();
+
   void configure_activity_arithmetic();
 
   double checked_move_value(size_t p_var_idx,
@@ -259,6 +367,14 @@ private:
 
   void init_data();
 
+  void encode_checkpoint(std::string& p_buffer) const;
+
+  void decode_checkpoint(const std::string& p_buffer);
+
+  bool con_lists_consistent() const;
+
+  void load_checkpoint();
+
 public:
   using Start_Cbk = Start::Start_Cbk;
 
@@ -286,14 +402,47 @@ public:
 
   void write_sol() const;
 
+  // Writes the dynamic search state: values, tabu and age steps, weights,
+  // activities, the random generator and the neighbor list. Resuming it
+  // with the same model and parameters continues the search exactly.
+  bool save_checkpoint(const std::string& p_path) const;
+
+  void set_resume_path(const std::string& p_resume_path);
+
+  // Stops once the step counter reaches p_value; 0 means no limit. The
+  // counter is restored on resume, so the limit is a total over slices.
+  void set_step_limit(size_t p_value);
+
   inline double get_obj_value() const;
 
   inline bool is_feasible() const;
 
   inline const std::vector<double>& get_solution() const;
 
+  inline size_t get_step_num() const;
+
+  inline const std::string& get_sol_path() const;
+
+  // Consumer side of the improvement ring; one thread at a time.
+  inline bool pop_improvement(Improvement_Event& p_event);
+
+  inline size_t dropped_improvements() const;
+
+  // Counters of the last run; zeros unless built with LOCAL_MIP_TELEMETRY.
+  Search_Telemetry get_telemetry() const;
+
   void terminate() noexcept;
 
+  void set_shared_incumbent(Shared_Incumbent* p_incumbent) noexcept;
+
+  void set_group_stop(const std::atomic<bool>* p_group_stop) noexcept;
+
+  void set_incumbent_sync_period(size_t p_value);
+
+  bool import_shared_incumbent();
+
+  double opt_tolerance() const noexcept;
+
   void set_sol_path(const std::string& p_sol_path);
 
   void set_random_seed(uint32_t p_seed);
@@ -328,6 +477,11 @@ public:
   void set_neighbor_scoring_cbk(Neighbor_Scoring_Cbk p_cbk,
                                 void* p_user_data = nullptr);
 
+  // Called with every improving solution; with a shared incumbent only
+  // when it is also the best of the group.
+  void set_improvement_cbk(Improvement_Cbk p_cbk,
+                           void* p_user_data = nullptr);
+
   void set_bms_unsat_con(size_t p_value);
 
   void set_bms_mtm_unsat_op(size_t p_value);
@@ -358,6 +512,16 @@ public:
 
   void set_activity_period(size_t p_value);
 
+  // "long_double" or "compensated"; the arithmetic of models that fail the
+  // exact-double certificate.
+  void set_activity_arithmetic(const std::string& p_name);
+
+  // Threads scoring the operations of one neighborhood; 0 uses all
+  // hardware threads. The selected moves do not depend on it.
+  void set_score_threads(size_t p_value);
+
+  void set_score_cache(bool p_enable);
+
   void set_tabu_variation(size_t p_value);
 
   void set_break_eq_feas(bool p_break_eq_feas);
@@ -378,38 +542,96 @@ inline bool Local_Search::con_sat(size_t p_con_idx,
 
 inline void Local_Search::insert_unsat(size_t p_con_idx)
 {
-  assert(m_con_pos_in_unsat_idxs[p_con_idx] == SIZE_MAX);
-  m_con_pos_in_unsat_idxs[p_con_idx] = m_con_unsat_idxs.size();
-  m_con_unsat_idxs.push_back(p_con_idx);
+  assert(m_con_pos_in_unsat_idxs[p_con_idx] == k_null_idx);
+  m_con_pos_in_unsat_idxs[p_con_idx] =
+      static_cast<Model_Idx>(m_con_unsat_idxs.size());
+  m_con_unsat_idxs.push_back(static_cast<Model_Idx>(p_con_idx));
 }
 
 inline void Local_Search::delete_unsat(size_t p_con_idx)
 {
-  assert(m_con_pos_in_unsat_idxs[p_con_idx] != SIZE_MAX);
-  size_t pos = m_con_pos_in_unsat_idxs[p_con_idx];
-  size_t last_con_idx = m_con_unsat_idxs.back();
+  assert(m_con_pos_in_unsat_idxs[p_con_idx] != k_null_idx);
+  Model_Idx pos = m_con_pos_in_unsat_idxs[p_con_idx];
+  Model_Idx last_con_idx = m_con_unsat_idxs.back();
   m_con_unsat_idxs[pos] = last_con_idx;
   m_con_pos_in_unsat_idxs[last_con_idx] = pos;
   m_con_unsat_idxs.pop_back();
-  m_con_pos_in_unsat_idxs[p_con_idx] = SIZE_MAX;
+  m_con_pos_in_unsat_idxs[p_con_idx] = k_null_idx;
 }
 
 inline void Local_Search::insert_sat(size_t p_con_idx)
 {
-  assert(m_con_pos_in_sat_idxs[p_con_idx] == SIZE_MAX);
-  m_con_pos_in_sat_idxs[p_con_idx] = m_con_sat_idxs.size();
-  m_con_sat_idxs.push_back(p_con_idx);
+  assert(m_con_pos_in_sat_idxs[p_con_idx] == k_null_idx);
+  m_con_pos_in_sat_idxs[p_con_idx] =
+      static_cast<Model_Idx>(m_con_sat_idxs.size());
+  m_con_sat_idxs.push_back(static_cast<Model_Idx>(p_con_idx));
 }
 
 inline void Local_Search::delete_sat(size_t p_con_idx)
 {
-  assert(m_con_pos_in_sat_idxs[p_con_idx] != SIZE_MAX);
-  size_t pos = m_con_pos_in_sat_idxs[p_con_idx];
-  size_t last_con_idx = m_con_sat_idxs.back();
+  assert(m_con_pos_in_sat_idxs[p_con_idx] != k_null_idx);
+  Model_Idx pos = m_con_pos_in_sat_idxs[p_con_idx];
+  Model_Idx last_con_idx = m_con_sat_idxs.back();
   m_con_sat_idxs[pos] = last_con_idx;
   m_con_pos_in_sat_idxs[last_con_idx] = pos;
   m_con_sat_idxs.pop_back();
-  m_con_pos_in_sat_idxs[p_con_idx] = SIZE_MAX;
+  m_con_pos_in_sat_idxs[p_con_idx] = k_null_idx;
+}
+
+inline void Local_Search::update_con_status(size_t p_con_idx,
+                                            bool p_was_sat,
+                                            bool p_now_sat)
+{
+  if (p_was_sat == p_now_sat)
+    return;
+  m_con_is_sat[p_con_idx] = p_now_sat;
+  if (p_now_sat)
+    delete_unsat(p_con_idx);
+  else
+    insert_unsat(p_con_idx);
+  if (!m_publish_con_sat_idxs || m_con_sat_idxs_stale)
+    return;
+  if (p_now_sat)
+    insert_sat(p_con_idx);
+  else
+    delete_sat(p_con_idx);
+}
+
+inline void Local_Search::sync_con_sat_idxs()
+{
+  if (!m_con_sat_idxs_stale || !m_publish_con_sat_idxs)
+    return;
+  m_con_sat_idxs.clear();
+  m_con_pos_in_sat_idxs.assign(m_con_num, k_null_idx);
+  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+  {
+    if (m_con_is_sat[con_idx])
+      insert_sat(con_idx);
+  }
+  m_con_sat_idxs_stale = false;
+}
+
+// The radius covers the tracked error, the tail not yet folded into
+// m_con_activity and the rounding of the gap computation itself. Rows with
+// no error since their last recomputation are taken as they are, so a row
+// is never recomputed twice for the same value.
+inline bool Local_Search::activity_is_uncertain(size_t p_con_idx,
+                                                double p_tolerance) const
+{
+  const Activity_Tail& tail = m_con_activity_tail[p_con_idx];
+  if (tail.m_err == 0.0)
+    return false;
+  const double activity = m_con_activity[p_con_idx];
+  const double constant = m_con_constant[p_con_idx];
+  const double radius =
+      tail.m_err + std::fabs(tail.m_comp) +
+      2.0 * k_unit_roundoff *
+          (std::fabs(activity) + std::fabs(constant) + p_tolerance);
+  const double gap = activity - constant;
+  const double margin = m_con_is_equality[p_con_idx]
+                            ? std::fabs(std::fabs(gap) - p_tolerance)
+                            : std::fabs(gap - p_tolerance);
+  return margin <= radius;
 }
 
 inline void Local_Search::update_best_solution()
@@ -423,7 +645,20 @@ inline void Local_Search::update_best_solution()
   m_best_obj = m_con_activity[0];
   m_con_constant[0] = m_best_obj - m_readonly_ctx.m_opt_tolerance;
   m_current_obj_breakthrough = false;
+  report_best_solution();
+}
+
+inline void Local_Search::report_best_solution()
+{
   publish_best_obj();
+  const double obj = m_logged_obj_value.load(std::memory_order_relaxed);
+  m_improvement_ring.push({std::chrono::steady_clock::now(), m_cur_step, obj});
+  const bool is_new_best =
+      m_shared_incumbent == nullptr ||
+      m_shared_incumbent->publish(m_best_obj, m_var_best_value);
+  if (m_improvement_cbk && is_new_best)
+    m_improvement_cbk(Improvement_Ctx{m_var_best_value, obj, m_cur_step},
+                      m_improvement_user_data);
 }
 
 inline void Local_Search::publish_best_obj()
@@ -449,6 +684,26 @@ inline const std::vector<double>& Local_Search::get_solution() const
   return m_var_best_value;
 }
 
+inline size_t Local_Search::get_step_num() const
+{
+  return m_cur_step;
+}
+
+inline const std::string& Local_Search::get_sol_path() const
+{
+  return m_sol_path;
+}
+
+inline bool Local_Search::pop_improvement(Improvement_Event& p_event)
+{
+  return m_improvement_ring.pop(p_event);
+}
+
+inline size_t Local_Search::dropped_improvements() const
+{
+  return m_improvement_ring.dropped();
+}
+
 inline void Local_Search::reset_op(bool p_require_positive)
 {
   ++m_binary_op_stamp_token;
@@ -473,17 +728,52 @@ Local_Search::explore_neighbor(std::vector<Neighbor>& p_explore_neighbors)
   assert(!p_explore_neighbors.empty());
   bool validate_selected_move = m_scoring.has_neighbor_callback();
   reset_op(true);
-  for (auto& neighbor : p_explore_neighbors)
+  if (m_telemetry.neighbors.size() != p_explore_neighbors.size())
+  {
+    m_telemetry.neighbors.clear();
+    for (const auto& neighbor : p_explore_neighbors)
+      m_telemetry.neighbors.push_back(Neighbor_Stats{neighbor.name()});
+  }
+  Phase_Timer explore_timer(m_telemetry.explore_neighbor);
+  for (size_t neighbor_idx = 0; neighbor_idx < p_explore_neighbors.size();
+       ++neighbor_idx)
   {
+    auto& neighbor = p_explore_neighbors[neighbor_idx];
+    Neighbor_Stats& stats = m_telemetry.neighbors[neighbor_idx];
     m_op_var_deltas.clear();
     m_op_var_idxs.clear();
     m_op_size = 0;
     if (&neighbor == &p_explore_neighbors.back())
     {
       reset_op(false);
-      m_weight.update(m_weight_ctx);
+      Phase_Timer weight_timer(m_telemetry.weight_update);
+      const bool unsat_only = m_weight.update(m_weight_ctx);
+      if (m_use_score_cache)
+      {
+        // See Weight::update(): each unsat row gained exactly one unit.
+        if (unsat_only)
+        {
+          for (const size_t con_idx : m_con_unsat_idxs)
+            m_scoring.patch_score_cache(m_scoring_ctx,
+                                        con_idx,
+                                        m_con_activity[con_idx],
+                                        m_con_weight[con_idx] - 1);
+        }
+        else
+          m_score_cache.invalidate_all();
+      }
     }
+    uint64_t phase_start = k_telemetry_enabled ? read_cycles() : 0;
     neighbor.explore(m_neighbor_ctx);
+    if constexpr (k_telemetry_enabled)
+    {
+      const uint64_t explored = read_cycles();
+      ++stats.calls;
+      stats.candidates += m_op_var_idxs.size();
+      stats.scored += m_op_size;
+      stats.explore_cycles += explored - phase_start;
+      phase_start = explored;
+    }
     const bool user_defined = neighbor.is_user_defined();
     if (user_defined)
     {
@@ -498,19 +788,36 @@ Local_Search::explore_neighbor(std::vector<Neighbor>& p_explore_neighbors)
     else
       assert(m_op_size <= m_op_var_idxs.size() &&
              m_op_size <= m_op_var_deltas.size());
-    for (size_t op_idx = 0; op_idx < m_op_size; ++op_idx)
+    for (size_t op_idx = 0; user_defined && op_idx < m_op_size; ++op_idx)
     {
-      if (user_defined && m_op_var_idxs[op_idx] >= m_var_num)
+      if (m_op_var_idxs[op_idx] >= m_var_num)
       {
         throw Solver_Error(
             "neighbor callback variable index is out of range: " +
             std::to_string(m_op_var_idxs[op_idx]));
       }
-      m_scoring.score_neighbor(
-          m_scoring_ctx, m_op_var_idxs[op_idx], m_op_var_deltas[op_idx]);
     }
+    if (m_parallel_scoring != nullptr && !m_scoring.has_neighbor_callback())
+    {
+      m_parallel_scoring->score(m_scoring,
+                                m_scoring_ctx,
+                                m_op_var_idxs,
+                                m_op_var_deltas,
+                                m_op_size);
+    }
+    else
+    {
+      for (size_t op_idx = 0; op_idx < m_op_size; ++op_idx)
+        m_scoring.score_neighbor(
+            m_scoring_ctx, m_op_var_idxs[op_idx], m_op_var_deltas[op_idx]);
+    }
+    telemetry_add(stats.score_cycles,
+                  k_telemetry_enabled ? read_cycles() - phase_start : 0);
     if (m_best_neighbor_score > 0)
+    {
+      telemetry_add(stats.hits);
       break;
+    }
   }
   return validate_selected_move;
 }
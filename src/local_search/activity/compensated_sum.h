@@ -0,0 +1,54 @@
+/*=====================================================================================
+
+    Filename:     compensated_sum.h
+
+    Description:  Compensated double accumulation for row activities
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <cmath>
+
+// Unit roundoff of double, 2^-53.
+inline constexpr double k_unit_roundoff = 0x1p-53;
+
+// Selects the compensated activity arithmetic in the templates of
+// Local_Search, which are otherwise instantiated with the accumulator type.
+struct Compensated_Double
+{
+};
+
+// Compensation term and error bound of one compensated activity, kept
+// together so that an update touches one cache line besides the activity.
+struct Activity_Tail
+{
+  double m_comp;
+
+  double m_err;
+};
+
+// Knuth's error-free addition: p_a + p_b == p_sum + p_err exactly.
+inline void two_sum(double p_a, double p_b, double& p_sum, double& p_err)
+{
+  p_sum = p_a + p_b;
+  const double b_virtual = p_sum - p_a;
+  const double a_virtual = p_sum - b_virtual;
+  p_err = (p_a - a_virtual) + (p_b - b_virtual);
+}
+
+// Adds p_term to the unevaluated sum p_hi + p_lo. The rounding error of the
+// main addition is recovered exactly and carried in p_lo (Neumaier), and the
+// pair is renormalized so that p_hi stays the double nearest to the
+// compensated value. Only the addition of the two tails rounds; the bound of
+// that error is returned.
+inline double compensated_add(double& p_hi, double& p_lo, double p_term)
+{
+  double sum;
+  double sum_err;
+  two_sum(p_hi, p_term, sum, sum_err);
+  const double tail = sum_err + p_lo;
+  two_sum(sum, tail, p_hi, p_lo);
+  return k_unit_roundoff * std::fabs(tail);
+}
@@ -0,0 +1,245 @@
+/*=====================================================================================
+
+    Filename:     row_activity.cpp
+
+    Description:  Vectorized recomputation of row activities over the CSR
+                  matrix
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "../../utils/global_defs.h"
+#include "../../utils/parallel_tasks.h"
+#include "row_activity.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LOCAL_MIP_ACTIVITY_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+void rows_scalar(const Model_Matrix& p_matrix,
+                 const double* p_var_values,
+                 size_t p_row_begin,
+                 size_t p_row_end,
+                 double* p_activity)
+{
+  for (size_t row = p_row_begin; row < p_row_end; ++row)
+  {
+    const auto coeffs = p_matrix.row_coeffs(row);
+    const auto var_idxs = p_matrix.row_var_idxs(row);
+    double activity = 0.0;
+    for (size_t term_idx = 0; term_idx < coeffs.size(); ++term_idx)
+      activity += coeffs[term_idx] * p_var_values[var_idxs[term_idx]];
+    p_activity[row] = activity;
+  }
+}
+
+#ifdef LOCAL_MIP_ACTIVITY_X86
+
+// Column indices are widened to 64 bits before the gather, since the 32-bit
+// gathers take signed offsets.
+__attribute__((target("avx2"))) inline __m256d
+gather4(const double* p_var_values, const Model_Idx* p_var_idxs)
+{
+  __m256i offsets;
+  if constexpr (sizeof(Model_Idx) == 4)
+    offsets = _mm256_cvtepu32_epi64(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_var_idxs)));
+  else
+    offsets =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_var_idxs));
+  return _mm256_i64gather_pd(p_var_values, offsets, 8);
+}
+
+__attribute__((target("avx2"))) inline double horizontal_sum(__m256d p_sum)
+{
+  __m128d low = _mm256_castpd256_pd128(p_sum);
+  const __m128d high = _mm256_extractf128_pd(p_sum, 1);
+  low = _mm_add_pd(low, high);
+  return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+}
+
+__attribute__((target("avx2"))) void rows_avx2(const Model_Matrix& p_matrix,
+                                               const double* p_var_values,
+                                               size_t p_row_begin,
+                                               size_t p_row_end,
+                                               double* p_activity)
+{
+  for (size_t row = p_row_begin; row < p_row_end; ++row)
+  {
+    const double* coeffs = p_matrix.row_coeffs(row).data();
+    const Model_Idx* var_idxs = p_matrix.row_var_idxs(row).data();
+    const size_t term_num = p_matrix.row_size(row);
+    size_t term_idx = 0;
+    double activity = 0.0;
+    if (term_num >= 4)
+    {
+      __m256d sum = _mm256_setzero_pd();
+      for (; term_idx + 4 <= term_num; term_idx += 4)
+      {
+        const __m256d values = gather4(p_var_values, var_idxs + term_idx);
+        sum = _mm256_add_pd(
+            sum, _mm256_mul_pd(_mm256_loadu_pd(coeffs + term_idx), values));
+      }
+      activity = horizontal_sum(sum);
+    }
+    for (; term_idx < term_num; ++term_idx)
+      activity += coeffs[term_idx] * p_var_values[var_idxs[term_idx]];
+    p_activity[row] = activity;
+  }
+}
+
+__attribute__((target("avx512f"))) inline __m512d
+gather8(const double* p_var_values, const Model_Idx* p_var_idxs)
+{
+  __m512i offsets;
+  if constexpr (sizeof(Model_Idx) == 4)
+    offsets = _mm512_cvtepu32_epi64(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_var_idxs)));
+  else
+    offsets = _mm512_loadu_si512(p_var_idxs);
+  return _mm512_mask_i64gather_pd(
+      _mm512_setzero_pd(), 0xFF, offsets, p_var_values, 8);
+}
+
+// Splits with masked extracts: _mm512_reduce_add_pd and the 256-bit cast
+// extract into an undefined register, which GCC reports under -Wall.
+__attribute__((target("avx512f"))) inline double
+horizontal_sum(__m512d p_sum)
+{
+  const __m256d low =
+      _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, p_sum, 0);
+  const __m256d high =
+      _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, p_sum, 1);
+  return horizontal_sum(_mm256_add_pd(low, high));
+}
+
+__attribute__((target("avx512f"))) void
+rows_avx512(const Model_Matrix& p_matrix,
+            const double* p_var_values,
+            size_t p_row_begin,
+            size_t p_row_end,
+            double* p_activity)
+{
+  for (size_t row = p_row_begin; row < p_row_end; ++row)
+  {
+    const double* coeffs = p_matrix.row_coeffs(row).data();
+    const Model_Idx* var_idxs = p_matrix.row_var_idxs(row).data();
+    const size_t term_num = p_matrix.row_size(row);
+    size_t term_idx = 0;
+    double activity = 0.0;
+    if (term_num >= 8)
+    {
+      __m512d sum = _mm512_setzero_pd();
+      for (; term_idx + 8 <= term_num; term_idx += 8)
+      {
+        const __m512d values = gather8(p_var_values, var_idxs + term_idx);
+        sum = _mm512_add_pd(
+            sum, _mm512_mul_pd(_mm512_loadu_pd(coeffs + term_idx), values));
+      }
+      activity = horizontal_sum(sum);
+    }
+    for (; term_idx < term_num; ++term_idx)
+      activity += coeffs[term_idx] * p_var_values[var_idxs[term_idx]];
+    p_activity[row] = activity;
+  }
+}
+
+#endif
+
+} // namespace
+
+Row_Activity::Row_Activity() : Row_Activity(best_supported())
+{
+}
+
+Row_Activity::Row_Activity(Activity_Kernel p_kernel,
+                           size_t p_min_parallel_nnz)
+    : m_kernel(is_supported(p_kernel) ? p_kernel : Activity_Kernel::scalar),
+      m_rows_fn(rows_scalar), m_min_parallel_nnz(p_min_parallel_nnz)
+{
+#ifdef LOCAL_MIP_ACTIVITY_X86
+  if (m_kernel == Activity_Kernel::avx512)
+    m_rows_fn = rows_avx512;
+  else if (m_kernel == Activity_Kernel::avx2)
+    m_rows_fn = rows_avx2;
+#endif
+}
+
+bool Row_Activity::is_supported(Activity_Kernel p_kernel)
+{
+  switch (p_kernel)
+  {
+#ifdef LOCAL_MIP_ACTIVITY_X86
+    case Activity_Kernel::avx512:
+      return __builtin_cpu_supports("avx512f");
+    case Activity_Kernel::avx2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    case Activity_Kernel::scalar:
+      return true;
+    default:
+      return false;
+  }
+}
+
+Activity_Kernel Row_Activity::best_supported()
+{
+  if (is_supported(Activity_Kernel::avx512))
+    return Activity_Kernel::avx512;
+  if (is_supported(Activity_Kernel::avx2))
+    return Activity_Kernel::avx2;
+  return Activity_Kernel::scalar;
+}
+
+const char* Row_Activity::kernel_name(Activity_Kernel p_kernel)
+{
+  switch (p_kernel)
+  {
+    case Activity_Kernel::avx512:
+      return "avx512";
+    case Activity_Kernel::avx2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+void Row_Activity::compute(const Model_Matrix& p_matrix,
+                           const double* p_var_values,
+                           size_t p_row_begin,
+                           size_t p_row_end,
+                           double* p_activity) const
+{
+  m_rows_fn(p_matrix, p_var_values, p_row_begin, p_row_end, p_activity);
+}
+
+void Row_Activity::compute_all(const Model_Matrix& p_matrix,
+                               const double* p_var_values,
+                               double* p_activity,
+                               Worker_Pool* p_pool) const
+{
+  const size_t row_num = p_matrix.row_num();
+  if (p_pool == nullptr || p_pool->thread_num() == 1 ||
+      p_matrix.nnz() < m_min_parallel_nnz)
+  {
+    m_rows_fn(p_matrix, p_var_values, 0, row_num, p_activity);
+    return;
+  }
+  const size_t part_num = std::min(p_pool->thread_num(), row_num);
+  p_pool->run(part_num,
+              [&](size_t p_part)
+              {
+                m_rows_fn(p_matrix,
+                          p_var_values,
+                          slice_begin(row_num, p_part, part_num),
+                          slice_begin(row_num, p_part + 1, part_num),
+                          p_activity);
+              });
+}
@@ -0,0 +1,82 @@
+/*=====================================================================================
+
+    Filename:     row_activity.h
+
+    Description:  Vectorized recomputation of row activities over the CSR
+                  matrix
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include "../../model_data/Model_Matrix.h"
+#include "../../utils/worker_pool.h"
+#include <cstddef>
+
+enum class Activity_Kernel
+{
+  scalar,
+  avx2,
+  avx512
+};
+
+// Dot products of the matrix rows with the current values in double
+// arithmetic. The vector kernels gather the values by column index and keep
+// one partial sum per lane, so they sum the terms of a row in another order
+// than the scalar loop: the results are bit-identical only when every
+// partial sum is exact, which is what the exact-double certification of the
+// search guarantees. Products and sums are never fused.
+class Row_Activity
+{
+public:
+  // Selects the widest kernel the running CPU supports.
+  Row_Activity();
+
+  // Falls back to the scalar kernel when the CPU lacks p_kernel.
+  explicit Row_Activity(Activity_Kernel p_kernel,
+                        size_t p_min_parallel_nnz = 1 << 16);
+
+  static bool is_supported(Activity_Kernel p_kernel);
+
+  static Activity_Kernel best_supported();
+
+  static const char* kernel_name(Activity_Kernel p_kernel);
+
+  inline Activity_Kernel kernel() const;
+
+  // Writes the activity of row i to p_activity[i] for every i in
+  // [p_row_begin, p_row_end).
+  void compute(const Model_Matrix& p_matrix,
+               const double* p_var_values,
+               size_t p_row_begin,
+               size_t p_row_end,
+               double* p_activity) const;
+
+  // All rows. With a pool of more than one thread and at least
+  // p_min_parallel_nnz nonzeros, the rows are split into contiguous slices
+  // computed concurrently; every row is still summed by one thread in the
+  // same order, so the result does not depend on the thread count.
+  void compute_all(const Model_Matrix& p_matrix,
+                   const double* p_var_values,
+                   double* p_activity,
+                   Worker_Pool* p_pool) const;
+
+private:
+  using Rows_Fn = void (*)(const Model_Matrix&,
+                           const double*,
+                           size_t,
+                           size_t,
+                           double*);
+
+  Activity_Kernel m_kernel;
+
+  Rows_Fn m_rows_fn;
+
+  size_t m_min_parallel_nnz;
+};
+
+inline Activity_Kernel Row_Activity::kernel() const
+{
+  return m_kernel;
+}
@@ -0,0 +1,266 @@
+/*=====================================================================================
+
+    Filename:     checkpoint.cpp
+
+    Description:  Checkpoint and resume of the dynamic search state
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "../../reader/Sol_Writer.h"
+#include "../Local_Search.h"
+#include "checkpoint.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+Checkpoint_Writer::Checkpoint_Writer(std::string& p_buffer)
+    : m_buffer(p_buffer)
+{
+}
+
+void Checkpoint_Writer::put_string(const std::string& p_value)
+{
+  put<uint64_t>(p_value.size());
+  put_bytes(p_value.data(), p_value.size());
+}
+
+void Checkpoint_Writer::put_bytes(const void* p_data, size_t p_size)
+{
+  m_buffer.append(static_cast<const char*>(p_data), p_size);
+}
+
+Checkpoint_Reader::Checkpoint_Reader(const std::string& p_buffer)
+    : m_buffer(p_buffer), m_offset(0)
+{
+}
+
+std::string Checkpoint_Reader::get_string()
+{
+  const uint64_t size = get<uint64_t>();
+  if (size > m_buffer.size() - m_offset)
+    throw Solver_Error("checkpoint file is truncated");
+  std::string value = m_buffer.substr(m_offset, size);
+  m_offset += size;
+  return value;
+}
+
+bool Checkpoint_Reader::at_end() const
+{
+  return m_offset == m_buffer.size();
+}
+
+void Checkpoint_Reader::get_bytes(void* p_data, size_t p_size)
+{
+  if (p_size > m_buffer.size() - m_offset)
+    throw Solver_Error("checkpoint file is truncated");
+  if (p_size != 0)
+    std::memcpy(p_data, m_buffer.data() + m_offset, p_size);
+  m_offset += p_size;
+}
+
+namespace
+{
+
+std::string read_file(const std::string& p_path)
+{
+  FILE* file = fopen(p_path.c_str(), "rb");
+  if (file == nullptr)
+    throw Solver_Error("cannot open checkpoint file " + p_path);
+  std::string content;
+  char chunk[1 << 16];
+  size_t read_size = 0;
+  while ((read_size = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    content.append(chunk, read_size);
+  const bool failed = ferror(file) != 0;
+  fclose(file);
+  if (failed)
+    throw Solver_Error("cannot read checkpoint file " + p_path);
+  return content;
+}
+
+} // namespace
+
+void Local_Search::encode_checkpoint(std::string& p_buffer) const
+{
+  p_buffer.clear();
+  Checkpoint_Writer writer(p_buffer);
+  for (char ch : k_checkpoint_magic)
+    writer.put(ch);
+  writer.put(k_checkpoint_version);
+  writer.put<uint64_t>(m_var_num);
+  writer.put<uint64_t>(m_con_num);
+  writer.put<uint64_t>(m_obj_var_num);
+
+  writer.put<uint64_t>(m_cur_step);
+  writer.put<uint64_t>(m_last_improve_step);
+  writer.put<uint64_t>(m_min_unsat_con);
+  writer.put<uint64_t>(m_activity_hits);
+  writer.put<uint64_t>(m_next_incumbent_sync_step);
+  writer.put(m_binary_op_stamp_token);
+  writer.put(m_best_obj);
+  writer.put<uint8_t>(m_is_found_feasible);
+  writer.put<uint8_t>(m_current_obj_breakthrough);
+  writer.put<uint8_t>(m_is_keep_feas);
+  writer.put<uint8_t>(m_strct_feas);
+  writer.put<uint8_t>(m_activity_dirty);
+
+  std::ostringstream rng_state;
+  rng_state << m_rng;
+  writer.put_string(rng_state.str());
+
+  writer.put_vector(m_var_current_value);
+  writer.put_vector(m_var_best_value);
+  writer.put_vector(m_var_allow_inc_step);
+  writer.put_vector(m_var_allow_dec_step);
+  writer.put_vector(m_var_last_inc_step);
+  writer.put_vector(m_var_last_dec_step);
+  writer.put_vector(m_var_LB_feas_delta);
+  writer.put_vector(m_var_UB_feas_delta);
+  writer.put_vector(m_var_lift_delta);
+  writer.put_vector(m_binary_op_stamp);
+  writer.put_vector(m_con_weight);
+  writer.put_vector(m_con_activity);
+  writer.put_vector(m_con_activity_tail);
+  writer.put_vector(m_con_constant);
+  writer.put_vector(m_con_unsat_idxs);
+  writer.put_vector(m_con_pos_in_unsat_idxs);
+
+  writer.put<uint64_t>(m_explore_neighbor_list.size());
+  for (const auto& neighbor : m_explore_neighbor_list)
+  {
+    writer.put_string(neighbor.name());
+    writer.put<uint8_t>(neighbor.is_user_defined());
+    writer.put<uint64_t>(neighbor.bms_con());
+    writer.put<uint64_t>(neighbor.bms_op());
+  }
+}
+
+// Called by run_search after init_data() has sized every array. Activities
+// and the unsat list are restored verbatim rather than recomputed, so the
+// resumed search sees exactly the floating-point state it was saved with;
+// the sat bitset is the complement of the unsat list.
+void Local_Search::decode_checkpoint(const std::string& p_buffer)
+{
+  Checkpoint_Reader reader(p_buffer);
+  for (char ch : k_checkpoint_magic)
+  {
+    if (reader.get<char>() != ch)
+      throw Solver_Error("not a Local-MIP checkpoint file");
+  }
+  if (reader.get<uint32_t>() != k_checkpoint_version)
+    throw Solver_Error("unsupported checkpoint version");
+  if (reader.get<uint64_t>() != m_var_num ||
+      reader.get<uint64_t>() != m_con_num ||
+      reader.get<uint64_t>() != m_obj_var_num)
+    throw Solver_Error("checkpoint does not match the prepared model");
+
+  m_cur_step = reader.get<uint64_t>();
+  m_last_improve_step = reader.get<uint64_t>();
+  m_min_unsat_con = reader.get<uint64_t>();
+  m_activity_hits = reader.get<uint64_t>();
+  m_next_incumbent_sync_step = reader.get<uint64_t>();
+  m_binary_op_stamp_token = reader.get<uint32_t>();
+  m_best_obj = reader.get<double>();
+  m_is_found_feasible = reader.get<uint8_t>() != 0;
+  m_current_obj_breakthrough = reader.get<uint8_t>() != 0;
+  m_is_keep_feas = reader.get<uint8_t>() != 0;
+  m_strct_feas = reader.get<uint8_t>() != 0;
+  m_activity_dirty = reader.get<uint8_t>() != 0;
+
+  std::istringstream rng_state(reader.get_string());
+  rng_state >> m_rng;
+  if (rng_state.fail())
+    throw Solver_Error("checkpoint has a corrupt random generator state");
+
+  reader.get_vector(m_var_current_value, "current values");
+  reader.get_vector(m_var_best_value, "best values");
+  reader.get_vector(m_var_allow_inc_step, "tabu increase steps");
+  reader.get_vector(m_var_allow_dec_step, "tabu decrease steps");
+  reader.get_vector(m_var_last_inc_step, "last increase steps");
+  reader.get_vector(m_var_last_dec_step, "last decrease steps");
+  reader.get_vector(m_var_LB_feas_delta, "lift lower deltas");
+  reader.get_vector(m_var_UB_feas_delta, "lift upper deltas");
+  reader.get_vector(m_var_lift_delta, "lift deltas");
+  reader.get_vector(m_binary_op_stamp, "binary operation stamps");
+  reader.get_vector(m_con_weight, "constraint weights");
+  reader.get_vector(m_con_activity, "constraint activities");
+  reader.get_vector(m_con_activity_tail, "activity compensations");
+  reader.get_vector(m_con_constant, "constraint constants");
+  reader.get_list(m_con_unsat_idxs, m_con_num, "unsat constraints");
+  reader.get_vector(m_con_pos_in_unsat_idxs, "unsat positions");
+  if (!con_lists_consistent())
+    throw Solver_Error("checkpoint has inconsistent constraint lists");
+  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+    m_con_is_sat[con_idx] = m_con_pos_in_unsat_idxs[con_idx] == k_null_idx;
+  m_con_sat_idxs_stale = true;
+
+  std::vector<Neighbor> neighbor_list;
+  const uint64_t neighbor_num = reader.get<uint64_t>();
+  for (uint64_t neighbor_idx = 0; neighbor_idx < neighbor_num;
+       ++neighbor_idx)
+  {
+    std::string name = reader.get_string();
+    const bool is_user_defined = reader.get<uint8_t>() != 0;
+    const size_t bms_con = reader.get<uint64_t>();
+    const size_t bms_op = reader.get<uint64_t>();
+    if (!is_user_defined)
+    {
+      neighbor_list.emplace_back(name, bms_con, bms_op);
+      continue;
+    }
+    // Callbacks cannot be saved; the user must register the same custom
+    // neighbors again, at the same positions.
+    if (neighbor_idx >= m_explore_neighbor_list.size() ||
+        !m_explore_neighbor_list[neighbor_idx].is_user_defined() ||
+        m_explore_neighbor_list[neighbor_idx].name() != name)
+    {
+      throw Solver_Error("checkpoint uses custom neighbor " + name +
+                         ", which is not registered at the same position");
+    }
+    neighbor_list.push_back(m_explore_neighbor_list[neighbor_idx]);
+  }
+  if (!reader.at_end())
+    throw Solver_Error("checkpoint file has trailing data");
+  m_explore_neighbor_list = std::move(neighbor_list);
+  if (m_use_score_cache)
+    m_score_cache.resize(m_var_num);
+}
+
+bool Local_Search::con_lists_consistent() const
+{
+  if (m_con_pos_in_unsat_idxs[0] != k_null_idx)
+    return false;
+  for (size_t pos = 0; pos < m_con_unsat_idxs.size(); ++pos)
+  {
+    const size_t con_idx = m_con_unsat_idxs[pos];
+    if (con_idx == 0 || con_idx >= m_con_num ||
+        m_con_pos_in_unsat_idxs[con_idx] != pos)
+      return false;
+  }
+  const size_t listed_num = static_cast<size_t>(
+      std::count_if(m_con_pos_in_unsat_idxs.begin(),
+                    m_con_pos_in_unsat_idxs.end(),
+                    [](Model_Idx p_pos) { return p_pos != k_null_idx; }));
+  return listed_num == m_con_unsat_idxs.size();
+}
+
+bool Local_Search::save_checkpoint(const std::string& p_path) const
+{
+  std::string buffer;
+  encode_checkpoint(buffer);
+  return Sol_Writer::write_atomically(p_path, buffer);
+}
+
+void Local_Search::load_checkpoint()
+{
+  decode_checkpoint(read_file(m_resume_path));
+  if (m_is_found_feasible)
+    report_best_solution();
+  printf("c search state is resumed from %s at step %zu\n",
+         m_resume_path.c_str(),
+         m_cur_step);
+}
@@ -0,0 +1,133 @@
+/*=====================================================================================
+
+    Filename:     checkpoint.h
+
+    Description:  Binary encoding of the search state for checkpoint files
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include "../../utils/solver_error.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Layout: k_checkpoint_magic, k_checkpoint_version, then the fields in the
+// order Local_Search::encode_checkpoint writes them. Values are stored in
+// the byte order of the host; a checkpoint is meant to be resumed by the
+// same binary on the same kind of machine.
+inline constexpr char k_checkpoint_magic[8] = {
+    'L', 'M', 'I', 'P', 'C', 'K', 'P', 'T'};
+
+inline constexpr uint32_t k_checkpoint_version = 3;
+
+class Checkpoint_Writer
+{
+public:
+  explicit Checkpoint_Writer(std::string& p_buffer);
+
+  template <typename T>
+  void put(const T& p_value);
+
+  template <typename T>
+  void put_vector(const std::vector<T>& p_values);
+
+  void put_string(const std::string& p_value);
+
+private:
+  std::string& m_buffer;
+
+  void put_bytes(const void* p_data, size_t p_size);
+};
+
+// Every read is bounds checked; a short or inconsistent file throws
+// Solver_Error instead of leaving the search half restored.
+class Checkpoint_Reader
+{
+public:
+  explicit Checkpoint_Reader(const std::string& p_buffer);
+
+  template <typename T>
+  T get();
+
+  // p_values keeps its size, which must match the stored one.
+  template <typename T>
+  void get_vector(std::vector<T>& p_values, const char* p_field);
+
+  // p_values takes the stored size, at most p_max_size.
+  template <typename T>
+  void
+  get_list(std::vector<T>& p_values, size_t p_max_size, const char* p_field);
+
+  std::string get_string();
+
+  bool at_end() const;
+
+private:
+  const std::string& m_buffer;
+
+  size_t m_offset;
+
+  void get_bytes(void* p_data, size_t p_size);
+};
+
+template <typename T>
+void Checkpoint_Writer::put(const T& p_value)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  put_bytes(&p_value, sizeof(T));
+}
+
+template <typename T>
+void Checkpoint_Writer::put_vector(const std::vector<T>& p_values)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  put<uint64_t>(p_values.size());
+  put_bytes(p_values.data(), p_values.size() * sizeof(T));
+}
+
+template <typename T>
+T Checkpoint_Reader::get()
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  T value;
+  get_bytes(&value, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void Checkpoint_Reader::get_vector(std::vector<T>& p_values,
+                                   const char* p_field)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  const uint64_t size = get<uint64_t>();
+  if (size != p_values.size())
+  {
+    throw Solver_Error(std::string("checkpoint ") + p_field + " has " +
+                       std::to_string(size) + " entries, expected " +
+                       std::to_string(p_values.size()));
+  }
+  get_bytes(p_values.data(), p_values.size() * sizeof(T));
+}
+
+template <typename T>
+void Checkpoint_Reader::get_list(std::vector<T>& p_values,
+                                 size_t p_max_size,
+                                 const char* p_field)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  const uint64_t size = get<uint64_t>();
+  if (size > p_max_size)
+  {
+    throw Solver_Error(std::string("checkpoint ") + p_field + " has " +
+                       std::to_string(size) + " entries, at most " +
+                       std::to_string(p_max_size) + " expected");
+  }
+  p_values.resize(size);
+  get_bytes(p_values.data(), p_values.size() * sizeof(T));
+}
@@ -19,6 +19,23 @@
 
 class Model_Manager;
 
+// Activities in [m_lower, m_upper] satisfy the row, decided exactly as the
+// tolerance test on the gap decides them. Only built when the activities
+// are certified exact integers, where the test reduces to two compares.
+struct Sat_Interval
+{
+  double m_lower;
+
+  double m_upper;
+
+  inline bool contains(double p_activity) const;
+};
+
+inline bool Sat_Interval::contains(double p_activity) const
+{
+  return m_lower <= p_activity && p_activity <= m_upper;
+}
+
 struct Readonly_Ctx
 {
   Readonly_Ctx(const Model_Manager& p_model_manager,
@@ -28,9 +45,9 @@ struct Readonly_Ctx
                const std::vector<double>& p_con_constant,
                const std::vector<bool>& p_con_is_equality,
                const std::vector<size_t>& p_con_weight,
-               const std::vector<size_t>& p_con_unsat_idxs,
-               const std::vector<size_t>& p_con_pos_in_unsat_idxs,
-               const std::vector<size_t>& p_con_sat_idxs,
+               const std::vector<Model_Idx>& p_con_unsat_idxs,
+               const std::vector<Model_Idx>& p_con_pos_in_unsat_idxs,
+               const std::vector<Model_Idx>& p_con_sat_idxs,
                const std::vector<size_t>& p_var_last_dec_step,
                const std::vector<size_t>& p_var_last_inc_step,
                const std::vector<size_t>& p_var_allow_inc_step,
@@ -42,8 +59,8 @@ struct Readonly_Ctx
                const size_t& p_cur_step,
                const size_t& p_last_improve_step,
                const bool& p_current_obj_breakthrough,
-               const std::vector<size_t>& p_binary_idx_list,
-               const std::vector<size_t>& p_non_fixed_var_idx_list,
+               const std::vector<Model_Idx>& p_binary_idx_list,
+               const std::vector<Model_Idx>& p_non_fixed_var_idx_list,
                double p_opt_tolerance = k_default_opt_tolerance);
 
   const Model_Manager& m_model_manager;
@@ -62,11 +79,13 @@ struct Readonly_Ctx
 
   const std::vector<size_t>& m_con_weight;
 
-  const std::vector<size_t>& m_con_unsat_idxs;
+  const std::vector<Model_Idx>& m_con_unsat_idxs;
 
-  const std::vector<size_t>& m_con_pos_in_unsat_idxs;
+  const std::vector<Model_Idx>& m_con_pos_in_unsat_idxs;
 
-  const std::vector<size_t>& m_con_sat_idxs;
+  // Materialized from the sat bitset before callbacks run; only kept up to
+  // date while a user callback is registered.
+  const std::vector<Model_Idx>& m_con_sat_idxs;
 
   const std::vector<size_t>& m_var_last_dec_step;
 
@@ -90,9 +109,17 @@ struct Readonly_Ctx
 
   const size_t& m_last_improve_step;
 
-  const std::vector<size_t>& m_binary_idx_list;
+  const std::vector<Model_Idx>& m_binary_idx_list;
+
+  const std::vector<Model_Idx>& m_non_fixed_var_idx_list;
+
+  // Indexed by constraint, except the objective row 0; null unless the
+  // activities are certified exact.
+  const Sat_Interval* m_con_sat_interval = nullptr;
 
-  const std::vector<size_t>& m_non_fixed_var_idx_list;
+  // Indexed by constraint, the objective row 0 excluded; null in contexts
+  // built outside Local_Search, which provide m_con_sat_idxs instead.
+  const std::vector<bool>* m_con_is_sat = nullptr;
 };
 
 inline Readonly_Ctx::Readonly_Ctx(
@@ -103,9 +130,9 @@ inline Readonly_Ctx::Readonly_Ctx(
     const std::vector<double>& p_con_constant,
     const std::vector<bool>& p_con_is_equality,
     const std::vector<size_t>& p_con_weight,
-    const std::vector<size_t>& p_con_unsat_idxs,
-    const std::vector<size_t>& p_con_pos_in_unsat_idxs,
-    const std::vector<size_t>& p_con_sat_idxs,
+    const std::vector<Model_Idx>& p_con_unsat_idxs,
+    const std::vector<Model_Idx>& p_con_pos_in_unsat_idxs,
+    const std::vector<Model_Idx>& p_con_sat_idxs,
     const std::vector<size_t>& p_var_last_dec_step,
     const std::vector<size_t>& p_var_last_inc_step,
     const std::vector<size_t>& p_var_allow_inc_step,
@@ -117,8 +144,8 @@ inline Readonly_Ctx::Readonly_Ctx(
     const size_t& p_cur_step,
     const size_t& p_last_improve_step,
     const bool& p_current_obj_breakthrough,
-    const std::vector<size_t>& p_binary_idx_list,
-    const std::vector<size_t>& p_non_fixed_var_idx_list,
+    const std::vector<Model_Idx>& p_binary_idx_list,
+    const std::vector<Model_Idx>& p_non_fixed_var_idx_list,
     double p_opt_tolerance)
     : m_model_manager(p_model_manager), m_opt_tolerance(p_opt_tolerance),
       m_var_current_value(p_var_current_value),
@@ -0,0 +1,38 @@
+/*=====================================================================================
+
+    Filename:     incumbent_snapshot.cpp
+
+    Description:  Improvement callback context and buffered copy of the
+                  incumbent for a consumer thread
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "incumbent_snapshot.h"
+
+Incumbent_Snapshot::Incumbent_Snapshot()
+    : m_slots(), m_middle(1), m_back(2), m_front(0), m_sequence(0)
+{
+}
+
+void Incumbent_Snapshot::publish(std::span<const double> p_values,
+                                 double p_obj,
+                                 size_t p_step)
+{
+  Slot& slot = m_slots[m_back];
+  slot.m_values.assign(p_values.begin(), p_values.end());
+  slot.m_obj = p_obj;
+  slot.m_step = p_step;
+  slot.m_sequence = ++m_sequence;
+  m_back = m_middle.exchange(m_back | k_fresh, std::memory_order_acq_rel) &
+           k_slot_mask;
+}
+
+bool Incumbent_Snapshot::acquire()
+{
+  if ((m_middle.load(std::memory_order_relaxed) & k_fresh) == 0)
+    return false;
+  m_front =
+      m_middle.exchange(m_front, std::memory_order_acq_rel) & k_slot_mask;
+  return true;
+}
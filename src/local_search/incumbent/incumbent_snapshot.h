@@ -0,0 +1,97 @@
+/*=====================================================================================
+
+    Filename:     incumbent_snapshot.h
+
+    Description:  Improvement callback context and buffered copy of the
+                  incumbent for a consumer thread
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+// Passed to the improvement callback from the search thread that found a
+// better solution. The values are the search's own best-solution buffer,
+// in the columns of the search model, and are only valid during the call.
+struct Improvement_Ctx
+{
+  std::span<const double> m_values;
+
+  // Objective in the original direction, with offset.
+  double m_obj;
+
+  size_t m_step;
+};
+
+using Improvement_Cbk = std::function<void(const Improvement_Ctx&, void*)>;
+
+// Hands improving solutions from the search to one consumer thread. The
+// search fills a back buffer while the consumer reads the front one, so
+// neither waits for the other. A third slot holds the newest complete
+// incumbent between them: publish() swaps the filled back buffer into it
+// and acquire() swaps it out to the front. The consumer always gets the
+// newest incumbent; older ones it did not pick up are overwritten.
+// Values are in the columns of the search model; Model_Manager::
+// postsolve_values() maps a copy back to the original variables.
+class Incumbent_Snapshot
+{
+public:
+  struct Slot
+  {
+    std::vector<double> m_values;
+
+    // Objective in the original direction, with offset.
+    double m_obj = 0.0;
+
+    size_t m_step = 0;
+
+    // 1 for the first published incumbent, then increasing.
+    uint64_t m_sequence = 0;
+  };
+
+  Incumbent_Snapshot();
+
+  Incumbent_Snapshot(const Incumbent_Snapshot&) = delete;
+
+  Incumbent_Snapshot& operator=(const Incumbent_Snapshot&) = delete;
+
+  // Writer side; one thread at a time.
+  void publish(std::span<const double> p_values, double p_obj, size_t p_step);
+
+  // Reader side: moves the newest incumbent to the front. Returns false
+  // when nothing was published since the previous call.
+  bool acquire();
+
+  // Valid until the next acquire().
+  inline const Slot& front() const;
+
+private:
+  static constexpr uint8_t k_slot_mask = 3;
+
+  static constexpr uint8_t k_fresh = 4;
+
+  std::array<Slot, 3> m_slots;
+
+  // Index of the shared slot, with k_fresh set while it holds an incumbent
+  // the reader has not taken yet.
+  std::atomic<uint8_t> m_middle;
+
+  uint8_t m_back;
+
+  uint8_t m_front;
+
+  uint64_t m_sequence;
+};
+
+inline const Incumbent_Snapshot::Slot& Incumbent_Snapshot::front() const
+{
+  return m_slots[m_front];
+}
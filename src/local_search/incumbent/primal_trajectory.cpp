@@ -0,0 +1,154 @@
+/*=====================================================================================
+
+    Filename:     primal_trajectory.cpp
+
+    Description:  Incumbent trajectory with primal integral and
+                  time-to-target metrics
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "../../utils/global_defs.h"
+#include "primal_trajectory.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+constexpr double k_nan = std::numeric_limits<double>::quiet_NaN();
+
+void write_number(FILE* p_file, const char* p_format, double p_value)
+{
+  if (std::isfinite(p_value))
+    fprintf(p_file, p_format, p_value);
+  else
+    fprintf(p_file, "null");
+}
+
+} // namespace
+
+Primal_Trajectory::Primal_Trajectory()
+    : m_is_min(1), m_has_reference(false), m_reference(k_nan),
+      m_integral(k_nan), m_last_seconds(0.0), m_last_gap(1.0),
+      m_end_seconds(k_nan), m_target_gaps{0.1, 0.01, 0.001, 0.0},
+      m_target_seconds(m_target_gaps.size(), k_nan),
+      m_reached_target_num(0), m_dropped_events(0)
+{
+}
+
+void Primal_Trajectory::reset(int p_is_min, double p_reference)
+{
+  m_is_min = p_is_min;
+  m_has_reference = std::fabs(p_reference) < k_inf;
+  m_reference = m_has_reference ? p_reference : k_nan;
+  m_points.clear();
+  m_integral = m_has_reference ? 0.0 : k_nan;
+  m_last_seconds = 0.0;
+  m_last_gap = 1.0;
+  m_end_seconds = k_nan;
+  std::fill(m_target_seconds.begin(), m_target_seconds.end(), k_nan);
+  m_reached_target_num = 0;
+  m_dropped_events = 0;
+}
+
+bool Primal_Trajectory::record(double p_seconds, size_t p_step, double p_obj)
+{
+  if (std::isnan(p_obj))
+    return false;
+  if (!m_points.empty())
+  {
+    if (m_is_min * p_obj >= m_is_min * m_points.back().m_obj)
+      return false;
+    // Events of different workers may be drained slightly out of order.
+    p_seconds = std::max(p_seconds, m_points.back().m_seconds);
+  }
+  m_points.push_back({p_seconds, p_step, p_obj});
+  if (m_has_reference)
+    accumulate(p_seconds, p_obj);
+  return true;
+}
+
+void Primal_Trajectory::finish(double p_end_seconds)
+{
+  if (!m_points.empty())
+    p_end_seconds = std::max(p_end_seconds, m_points.back().m_seconds);
+  m_end_seconds = p_end_seconds;
+  if (!m_has_reference)
+  {
+    m_reference = m_points.empty() ? k_nan : m_points.back().m_obj;
+    m_integral = 0.0;
+    m_last_seconds = 0.0;
+    m_last_gap = 1.0;
+    for (const auto& point : m_points)
+      accumulate(point.m_seconds, point.m_obj);
+  }
+  m_integral += m_last_gap * (p_end_seconds - m_last_seconds);
+  m_last_seconds = p_end_seconds;
+}
+
+void Primal_Trajectory::set_dropped_events(size_t p_dropped_events)
+{
+  m_dropped_events = p_dropped_events;
+}
+
+void Primal_Trajectory::accumulate(double p_seconds, double p_obj)
+{
+  m_integral += m_last_gap * (p_seconds - m_last_seconds);
+  m_last_seconds = p_seconds;
+  m_last_gap = primal_gap(p_obj, m_reference);
+  while (m_reached_target_num < m_target_gaps.size() &&
+         m_last_gap <= m_target_gaps[m_reached_target_num])
+    m_target_seconds[m_reached_target_num++] = p_seconds;
+}
+
+double Primal_Trajectory::primal_gap(double p_obj, double p_reference)
+{
+  if (std::isnan(p_obj) || std::isnan(p_reference))
+    return 1.0;
+  if (std::fabs(p_obj - p_reference) <= 1e-9)
+    return 0.0;
+  if (p_obj * p_reference < 0.0)
+    return 1.0;
+  return std::fabs(p_obj - p_reference) /
+         std::max(std::fabs(p_obj), std::fabs(p_reference));
+}
+
+void Primal_Trajectory::write_json(FILE* p_file) const
+{
+  fprintf(p_file, "{\n  \"is_min\": %d,\n  \"reference\": ", m_is_min);
+  write_number(p_file, "%.17g", m_reference);
+  fprintf(p_file,
+          ",\n  \"reference_given\": %s,\n  \"end_seconds\": ",
+          m_has_reference ? "true" : "false");
+  write_number(p_file, "%.6f", m_end_seconds);
+  fprintf(p_file, ",\n  \"primal_integral\": ");
+  write_number(p_file, "%.9g", m_integral);
+  fprintf(p_file,
+          ",\n  \"dropped_events\": %zu,\n  \"time_to_target\": [",
+          m_dropped_events);
+  for (size_t target_idx = 0; target_idx < m_target_gaps.size();
+       ++target_idx)
+  {
+    fprintf(p_file,
+            "%s\n    {\"gap\": %g, \"seconds\": ",
+            target_idx == 0 ? "" : ",",
+            m_target_gaps[target_idx]);
+    write_number(p_file, "%.6f", m_target_seconds[target_idx]);
+    fprintf(p_file, "}");
+  }
+  fprintf(p_file, "\n  ],\n  \"points\": [");
+  for (size_t point_idx = 0; point_idx < m_points.size(); ++point_idx)
+  {
+    const auto& point = m_points[point_idx];
+    fprintf(p_file,
+            "%s\n    {\"seconds\": %.6f, \"step\": %zu, \"obj\": ",
+            point_idx == 0 ? "" : ",",
+            point.m_seconds,
+            point.m_step);
+    write_number(p_file, "%.17g", point.m_obj);
+    fprintf(p_file, "}");
+  }
+  fprintf(p_file, "\n  ]\n}\n");
+}
@@ -0,0 +1,137 @@
+/*=====================================================================================
+
+    Filename:     primal_trajectory.h
+
+    Description:  Incumbent trajectory with primal integral and
+                  time-to-target metrics
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+// Pushed by a search whenever its best solution improves. The objective is
+// in the original direction and includes the offset.
+struct Improvement_Event
+{
+  std::chrono::steady_clock::time_point m_time;
+
+  size_t m_step;
+
+  double m_obj;
+};
+
+struct Trajectory_Point
+{
+  double m_seconds;
+
+  size_t m_step;
+
+  double m_obj;
+};
+
+// Anytime performance of one run. Points are kept only when they improve
+// on the best objective so far. With a reference objective the primal
+// integral and the time to reach each target gap are updated online as
+// points arrive; without one they are computed against the best objective
+// of the run when finish() is called. Gaps follow Berthold's relative
+// primal gap.
+class Primal_Trajectory
+{
+public:
+  Primal_Trajectory();
+
+  // A NaN reference or one at k_inf in magnitude selects the best
+  // objective of the run.
+  void reset(int p_is_min, double p_reference);
+
+  // Returns true when p_obj improves on the best objective so far.
+  bool record(double p_seconds, size_t p_step, double p_obj);
+
+  // Closes the integral at p_end_seconds; no point may follow.
+  void finish(double p_end_seconds);
+
+  void set_dropped_events(size_t p_dropped_events);
+
+  inline const std::vector<Trajectory_Point>& points() const;
+
+  inline double reference() const;
+
+  // NaN until finish() when no reference was given.
+  inline double primal_integral() const;
+
+  // Target gaps in decreasing order: 10%, 1%, 0.1% and 0.
+  inline const std::vector<double>& target_gaps() const;
+
+  // Seconds until the best objective was within the target gap, NaN if
+  // never.
+  inline double time_to_target(size_t p_target_idx) const;
+
+  inline size_t reached_target_num() const;
+
+  void write_json(FILE* p_file) const;
+
+  static double primal_gap(double p_obj, double p_reference);
+
+private:
+  int m_is_min;
+
+  bool m_has_reference;
+
+  double m_reference;
+
+  std::vector<Trajectory_Point> m_points;
+
+  double m_integral;
+
+  double m_last_seconds;
+
+  double m_last_gap;
+
+  double m_end_seconds;
+
+  std::vector<double> m_target_gaps;
+
+  std::vector<double> m_target_seconds;
+
+  size_t m_reached_target_num;
+
+  size_t m_dropped_events;
+
+  void accumulate(double p_seconds, double p_obj);
+};
+
+inline const std::vector<Trajectory_Point>& Primal_Trajectory::points() const
+{
+  return m_points;
+}
+
+inline double Primal_Trajectory::reference() const
+{
+  return m_reference;
+}
+
+inline double Primal_Trajectory::primal_integral() const
+{
+  return m_integral;
+}
+
+inline const std::vector<double>& Primal_Trajectory::target_gaps() const
+{
+  return m_target_gaps;
+}
+
+inline double Primal_Trajectory::time_to_target(size_t p_target_idx) const
+{
+  return m_target_seconds[p_target_idx];
+}
+
+inline size_t Primal_Trajectory::reached_target_num() const
+{
+  return m_reached_target_num;
+}
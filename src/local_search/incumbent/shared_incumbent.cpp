@@ -0,0 +1,64 @@
+/*=====================================================================================
+
+    Filename:     shared_incumbent.cpp
+
+    Description:  Best solution slot shared by concurrent local searches
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "shared_incumbent.h"
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+Shared_Incumbent::Shared_Incumbent()
+    : m_best_obj(k_inf), m_cutoff(-std::numeric_limits<double>::infinity()),
+      m_stop(false), m_snapshot(nullptr)
+{
+}
+
+void Shared_Incumbent::set_cutoff(double p_obj) noexcept
+{
+  m_cutoff.store(p_obj, std::memory_order_relaxed);
+  if (best_obj() <= p_obj)
+    request_stop();
+}
+
+bool Shared_Incumbent::publish(double p_obj,
+                               const std::vector<double>& p_values)
+{
+  if (!(p_obj < best_obj()))
+    return false;
+  auto desired = std::make_shared<const Snapshot>(Snapshot{p_obj, p_values});
+  auto expected = m_snapshot.load(std::memory_order_acquire);
+  while (expected == nullptr || p_obj < expected->m_obj)
+  {
+    if (m_snapshot.compare_exchange_weak(expected,
+                                         desired,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire))
+    {
+      double current = m_best_obj.load(std::memory_order_relaxed);
+      while (p_obj < current &&
+             !m_best_obj.compare_exchange_weak(current,
+                                               p_obj,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed))
+      {
+      }
+      if (p_obj <= cutoff())
+        request_stop();
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<const Shared_Incumbent::Snapshot>
+Shared_Incumbent::snapshot() const
+{
+  return m_snapshot.load(std::memory_order_acquire);
+}
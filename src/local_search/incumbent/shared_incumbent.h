@@ -0,0 +1,91 @@
+/*=====================================================================================
+
+    Filename:     shared_incumbent.h
+
+    Description:  Best solution slot shared by concurrent local searches
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include "../../utils/global_defs.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Objectives are kept in the internal minimization space of Model_Manager
+// (the activity of constraint 0, without offset or sense). The objective is
+// a plain atomic so the per-step reads stay cheap; the solution itself is an
+// immutable snapshot swapped in with compare-and-exchange, so a worse
+// solution never replaces a better one. The snapshot slot is mutex-free at
+// the call site but not lock-free: libstdc++ guards
+// std::atomic<std::shared_ptr> with an internal lock, held only for the
+// pointer swap, never while a solution is copied. Workers read it only when
+// they restart and when the run ends.
+class Shared_Incumbent
+{
+public:
+  struct Snapshot
+  {
+    double m_obj;
+
+    std::vector<double> m_values;
+  };
+
+  Shared_Incumbent();
+
+  Shared_Incumbent(const Shared_Incumbent&) = delete;
+
+  Shared_Incumbent& operator=(const Shared_Incumbent&) = delete;
+
+  void set_cutoff(double p_obj) noexcept;
+
+  inline double cutoff() const noexcept;
+
+  inline double best_obj() const noexcept;
+
+  inline bool has_solution() const noexcept;
+
+  bool publish(double p_obj, const std::vector<double>& p_values);
+
+  std::shared_ptr<const Snapshot> snapshot() const;
+
+  inline void request_stop() noexcept;
+
+  inline bool stop_requested() const noexcept;
+
+private:
+  std::atomic<double> m_best_obj;
+
+  std::atomic<double> m_cutoff;
+
+  std::atomic<bool> m_stop;
+
+  std::atomic<std::shared_ptr<const Snapshot>> m_snapshot;
+};
+
+inline double Shared_Incumbent::cutoff() const noexcept
+{
+  return m_cutoff.load(std::memory_order_relaxed);
+}
+
+inline double Shared_Incumbent::best_obj() const noexcept
+{
+  return m_best_obj.load(std::memory_order_acquire);
+}
+
+inline bool Shared_Incumbent::has_solution() const noexcept
+{
+  return best_obj() < k_inf;
+}
+
+inline void Shared_Incumbent::request_stop() noexcept
+{
+  m_stop.store(true, std::memory_order_relaxed);
+}
+
+inline bool Shared_Incumbent::stop_requested() const noexcept
+{
+  return m_stop.load(std::memory_order_relaxed);
+}
@@ -54,13 +54,11 @@ bool Local_Search::lift_move()
           lift_move_operation(obj_term_idx, m_best_var_idx);
     m_is_keep_feas = true;
     m_feas_touch_vars.clear();
-    auto& best_model_var = m_model_manager->var(m_best_var_idx);
-    for (auto con_idx : best_model_var.con_idx_set())
+    for (const auto& term : m_matrix->col(m_best_var_idx))
     {
-      if (con_idx == 0)
+      if (term.con_idx == 0)
         continue;
-      auto& model_con = m_model_manager->con(con_idx);
-      for (auto var_idx : model_con.var_idx_set())
+      for (auto var_idx : m_matrix->row_var_idxs(term.con_idx))
         m_feas_touch_vars.insert(var_idx);
     }
     for (auto var_idx : m_feas_touch_vars)
@@ -111,13 +109,10 @@ double Local_Search::lift_move_operation(size_t p_term_idx,
       model_var.lower_bound() - m_var_current_value[p_var_idx];
   m_var_UB_feas_delta[p_term_idx] =
       model_var.upper_bound() - m_var_current_value[p_var_idx];
-  for (size_t var_term_idx = 0; var_term_idx < model_var.term_num();
-       ++var_term_idx)
+  for (const auto& term : m_matrix->col(p_var_idx))
   {
-    size_t con_idx = model_var.con_idx(var_term_idx);
-    auto& model_con = m_model_manager->con(con_idx);
-    size_t pos_in_con = model_var.pos_in_con(var_term_idx);
-    double coeff = model_con.coeff(pos_in_con);
+    const size_t con_idx = term.con_idx;
+    const double coeff = term.coeff;
     if (is_effectively_zero(coeff, m_model_manager->zero_tolerance()))
       continue;
     if (con_idx == 0)
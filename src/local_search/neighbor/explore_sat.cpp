@@ -24,11 +24,23 @@ void Neighbor::explore_sat_mtm(Neighbor_Ctx& p_ctx)
       !p_ctx.m_shared.m_is_found_feasible || m_bms_con == 0 ||
       m_bms_op == 0)
     return;
-  if (p_ctx.m_shared.m_con_sat_idxs.size() > 0)
+  const std::vector<bool>* con_is_sat = p_ctx.m_shared.m_con_is_sat;
+  const size_t sat_num =
+      con_is_sat != nullptr
+          ? p_ctx.m_shared.m_model_manager.con_num() - 1 -
+                p_ctx.m_shared.m_con_unsat_idxs.size()
+          : p_ctx.m_shared.m_con_sat_idxs.size();
+  if (sat_num > 0)
   {
     size_t neighbor_size = 0;
-    auto& neighbor_con_idxs = sample_idxs(
-        p_ctx.m_shared.m_con_sat_idxs, m_bms_con, neighbor_size, p_ctx);
+    auto& neighbor_con_idxs =
+        con_is_sat != nullptr
+            ? sample_sat_idxs(
+                  *con_is_sat, sat_num, m_bms_con, neighbor_size, p_ctx)
+            : sample_idxs(p_ctx.m_shared.m_con_sat_idxs,
+                          m_bms_con,
+                          neighbor_size,
+                          p_ctx);
     for (size_t neighbor_idx = 0; neighbor_idx < neighbor_size;
          ++neighbor_idx)
     {
@@ -37,10 +49,11 @@ void Neighbor::explore_sat_mtm(Neighbor_Ctx& p_ctx)
       if (p_ctx.m_shared.m_con_is_equality[con_idx] ||
           model_con.is_inferred_sat())
         continue;
-      for (size_t term_idx = 0; term_idx < model_con.term_num();
-           ++term_idx)
+      const auto var_idxs =
+          p_ctx.m_shared.m_model_manager.matrix().row_var_idxs(con_idx);
+      for (size_t term_idx = 0; term_idx < var_idxs.size(); ++term_idx)
       {
-        size_t var_idx = model_con.var_idx(term_idx);
+        size_t var_idx = var_idxs[term_idx];
         double delta = inequality_mixed_tight_operation(
             con_idx, term_idx, var_idx, p_ctx);
         if (tabu(p_ctx, var_idx, delta))
@@ -31,11 +31,11 @@ void Neighbor::explore_unsat_mtm_bm(Neighbor_Ctx& p_ctx)
          ++neighbor_idx)
     {
       size_t con_idx = neighbor_con_idxs.at(neighbor_idx);
-      auto& model_con = p_ctx.m_shared.m_model_manager.con(con_idx);
-      for (size_t term_idx = 0; term_idx < model_con.term_num();
-           ++term_idx)
+      const auto var_idxs =
+          p_ctx.m_shared.m_model_manager.matrix().row_var_idxs(con_idx);
+      for (size_t term_idx = 0; term_idx < var_idxs.size(); ++term_idx)
       {
-        size_t var_idx = model_con.var_idx(term_idx);
+        size_t var_idx = var_idxs[term_idx];
         double delta;
         if (p_ctx.m_shared.m_con_is_equality[con_idx])
           delta = equality_mixed_tight_operation(
@@ -27,10 +27,11 @@ void Neighbor::explore_unsat_random_bm(Neighbor_Ctx& p_ctx)
     std::uniform_int_distribution<size_t> dist(
         0, p_ctx.m_shared.m_con_unsat_idxs.size() - 1);
     size_t con_idx = p_ctx.m_shared.m_con_unsat_idxs[dist(p_ctx.m_rng)];
-    auto& model_con = p_ctx.m_shared.m_model_manager.con(con_idx);
-    for (size_t term_idx = 0; term_idx < model_con.term_num(); ++term_idx)
+    const auto var_idxs =
+        p_ctx.m_shared.m_model_manager.matrix().row_var_idxs(con_idx);
+    for (size_t term_idx = 0; term_idx < var_idxs.size(); ++term_idx)
     {
-      size_t var_idx = model_con.var_idx(term_idx);
+      size_t var_idx = var_idxs[term_idx];
       double delta;
       if (p_ctx.m_shared.m_con_is_equality[con_idx])
         delta = equality_mixed_tight_operation(
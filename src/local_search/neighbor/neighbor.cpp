@@ -64,8 +64,8 @@ void Neighbor::Neighbor_Ctx::append_op(size_t p_var_idx, double p_delta)
 Neighbor::Neighbor(const std::string& p_neighbor_name,
                    size_t p_bms_con,
                    size_t p_bms_op)
-    : m_neighbor_cbk(nullptr), m_user_data(nullptr), m_bms_con(p_bms_con),
-      m_bms_op(p_bms_op)
+    : m_name(p_neighbor_name), m_neighbor_cbk(nullptr), m_user_data(nullptr),
+      m_bms_con(p_bms_con), m_bms_op(p_bms_op)
 {
   std::string method = p_neighbor_name;
   std::transform(method.begin(),
@@ -94,11 +94,10 @@ Neighbor::Neighbor(const std::string& p_neighbor_name,
 Neighbor::Neighbor(const std::string& p_neighbor_name,
                    Neighbor_Cbk p_neighbor_cbk,
                    void* p_user_data)
-    : m_strategy(Strategy::user_defined),
+    : m_name(p_neighbor_name), m_strategy(Strategy::user_defined),
       m_neighbor_cbk(std::move(p_neighbor_cbk)), m_user_data(p_user_data),
       m_bms_con(0), m_bms_op(0)
 {
-  (void)p_neighbor_name;
 }
 
 void Neighbor::set_cbk(Neighbor_Cbk p_neighbor_cbk, void* p_user_data)
@@ -173,11 +172,11 @@ double Neighbor::inequality_mixed_tight_operation(size_t p_con_idx,
                                                   size_t p_var_idx,
                                                   Neighbor_Ctx& p_ctx)
 {
-  auto& model_con = p_ctx.m_shared.m_model_manager.con(p_con_idx);
   auto& model_var = p_ctx.m_shared.m_model_manager.var(p_var_idx);
   double gap = p_ctx.m_shared.m_con_activity[p_con_idx] -
                p_ctx.m_shared.m_con_constant[p_con_idx];
-  double coeff = model_con.coeff(p_term_idx);
+  double coeff = p_ctx.m_shared.m_model_manager.matrix().row_coeffs(
+      p_con_idx)[p_term_idx];
   if (is_effectively_zero(coeff,
                           p_ctx.m_shared.m_model_manager.zero_tolerance()))
     return 0;
@@ -193,7 +192,7 @@ double Neighbor::inequality_mixed_tight_operation(size_t p_con_idx,
           model_var,
           p_ctx.m_shared.m_var_current_value[p_var_idx] + delta))
   {
-    if (p_ctx.m_shared.m_con_pos_in_unsat_idxs[p_con_idx] != SIZE_MAX)
+    if (p_ctx.m_shared.m_con_pos_in_unsat_idxs[p_con_idx] != k_null_idx)
     {
       if (coeff > 0)
         delta = model_var.lower_bound() -
@@ -220,11 +219,11 @@ double Neighbor::equality_mixed_tight_operation(size_t p_con_idx,
                                                 size_t p_var_idx,
                                                 Neighbor_Ctx& p_ctx)
 {
-  auto& model_con = p_ctx.m_shared.m_model_manager.con(p_con_idx);
   auto& model_var = p_ctx.m_shared.m_model_manager.var(p_var_idx);
   double gap = p_ctx.m_shared.m_con_activity[p_con_idx] -
                p_ctx.m_shared.m_con_constant[p_con_idx];
-  double coeff = model_con.coeff(p_term_idx);
+  double coeff = p_ctx.m_shared.m_model_manager.matrix().row_coeffs(
+      p_con_idx)[p_term_idx];
   if (is_effectively_zero(coeff,
                           p_ctx.m_shared.m_model_manager.zero_tolerance()))
     return 0;
@@ -15,6 +15,7 @@
 
 #include "../../model_data/Model_Manager.h"
 #include "../context/context.h"
+#include <algorithm>
 #include <functional>
 #include <random>
 #include <string>
@@ -70,6 +71,12 @@ public:
 
   inline bool is_user_defined() const;
 
+  inline const std::string& name() const;
+
+  inline size_t bms_con() const;
+
+  inline size_t bms_op() const;
+
 private:
   enum class Strategy
   {
@@ -81,6 +88,8 @@ private:
     user_defined,
   };
 
+  std::string m_name;
+
   Strategy m_strategy;
 
   Neighbor_Cbk m_neighbor_cbk;
@@ -91,7 +100,7 @@ private:
 
   size_t m_bms_op;
 
-  std::vector<size_t> m_bms_idxs;
+  std::vector<Model_Idx> m_bms_idxs;
 
   std::unordered_map<size_t, size_t> m_remap;
 
@@ -105,12 +114,19 @@ private:
 
   void explore_unsat_random_bm(Neighbor_Ctx& p_ctx);
 
-  inline const std::vector<size_t>&
-  sample_idxs(const std::vector<size_t>& p_source_idxs,
+  inline const std::vector<Model_Idx>&
+  sample_idxs(const std::vector<Model_Idx>& p_source_idxs,
               size_t p_max_sample,
               size_t& p_final_size,
               Neighbor_Ctx& p_ctx);
 
+  inline const std::vector<Model_Idx>&
+  sample_sat_idxs(const std::vector<bool>& p_con_is_sat,
+                  size_t p_sat_num,
+                  size_t p_max_sample,
+                  size_t& p_final_size,
+                  Neighbor_Ctx& p_ctx);
+
   static double inequality_mixed_tight_operation(size_t p_con_idx,
                                                  size_t p_term_idx,
                                                  size_t p_var_idx,
@@ -141,6 +157,21 @@ inline bool Neighbor::is_user_defined() const
   return m_strategy == Strategy::user_defined;
 }
 
+inline const std::string& Neighbor::name() const
+{
+  return m_name;
+}
+
+inline size_t Neighbor::bms_con() const
+{
+  return m_bms_con;
+}
+
+inline size_t Neighbor::bms_op() const
+{
+  return m_bms_op;
+}
+
 inline size_t Neighbor::sample_op(size_t p_max_ops,
                                   std::vector<size_t>& p_op_var_idxs,
                                   std::vector<double>& p_op_var_deltas,
@@ -162,8 +193,8 @@ inline size_t Neighbor::sample_op(size_t p_max_ops,
   return p_max_ops;
 }
 
-inline const std::vector<size_t>&
-Neighbor::sample_idxs(const std::vector<size_t>& p_source_idxs,
+inline const std::vector<Model_Idx>&
+Neighbor::sample_idxs(const std::vector<Model_Idx>& p_source_idxs,
                       size_t p_max_sample,
                       size_t& p_final_size,
                       Neighbor_Ctx& p_ctx)
@@ -195,6 +226,51 @@ Neighbor::sample_idxs(const std::vector<size_t>& p_source_idxs,
   return m_bms_idxs;
 }
 
+// Samples up to p_max_sample distinct rows with their bit set. While sat
+// rows are at least a quarter of the constraints and twice the sample, a
+// uniform draw over all rows is rejected until it hits an unsampled sat row,
+// which takes at most 8 draws per sample on average; sparser bitsets are
+// scanned once and partially shuffled.
+inline const std::vector<Model_Idx>&
+Neighbor::sample_sat_idxs(const std::vector<bool>& p_con_is_sat,
+                          size_t p_sat_num,
+                          size_t p_max_sample,
+                          size_t& p_final_size,
+                          Neighbor_Ctx& p_ctx)
+{
+  m_bms_idxs.clear();
+  const size_t row_num = p_con_is_sat.size() - 1;
+  if (p_sat_num / 2 >= p_max_sample && p_sat_num >= row_num / 4)
+  {
+    std::uniform_int_distribution<size_t> dist(1, row_num);
+    while (m_bms_idxs.size() < p_max_sample)
+    {
+      const Model_Idx con_idx = static_cast<Model_Idx>(dist(p_ctx.m_rng));
+      if (p_con_is_sat[con_idx] &&
+          std::find(m_bms_idxs.begin(), m_bms_idxs.end(), con_idx) ==
+              m_bms_idxs.end())
+        m_bms_idxs.push_back(con_idx);
+    }
+    p_final_size = p_max_sample;
+    return m_bms_idxs;
+  }
+  for (size_t con_idx = 1; con_idx <= row_num; ++con_idx)
+  {
+    if (p_con_is_sat[con_idx])
+      m_bms_idxs.push_back(static_cast<Model_Idx>(con_idx));
+  }
+  p_final_size = m_bms_idxs.size();
+  if (p_final_size <= p_max_sample)
+    return m_bms_idxs;
+  for (size_t base_idx = 0; base_idx < p_max_sample; ++base_idx)
+  {
+    std::uniform_int_distribution<size_t> dist(base_idx, p_final_size - 1);
+    std::swap(m_bms_idxs[dist(p_ctx.m_rng)], m_bms_idxs[base_idx]);
+  }
+  p_final_size = p_max_sample;
+  return m_bms_idxs;
+}
+
 inline bool
 Neighbor::tabu(Neighbor_Ctx& p_ctx, size_t p_var_idx, double p_delta)
 {
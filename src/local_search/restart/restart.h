@@ -56,6 +56,8 @@ public:
 
   bool execute(Restart_Ctx& p_ctx) const;
 
+  inline bool should_restart(const Restart_Ctx& p_ctx) const;
+
   inline bool has_user_callback() const;
 
 private:
@@ -74,8 +76,6 @@ private:
 
   size_t m_restart_step;
 
-  inline bool should_restart(Restart_Ctx& p_ctx) const;
-
   void reset_weights(Restart_Ctx& p_ctx) const;
 
   void random_restart(Restart_Ctx& p_ctx) const;
@@ -88,7 +88,7 @@ private:
                              const Model_Var& p_model_var) const;
 };
 
-inline bool Restart::should_restart(Restart_Ctx& p_ctx) const
+inline bool Restart::should_restart(const Restart_Ctx& p_ctx) const
 {
   if (m_restart_step == 0)
     return false;
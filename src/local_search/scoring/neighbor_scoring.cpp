@@ -16,6 +16,7 @@
 #include "../../model_data/Model_Var.h"
 #include "../../utils/global_defs.h"
 #include "../context/context.h"
+#include "score_cache.h"
 #include "scoring.h"
 #include <algorithm>
 #include <cctype>
@@ -27,6 +28,150 @@
 #include <utility>
 #include <vector>
 
+namespace
+{
+
+// Objective row contribution once a feasible solution is known. It depends
+// on the incumbent bound, so it is never cached.
+long objective_progress(const Readonly_Ctx& p_shared,
+                        double p_coeff,
+                        double p_delta,
+                        long& p_bonus_score)
+{
+  const long con_weight = static_cast<long>(p_shared.m_con_weight[0]);
+  const long scaled_con_weight = con_weight * 2;
+  double new_obj = p_shared.m_con_activity[0] + p_coeff * p_delta;
+  if (new_obj < p_shared.m_best_obj)
+    p_bonus_score += con_weight;
+  if (new_obj < p_shared.m_con_activity[0])
+    return scaled_con_weight;
+  return -scaled_con_weight;
+}
+
+// Progress of moving one term of row p_con_idx by p_coeff * p_delta, with
+// the row at p_activity and weighted p_con_weight. Taking both as
+// arguments lets the score cache evaluate a row before and after a change.
+long row_progress(const Readonly_Ctx& p_shared,
+                  size_t p_con_idx,
+                  double p_activity,
+                  size_t p_con_weight,
+                  double p_coeff,
+                  double p_delta,
+                  double p_feas_tolerance)
+{
+  const long con_weight = static_cast<long>(p_con_weight);
+  const long scaled_con_weight = con_weight * 2;
+  if (p_shared.m_con_sat_interval != nullptr && p_con_idx != 0)
+  {
+    const Sat_Interval& interval = p_shared.m_con_sat_interval[p_con_idx];
+    const bool pre_sat = interval.contains(p_activity);
+    const bool now_sat = interval.contains(p_activity + p_coeff * p_delta);
+    if (!pre_sat && now_sat)
+      return scaled_con_weight;
+    if (pre_sat && !now_sat)
+      return -scaled_con_weight;
+    if (pre_sat)
+      return 0;
+  }
+  double new_activity = p_activity + p_coeff * p_delta;
+  double pre_gap = p_activity - p_shared.m_con_constant[p_con_idx];
+  double new_gap = new_activity - p_shared.m_con_constant[p_con_idx];
+  // An equality scores like the two inequalities it would split into:
+  // only the violated side counts, so it weighs as much as one inequality.
+  if (p_shared.m_con_is_equality[p_con_idx])
+  {
+    pre_gap = std::fabs(pre_gap);
+    new_gap = std::fabs(new_gap);
+  }
+  bool pre_sat = pre_gap <= p_feas_tolerance;
+  bool now_sat = new_gap <= p_feas_tolerance;
+  if (!pre_sat && now_sat)
+    return scaled_con_weight;
+  if (pre_sat && !now_sat)
+    return -scaled_con_weight;
+  if (!pre_sat && !now_sat)
+  {
+    if (new_gap < pre_gap)
+      return con_weight;
+    return -con_weight;
+  }
+  return 0;
+}
+
+long con_progress(const Readonly_Ctx& p_shared,
+                  size_t p_con_idx,
+                  double p_coeff,
+                  double p_delta,
+                  double p_feas_tolerance)
+{
+  return row_progress(p_shared,
+                      p_con_idx,
+                      p_shared.m_con_activity[p_con_idx],
+                      p_shared.m_con_weight[p_con_idx],
+                      p_coeff,
+                      p_delta,
+                      p_feas_tolerance);
+}
+
+// Sums the progress of every row in the column of p_var_idx. With a score
+// cache attached, the part coming from rows other than the objective is
+// served from the cache, which patch_score_cache() keeps current; the
+// objective row is always evaluated fresh. All terms are integers, so the
+// cached and the uncached paths give identical scores.
+bool column_progress(Scoring::Neighbor_Ctx& p_ctx,
+                     size_t p_var_idx,
+                     double p_delta,
+                     long& p_neighbor_score,
+                     long& p_bonus_score)
+{
+  const auto& shared = p_ctx.m_shared;
+  const auto& matrix = shared.m_model_manager.matrix();
+  const auto col = matrix.col(p_var_idx);
+  if (col.empty())
+    return false;
+  const double feas_tolerance = shared.m_model_manager.feas_tolerance();
+  const bool score_objective = shared.m_is_found_feasible;
+  Score_Cache* score_cache = p_ctx.m_score_cache;
+  long con_score = 0;
+  if (score_cache != nullptr &&
+      score_cache->lookup(p_var_idx, p_delta, con_score))
+  {
+    const size_t obj_idx =
+        shared.m_model_manager.var_id_to_obj_idx(p_var_idx);
+    if (obj_idx != SIZE_MAX)
+    {
+      const double obj_coeff = matrix.row_coeffs(0)[obj_idx];
+      if (score_objective)
+        p_neighbor_score +=
+            objective_progress(shared, obj_coeff, p_delta, p_bonus_score);
+      else
+        p_neighbor_score +=
+            con_progress(shared, 0, obj_coeff, p_delta, feas_tolerance);
+    }
+    p_neighbor_score += con_score;
+    return true;
+  }
+  for (const auto& term : col)
+  {
+    const size_t con_idx = term.con_idx;
+    if (con_idx != 0)
+      con_score += con_progress(
+          shared, con_idx, term.coeff, p_delta, feas_tolerance);
+    else if (score_objective)
+      p_neighbor_score +=
+          objective_progress(shared, term.coeff, p_delta, p_bonus_score);
+    else
+      p_neighbor_score +=
+          con_progress(shared, 0, term.coeff, p_delta, feas_tolerance);
+  }
+  if (score_cache != nullptr)
+    score_cache->store(p_var_idx, p_delta, con_score);
+  p_neighbor_score += con_score;
+  return true;
+}
+
+} // namespace
+
 void Scoring::set_neighbor_cbk(Neighbor_Cbk p_cbk, void* p_user_data)
 {
   m_neighbor_cbk = std::move(p_cbk);
@@ -62,14 +207,15 @@ Scoring::Neighbor_Ctx::Neighbor_Ctx(
     long& p_current_neighbor_subscore,
     size_t& p_current_best_age,
     size_t& p_current_best_var_idx,
-    double& p_current_best_delta)
+    double& p_current_best_delta,
+    Score_Cache* p_score_cache)
     : m_shared(p_shared), m_binary_op_stamp(p_binary_op_stamp),
       m_binary_op_stamp_token(p_binary_op_stamp_token),
       m_best_neighbor_score(p_current_neighbor_score),
       m_best_neighbor_subscore(p_current_neighbor_subscore),
       m_best_age(p_current_best_age),
       m_best_var_idx(p_current_best_var_idx),
-      m_best_delta(p_current_best_delta)
+      m_best_delta(p_current_best_delta), m_score_cache(p_score_cache)
 {
 }
 
@@ -82,197 +228,108 @@ void Scoring::score_neighbor(Neighbor_Ctx& p_ctx,
     m_neighbor_cbk(p_ctx, p_var_idx, p_delta, m_neighbor_user_data);
     return;
   }
-  if (m_neighbor_method == Neighbor_Method::progress_age)
-    progress_age(p_ctx, p_var_idx, p_delta);
-  else
-    progress_bonus(p_ctx, p_var_idx, p_delta);
+  if (!claim_neighbor(p_ctx, p_var_idx))
+    return;
+  evaluate_neighbor(p_ctx, p_var_idx, p_delta);
 }
 
-void Scoring::progress_bonus(Neighbor_Ctx& p_ctx,
-                             size_t p_var_idx,
-                             double p_delta) const
+bool Scoring::claim_neighbor(Neighbor_Ctx& p_ctx, size_t p_var_idx) const
 {
   auto& model_var = p_ctx.m_shared.m_model_manager.var(p_var_idx);
-  const double feas_tolerance =
-      p_ctx.m_shared.m_model_manager.feas_tolerance();
-  if (model_var.type() == Var_Type::binary)
-  {
-    if (p_ctx.m_binary_op_stamp[p_var_idx] ==
-        p_ctx.m_binary_op_stamp_token)
-      return;
-    p_ctx.m_binary_op_stamp[p_var_idx] = p_ctx.m_binary_op_stamp_token;
-  }
+  if (model_var.type() != Var_Type::binary)
+    return true;
+  if (p_ctx.m_binary_op_stamp[p_var_idx] == p_ctx.m_binary_op_stamp_token)
+    return false;
+  p_ctx.m_binary_op_stamp[p_var_idx] = p_ctx.m_binary_op_stamp_token;
+  return true;
+}
+
+void Scoring::evaluate_neighbor(Neighbor_Ctx& p_ctx,
+                                size_t p_var_idx,
+                                double p_delta) const
+{
   long neighbor_score = 0;
   long bonus_score = 0;
-  size_t term_num = model_var.term_num();
-  if (term_num == 0)
+  if (!column_progress(
+          p_ctx, p_var_idx, p_delta, neighbor_score, bonus_score))
     return;
-  for (size_t term_idx = 0; term_idx < term_num; ++term_idx)
-  {
-    size_t con_idx = model_var.con_idx(term_idx);
-    size_t pos_in_con = model_var.pos_in_con(term_idx);
-    auto& model_con = p_ctx.m_shared.m_model_manager.con(con_idx);
-    const long con_weight =
-        static_cast<long>(p_ctx.m_shared.m_con_weight[con_idx]);
-    const long scaled_con_weight = con_weight * 2;
-    if (con_idx == 0 && p_ctx.m_shared.m_is_found_feasible)
-    {
-      double new_obj = p_ctx.m_shared.m_con_activity[con_idx] +
-                       model_con.coeff(pos_in_con) * p_delta;
-      if (new_obj < p_ctx.m_shared.m_con_activity[con_idx])
-        neighbor_score += scaled_con_weight;
-      else
-        neighbor_score -= scaled_con_weight;
-      if (new_obj < p_ctx.m_shared.m_best_obj)
-        bonus_score += con_weight;
-    }
-    else
-    {
-      double new_activity = p_ctx.m_shared.m_con_activity[con_idx] +
-                            model_con.coeff(pos_in_con) * p_delta;
-      double pre_gap = p_ctx.m_shared.m_con_activity[con_idx] -
-                       p_ctx.m_shared.m_con_constant[con_idx];
-      double new_gap =
-          new_activity - p_ctx.m_shared.m_con_constant[con_idx];
-      bool pre_sat;
-      if (p_ctx.m_shared.m_con_is_equality[con_idx])
-      {
-        pre_sat = std::fabs(pre_gap) <= feas_tolerance;
-        bool now_sat = std::fabs(new_gap) <= feas_tolerance;
-        if (!pre_sat && now_sat)
-          neighbor_score += scaled_con_weight * 2;
-        else if (pre_sat && !now_sat)
-          neighbor_score -= scaled_con_weight * 2;
-        else if (!pre_sat && !now_sat)
-        {
-          if (std::fabs(new_gap) < std::fabs(pre_gap))
-            neighbor_score += scaled_con_weight;
-          else
-            neighbor_score -= scaled_con_weight;
-        }
-      }
-      else
-      {
-        pre_sat = pre_gap <= feas_tolerance;
-        bool now_sat = new_gap <= feas_tolerance;
-        if (!pre_sat && now_sat)
-          neighbor_score += scaled_con_weight;
-        else if (pre_sat && !now_sat)
-          neighbor_score -= scaled_con_weight;
-        else if (!pre_sat && !now_sat)
-        {
-          if (new_gap < pre_gap)
-            neighbor_score += con_weight;
-          else
-            neighbor_score -= con_weight;
-        }
-      }
-    }
-  }
   size_t age = std::max(p_ctx.m_shared.m_var_last_dec_step[p_var_idx],
                         p_ctx.m_shared.m_var_last_inc_step[p_var_idx]);
-  if (p_ctx.m_best_neighbor_score < neighbor_score ||
-      (p_ctx.m_best_neighbor_score == neighbor_score &&
-       p_ctx.m_best_neighbor_subscore < bonus_score) ||
-      (p_ctx.m_best_neighbor_score == neighbor_score &&
-       p_ctx.m_best_neighbor_subscore == bonus_score &&
-       age < p_ctx.m_best_age))
-  {
-    p_ctx.m_best_var_idx = p_var_idx;
-    p_ctx.m_best_delta = p_delta;
-    p_ctx.m_best_neighbor_score = neighbor_score;
-    p_ctx.m_best_neighbor_subscore = bonus_score;
-    p_ctx.m_best_age = age;
-  }
+  offer_neighbor(p_ctx, p_var_idx, p_delta, neighbor_score, bonus_score, age);
 }
 
-void Scoring::progress_age(Neighbor_Ctx& p_ctx,
-                           size_t p_var_idx,
-                           double p_delta) const
+void Scoring::patch_score_cache(Neighbor_Ctx& p_ctx,
+                                size_t p_con_idx,
+                                double p_old_activity,
+                                size_t p_old_weight) const
 {
-  auto& model_var = p_ctx.m_shared.m_model_manager.var(p_var_idx);
-  const double feas_tolerance =
-      p_ctx.m_shared.m_model_manager.feas_tolerance();
-  if (model_var.type() == Var_Type::binary)
+  const auto& shared = p_ctx.m_shared;
+  const double new_activity = shared.m_con_activity[p_con_idx];
+  const size_t new_weight = shared.m_con_weight[p_con_idx];
+  if (new_activity == p_old_activity && new_weight == p_old_weight)
+    return;
+  const auto& matrix = shared.m_model_manager.matrix();
+  const auto coeffs = matrix.row_coeffs(p_con_idx);
+  const auto var_idxs = matrix.row_var_idxs(p_con_idx);
+  const double feas_tolerance = shared.m_model_manager.feas_tolerance();
+  for (size_t term_idx = 0; term_idx < var_idxs.size(); ++term_idx)
   {
-    if (p_ctx.m_binary_op_stamp[p_var_idx] ==
-        p_ctx.m_binary_op_stamp_token)
-      return;
-    p_ctx.m_binary_op_stamp[p_var_idx] = p_ctx.m_binary_op_stamp_token;
+    const double coeff = coeffs[term_idx];
+    p_ctx.m_score_cache->patch(
+        var_idxs[term_idx],
+        [&](double p_delta)
+        {
+          return row_progress(shared,
+                              p_con_idx,
+                              new_activity,
+                              new_weight,
+                              coeff,
+                              p_delta,
+                              feas_tolerance) -
+                 row_progress(shared,
+                              p_con_idx,
+                              p_old_activity,
+                              p_old_weight,
+                              coeff,
+                              p_delta,
+                              feas_tolerance);
+        });
   }
-  long neighbor_score = 0;
-  size_t term_num = model_var.term_num();
-  if (term_num == 0)
-    return;
-  for (size_t term_idx = 0; term_idx < term_num; ++term_idx)
+}
+
+// progress_bonus ranks by score, then bonus, then age; progress_age skips
+// the bonus. Ties keep the earlier candidate, so merging per-part winners
+// in part order selects the same move as one serial pass.
+void Scoring::offer_neighbor(Neighbor_Ctx& p_ctx,
+                             size_t p_var_idx,
+                             double p_delta,
+                             long p_score,
+                             long p_subscore,
+                             size_t p_age) const
+{
+  if (m_neighbor_method == Neighbor_Method::progress_age)
   {
-    size_t con_idx = model_var.con_idx(term_idx);
-    size_t pos_in_con = model_var.pos_in_con(term_idx);
-    auto& model_con = p_ctx.m_shared.m_model_manager.con(con_idx);
-    const long con_weight =
-        static_cast<long>(p_ctx.m_shared.m_con_weight[con_idx]);
-    const long scaled_con_weight = con_weight * 2;
-    if (con_idx == 0 && p_ctx.m_shared.m_is_found_feasible)
-    {
-      double new_obj = p_ctx.m_shared.m_con_activity[con_idx] +
-                       model_con.coeff(pos_in_con) * p_delta;
-      if (new_obj < p_ctx.m_shared.m_con_activity[con_idx])
-        neighbor_score += scaled_con_weight;
-      else
-        neighbor_score -= scaled_con_weight;
-    }
-    else
+    if (p_ctx.m_best_neighbor_score < p_score ||
+        (p_ctx.m_best_neighbor_score == p_score && p_age < p_ctx.m_best_age))
     {
-      double new_activity = p_ctx.m_shared.m_con_activity[con_idx] +
-                            model_con.coeff(pos_in_con) * p_delta;
-      double pre_gap = p_ctx.m_shared.m_con_activity[con_idx] -
-                       p_ctx.m_shared.m_con_constant[con_idx];
-      double new_gap =
-          new_activity - p_ctx.m_shared.m_con_constant[con_idx];
-      bool pre_sat;
-      if (p_ctx.m_shared.m_con_is_equality[con_idx])
-      {
-        pre_sat = std::fabs(pre_gap) <= feas_tolerance;
-        bool now_sat = std::fabs(new_gap) <= feas_tolerance;
-        if (!pre_sat && now_sat)
-          neighbor_score += scaled_con_weight * 2;
-        else if (pre_sat && !now_sat)
-          neighbor_score -= scaled_con_weight * 2;
-        else if (!pre_sat && !now_sat)
-        {
-          if (std::fabs(new_gap) < std::fabs(pre_gap))
-            neighbor_score += scaled_con_weight;
-          else
-            neighbor_score -= scaled_con_weight;
-        }
-      }
-      else
-      {
-        pre_sat = pre_gap <= feas_tolerance;
-        bool now_sat = new_gap <= feas_tolerance;
-        if (!pre_sat && now_sat)
-          neighbor_score += scaled_con_weight;
-        else if (pre_sat && !now_sat)
-          neighbor_score -= scaled_con_weight;
-        else if (!pre_sat && !now_sat)
-        {
-          if (new_gap < pre_gap)
-            neighbor_score += con_weight;
-          else
-            neighbor_score -= con_weight;
-        }
-      }
+      p_ctx.m_best_var_idx = p_var_idx;
+      p_ctx.m_best_delta = p_delta;
+      p_ctx.m_best_neighbor_score = p_score;
+      p_ctx.m_best_age = p_age;
     }
+    return;
   }
-  size_t age = std::max(p_ctx.m_shared.m_var_last_dec_step[p_var_idx],
-                        p_ctx.m_shared.m_var_last_inc_step[p_var_idx]);
-  if (p_ctx.m_best_neighbor_score < neighbor_score ||
-      (p_ctx.m_best_neighbor_score == neighbor_score &&
-       age < p_ctx.m_best_age))
+  if (p_ctx.m_best_neighbor_score < p_score ||
+      (p_ctx.m_best_neighbor_score == p_score &&
+       p_ctx.m_best_neighbor_subscore < p_subscore) ||
+      (p_ctx.m_best_neighbor_score == p_score &&
+       p_ctx.m_best_neighbor_subscore == p_subscore &&
+       p_age < p_ctx.m_best_age))
   {
     p_ctx.m_best_var_idx = p_var_idx;
     p_ctx.m_best_delta = p_delta;
-    p_ctx.m_best_neighbor_score = neighbor_score;
-    p_ctx.m_best_age = age;
+    p_ctx.m_best_neighbor_score = p_score;
+    p_ctx.m_best_neighbor_subscore = p_subscore;
+    p_ctx.m_best_age = p_age;
   }
 }
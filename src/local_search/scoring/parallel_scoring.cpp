@@ -0,0 +1,87 @@
+/*=====================================================================================
+
+    Filename:     parallel_scoring.cpp
+
+    Description:  Deterministic multi-threaded scoring of neighbor moves
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "../../utils/parallel_tasks.h"
+#include "parallel_scoring.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+Parallel_Scoring::Parallel_Scoring(Worker_Pool& p_pool,
+                                   size_t p_min_parallel_ops)
+    : m_pool(p_pool), m_min_parallel_ops(p_min_parallel_ops),
+      m_claimed_ops(), m_part_best(m_pool.thread_num())
+{
+}
+
+void Parallel_Scoring::score(const Scoring& p_scoring,
+                             Scoring::Neighbor_Ctx& p_ctx,
+                             const std::vector<size_t>& p_op_var_idxs,
+                             const std::vector<double>& p_op_var_deltas,
+                             size_t p_op_size)
+{
+  if (p_op_size < m_min_parallel_ops || m_pool.thread_num() == 1)
+  {
+    for (size_t op_idx = 0; op_idx < p_op_size; ++op_idx)
+      p_scoring.score_neighbor(
+          p_ctx, p_op_var_idxs[op_idx], p_op_var_deltas[op_idx]);
+    return;
+  }
+  m_claimed_ops.clear();
+  for (size_t op_idx = 0; op_idx < p_op_size; ++op_idx)
+  {
+    if (p_scoring.claim_neighbor(p_ctx, p_op_var_idxs[op_idx]))
+      m_claimed_ops.push_back(op_idx);
+  }
+  const size_t op_num = m_claimed_ops.size();
+  const size_t part_num = std::min(m_pool.thread_num(), op_num);
+  // Every part starts from the reset_op(false) state, which no candidate
+  // can beat in a context that has already been reset.
+  m_pool.run(
+      part_num,
+      [&](size_t p_part)
+      {
+        Part_Best& best = m_part_best[p_part];
+        best = Part_Best{std::numeric_limits<long>::min(),
+                         std::numeric_limits<long>::min(),
+                         SIZE_MAX,
+                         SIZE_MAX,
+                         0.0};
+        Scoring::Neighbor_Ctx part_ctx(p_ctx.m_shared,
+                                       p_ctx.m_binary_op_stamp,
+                                       p_ctx.m_binary_op_stamp_token,
+                                       best.m_score,
+                                       best.m_subscore,
+                                       best.m_age,
+                                       best.m_var_idx,
+                                       best.m_delta,
+                                       nullptr);
+        const size_t begin = slice_begin(op_num, p_part, part_num);
+        const size_t end = slice_begin(op_num, p_part + 1, part_num);
+        for (size_t claimed = begin; claimed < end; ++claimed)
+        {
+          const size_t op_idx = m_claimed_ops[claimed];
+          p_scoring.evaluate_neighbor(
+              part_ctx, p_op_var_idxs[op_idx], p_op_var_deltas[op_idx]);
+        }
+      });
+  for (size_t part = 0; part < part_num; ++part)
+  {
+    const Part_Best& best = m_part_best[part];
+    if (best.m_var_idx == SIZE_MAX)
+      continue;
+    p_scoring.offer_neighbor(p_ctx,
+                             best.m_var_idx,
+                             best.m_delta,
+                             best.m_score,
+                             best.m_subscore,
+                             best.m_age);
+  }
+}
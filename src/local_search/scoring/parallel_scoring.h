@@ -0,0 +1,69 @@
+/*=====================================================================================
+
+    Filename:     parallel_scoring.h
+
+    Description:  Deterministic multi-threaded scoring of neighbor moves
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include "../../utils/worker_pool.h"
+#include "scoring.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Scores the operations of one neighborhood on a shared worker pool.
+// Repeated binary flips are claimed serially first, exactly as the serial
+// loop would drop them; the surviving operations are then split into
+// contiguous parts, each part keeps its own best candidate, and the part
+// winners are offered to the search context in part order. Ties keep the
+// earlier candidate throughout, so the chosen move is the one a single
+// pass over the operations picks, for any number of workers.
+class Parallel_Scoring
+{
+public:
+  explicit Parallel_Scoring(Worker_Pool& p_pool,
+                            size_t p_min_parallel_ops = 256);
+
+  inline size_t thread_num() const;
+
+  // Falls back to the serial loop below p_min_parallel_ops operations,
+  // where waking the pool costs more than it saves. The score cache of
+  // p_ctx is neither read nor updated on the parallel path; cached and
+  // fresh scores are equal, so this does not change the result.
+  void score(const Scoring& p_scoring,
+             Scoring::Neighbor_Ctx& p_ctx,
+             const std::vector<size_t>& p_op_var_idxs,
+             const std::vector<double>& p_op_var_deltas,
+             size_t p_op_size);
+
+private:
+  struct alignas(64) Part_Best
+  {
+    long m_score;
+
+    long m_subscore;
+
+    size_t m_age;
+
+    size_t m_var_idx;
+
+    double m_delta;
+  };
+
+  Worker_Pool& m_pool;
+
+  size_t m_min_parallel_ops;
+
+  std::vector<size_t> m_claimed_ops;
+
+  std::vector<Part_Best> m_part_best;
+};
+
+inline size_t Parallel_Scoring::thread_num() const
+{
+  return m_pool.thread_num();
+}
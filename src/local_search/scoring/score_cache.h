@@ -0,0 +1,134 @@
+/*=====================================================================================
+
+    Filename:     score_cache.h
+
+    Description:  Incremental per-variable cache of constraint progress scores
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Caches the non-objective part of a neighbor score, one slot per
+// (variable, direction). The cached value depends only on the activities
+// and weights of the rows in the variable's column. When one of those rows
+// changes, the owner patches the entry by that row's change in progress
+// (see patch()), so entries survive moves. Changes that cannot be patched
+// row by row drop the whole cache: invalidate_all() advances a logical
+// clock, and an entry is valid while it was stored no earlier than the last
+// invalidation.
+class Score_Cache
+{
+public:
+  Score_Cache() : m_clock(1), m_all_dirty_at(0), m_hits(0), m_misses(0) {}
+
+  inline void resize(size_t p_var_num);
+
+  inline void invalidate_all();
+
+  inline bool lookup(size_t p_var_idx, double p_delta, long& p_score);
+
+  // Adds p_diff(delta) to each valid entry of p_var_idx, where delta is the
+  // move the entry was stored for.
+  template <typename Diff>
+  inline void patch(size_t p_var_idx, const Diff& p_diff);
+
+  inline void store(size_t p_var_idx, double p_delta, long p_score);
+
+  inline size_t hits() const;
+
+  inline size_t misses() const;
+
+private:
+  struct Entry
+  {
+    double delta;
+
+    long score;
+
+    uint64_t stored_at;
+  };
+
+  std::vector<Entry> m_entries;
+
+  uint64_t m_clock;
+
+  uint64_t m_all_dirty_at;
+
+  size_t m_hits;
+
+  size_t m_misses;
+
+  inline static size_t slot(size_t p_var_idx, double p_delta);
+
+  inline bool valid(const Entry& p_entry) const;
+};
+
+inline size_t Score_Cache::slot(size_t p_var_idx, double p_delta)
+{
+  return p_var_idx * 2 + (p_delta > 0 ? 1 : 0);
+}
+
+inline void Score_Cache::resize(size_t p_var_num)
+{
+  m_entries.assign(p_var_num * 2, Entry{0.0, 0, 0});
+  m_clock = 1;
+  m_all_dirty_at = 0;
+  m_hits = 0;
+  m_misses = 0;
+}
+
+inline void Score_Cache::invalidate_all()
+{
+  m_all_dirty_at = ++m_clock;
+}
+
+inline bool Score_Cache::valid(const Entry& p_entry) const
+{
+  return p_entry.stored_at != 0 && p_entry.stored_at >= m_all_dirty_at;
+}
+
+inline bool
+Score_Cache::lookup(size_t p_var_idx, double p_delta, long& p_score)
+{
+  const Entry& entry = m_entries[slot(p_var_idx, p_delta)];
+  if (entry.delta == p_delta && valid(entry))
+  {
+    p_score = entry.score;
+    ++m_hits;
+    return true;
+  }
+  ++m_misses;
+  return false;
+}
+
+template <typename Diff>
+inline void Score_Cache::patch(size_t p_var_idx, const Diff& p_diff)
+{
+  Entry* entries = &m_entries[p_var_idx * 2];
+  for (size_t side = 0; side < 2; ++side)
+  {
+    if (valid(entries[side]))
+      entries[side].score += p_diff(entries[side].delta);
+  }
+}
+
+inline void
+Score_Cache::store(size_t p_var_idx, double p_delta, long p_score)
+{
+  m_entries[slot(p_var_idx, p_delta)] = Entry{p_delta, p_score, m_clock};
+}
+
+inline size_t Score_Cache::hits() const
+{
+  return m_hits;
+}
+
+inline size_t Score_Cache::misses() const
+{
+  return m_misses;
+}
@@ -23,6 +23,8 @@
 
 class Model_Manager;
 
+class Score_Cache;
+
 class Scoring
 {
 public:
@@ -59,7 +61,8 @@ public:
                  long& p_current_neighbor_subscore,
                  size_t& p_current_best_age,
                  size_t& p_current_best_var_idx,
-                 double& p_current_best_delta);
+                 double& p_current_best_delta,
+                 Score_Cache* p_score_cache = nullptr);
 
     const Readonly_Ctx& m_shared;
 
@@ -76,6 +79,8 @@ public:
     size_t& m_best_var_idx;
 
     double& m_best_delta;
+
+    Score_Cache* m_score_cache;
   };
 
   using Lift_Cbk = std::function<void(Lift_Ctx&, size_t, double, void*)>;
@@ -105,6 +110,33 @@ public:
                       size_t p_var_idx,
                       double p_delta) const;
 
+  // The two halves of a built-in score_neighbor(): claim_neighbor() drops
+  // repeated binary flips within one step, evaluate_neighbor() scores the
+  // move and offers it to p_ctx. Without a score cache attached,
+  // evaluate_neighbor() only reads shared state, so distinct contexts can
+  // run it concurrently.
+  bool claim_neighbor(Neighbor_Ctx& p_ctx, size_t p_var_idx) const;
+
+  void evaluate_neighbor(Neighbor_Ctx& p_ctx,
+                         size_t p_var_idx,
+                         double p_delta) const;
+
+  // Makes the candidate the best of p_ctx if it ranks strictly higher.
+  void offer_neighbor(Neighbor_Ctx& p_ctx,
+                      size_t p_var_idx,
+                      double p_delta,
+                      long p_score,
+                      long p_subscore,
+                      size_t p_age) const;
+
+  // Row p_con_idx went from p_old_activity and p_old_weight to its current
+  // activity and weight: adds the change of its progress to the cached
+  // scores of its variables, so those entries stay exact.
+  void patch_score_cache(Neighbor_Ctx& p_ctx,
+                         size_t p_con_idx,
+                         double p_old_activity,
+                         size_t p_old_weight) const;
+
   inline bool has_lift_callback() const;
 
   inline bool has_neighbor_callback() const;
@@ -138,14 +170,6 @@ private:
 
   void
   lift_random(Lift_Ctx& p_ctx, size_t p_var_idx, double p_delta) const;
-
-  void progress_bonus(Neighbor_Ctx& p_ctx,
-                      size_t p_var_idx,
-                      double p_delta) const;
-
-  void progress_age(Neighbor_Ctx& p_ctx,
-                    size_t p_var_idx,
-                    double p_delta) const;
 };
 
 inline bool Scoring::has_lift_callback() const
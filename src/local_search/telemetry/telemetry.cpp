@@ -0,0 +1,120 @@
+/*=====================================================================================
+
+    Filename:     telemetry.cpp
+
+    Description:  Hot-path counters and cycle timers of the local search
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "telemetry.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+
+void merge_phase(Phase_Stats& p_into, const Phase_Stats& p_from)
+{
+  p_into.calls += p_from.calls;
+  p_into.cycles += p_from.cycles;
+}
+
+double share(uint64_t p_part, uint64_t p_total)
+{
+  return p_total == 0 ? 0.0 : 100.0 * static_cast<double>(p_part) /
+                                  static_cast<double>(p_total);
+}
+
+double per(uint64_t p_part, uint64_t p_count)
+{
+  return p_count == 0 ? 0.0 : static_cast<double>(p_part) /
+                                  static_cast<double>(p_count);
+}
+
+} // namespace
+
+void Search_Telemetry::merge(const Search_Telemetry& p_other)
+{
+  steps += p_other.steps;
+  moves += p_other.moves;
+  lift_moves += p_other.lift_moves;
+  search_seconds = std::max(search_seconds, p_other.search_seconds);
+  merge_phase(explore_neighbor, p_other.explore_neighbor);
+  merge_phase(lift_move, p_other.lift_move);
+  merge_phase(weight_update, p_other.weight_update);
+  merge_phase(refresh_activities, p_other.refresh_activities);
+  merge_phase(restart, p_other.restart);
+  for (const auto& other : p_other.neighbors)
+  {
+    auto stats = std::find_if(neighbors.begin(),
+                              neighbors.end(),
+                              [&](const Neighbor_Stats& p_stats)
+                              { return p_stats.name == other.name; });
+    if (stats == neighbors.end())
+    {
+      neighbors.push_back(other);
+      continue;
+    }
+    stats->calls += other.calls;
+    stats->candidates += other.candidates;
+    stats->scored += other.scored;
+    stats->hits += other.hits;
+    stats->explore_cycles += other.explore_cycles;
+    stats->score_cycles += other.score_cycles;
+  }
+}
+
+void Search_Telemetry::print() const
+{
+  printf("c telemetry: %llu steps in %.2lf s (%.0lf steps/s), %llu moves, "
+         "%llu lift moves, %llu restarts\n",
+         static_cast<unsigned long long>(steps),
+         search_seconds,
+         search_seconds > 0.0 ? static_cast<double>(steps) / search_seconds
+                              : 0.0,
+         static_cast<unsigned long long>(moves),
+         static_cast<unsigned long long>(lift_moves),
+         static_cast<unsigned long long>(restart.calls));
+  const uint64_t total = explore_neighbor.cycles + lift_move.cycles +
+                         refresh_activities.cycles + restart.cycles;
+  const struct
+  {
+    const char* name;
+    const Phase_Stats& stats;
+  } phases[] = {{"explore_neighbor", explore_neighbor},
+                {"  weight_update", weight_update},
+                {"lift_move", lift_move},
+                {"refresh_activities", refresh_activities},
+                {"restart", restart}};
+  printf("c %-20s %12s %16s %7s %14s\n",
+         "phase",
+         "calls",
+         "cycles",
+         "share",
+         "cycles/call");
+  for (const auto& phase : phases)
+    printf("c %-20s %12llu %16llu %6.1lf%% %14.0lf\n",
+           phase.name,
+           static_cast<unsigned long long>(phase.stats.calls),
+           static_cast<unsigned long long>(phase.stats.cycles),
+           share(phase.stats.cycles, total),
+           per(phase.stats.cycles, phase.stats.calls));
+  printf("c %-20s %12s %12s %12s %10s %14s %14s\n",
+         "neighbor",
+         "calls",
+         "candidates",
+         "scored",
+         "hits",
+         "explore/call",
+         "score/cand");
+  for (const auto& stats : neighbors)
+    printf("c %-20s %12llu %12llu %12llu %10llu %14.0lf %14.0lf\n",
+           stats.name.c_str(),
+           static_cast<unsigned long long>(stats.calls),
+           static_cast<unsigned long long>(stats.candidates),
+           static_cast<unsigned long long>(stats.scored),
+           static_cast<unsigned long long>(stats.hits),
+           per(stats.explore_cycles, stats.calls),
+           per(stats.score_cycles, stats.scored));
+}
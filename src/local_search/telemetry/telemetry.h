@@ -0,0 +1,131 @@
+/*=====================================================================================
+
+    Filename:     telemetry.h
+
+    Description:  Hot-path counters and cycle timers of the local search
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Recording is compiled in only with LOCAL_MIP_TELEMETRY (the CMake option
+// of the same name). The structures keep one layout either way, so the
+// query API exists in every build and reports zeros when recording is off.
+#ifdef LOCAL_MIP_TELEMETRY
+inline constexpr bool k_telemetry_enabled = true;
+#else
+inline constexpr bool k_telemetry_enabled = false;
+#endif
+
+// Time stamp counter where available, nanoseconds otherwise.
+inline uint64_t read_cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+struct Phase_Stats
+{
+  uint64_t calls = 0;
+
+  uint64_t cycles = 0;
+};
+
+struct Neighbor_Stats
+{
+  std::string name;
+
+  uint64_t calls = 0;
+
+  // Operations the strategy produced, and the sampled part that was scored.
+  uint64_t candidates = 0;
+
+  uint64_t scored = 0;
+
+  // Explorations that ended on this strategy with an improving move.
+  uint64_t hits = 0;
+
+  uint64_t explore_cycles = 0;
+
+  uint64_t score_cycles = 0;
+};
+
+struct Search_Telemetry
+{
+  uint64_t steps = 0;
+
+  // Moves applied, and the part of them made by successful lift moves.
+  uint64_t moves = 0;
+
+  uint64_t lift_moves = 0;
+
+  // Wall time of the search, filled in by Local_MIP.
+  double search_seconds = 0.0;
+
+  Phase_Stats explore_neighbor;
+
+  Phase_Stats lift_move;
+
+  Phase_Stats weight_update;
+
+  Phase_Stats refresh_activities;
+
+  // Calls count performed restarts only.
+  Phase_Stats restart;
+
+  std::vector<Neighbor_Stats> neighbors;
+
+  // Sums p_other into this; neighbors are matched by name.
+  void merge(const Search_Telemetry& p_other);
+
+  void print() const;
+};
+
+// Adds the elapsed cycles of its scope to a phase.
+class Phase_Timer
+{
+public:
+  explicit Phase_Timer(Phase_Stats& p_stats)
+      : m_stats(p_stats), m_start(k_telemetry_enabled ? read_cycles() : 0)
+  {
+  }
+
+  Phase_Timer(const Phase_Timer&) = delete;
+
+  Phase_Timer& operator=(const Phase_Timer&) = delete;
+
+  ~Phase_Timer()
+  {
+    if constexpr (k_telemetry_enabled)
+    {
+      ++m_stats.calls;
+      m_stats.cycles += read_cycles() - m_start;
+    }
+  }
+
+private:
+  Phase_Stats& m_stats;
+
+  uint64_t m_start;
+};
+
+inline void telemetry_add(uint64_t& p_counter, uint64_t p_value = 1)
+{
+  if constexpr (k_telemetry_enabled)
+    p_counter += p_value;
+}
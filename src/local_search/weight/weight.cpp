@@ -73,20 +73,22 @@ const size_t& Weight::smooth_probability() const
   return m_smooth_prob;
 }
 
-void Weight::update(Weight_Ctx& p_ctx) const
+bool Weight::update(Weight_Ctx& p_ctx) const
 {
   if (m_user_cbk)
   {
     m_user_cbk(p_ctx, m_user_data);
-    return;
+    return false;
   }
   if (m_default_method == Method::monotone)
+  {
     monotone_update(p_ctx);
-  else
-    smooth_update(p_ctx);
+    return true;
+  }
+  return smooth_update(p_ctx);
 }
 
-void Weight::smooth_update(Weight_Ctx& p_ctx) const
+bool Weight::smooth_update(Weight_Ctx& p_ctx) const
 {
   if (p_ctx.m_rng() % 10000 > m_smooth_prob)
   {
@@ -95,6 +97,7 @@ void Weight::smooth_update(Weight_Ctx& p_ctx) const
     if (p_ctx.m_shared.m_is_found_feasible &&
         p_ctx.m_shared.m_con_unsat_idxs.empty())
       p_ctx.m_con_weight[0]++;
+    return true;
   }
   else
   {
@@ -102,7 +105,7 @@ void Weight::smooth_update(Weight_Ctx& p_ctx) const
     for (size_t con_idx = 1; con_idx < con_num; ++con_idx)
     {
       bool is_sat =
-          p_ctx.m_shared.m_con_pos_in_unsat_idxs[con_idx] == SIZE_MAX;
+          p_ctx.m_shared.m_con_pos_in_unsat_idxs[con_idx] == k_null_idx;
       if (is_sat && p_ctx.m_con_weight[con_idx] > 0)
         p_ctx.m_con_weight[con_idx]--;
     }
@@ -111,6 +114,7 @@ void Weight::smooth_update(Weight_Ctx& p_ctx) const
         p_ctx.m_con_weight[0] > 0)
       p_ctx.m_con_weight[0]--;
   }
+  return false;
 }
 
 void Weight::monotone_update(Weight_Ctx& p_ctx) const
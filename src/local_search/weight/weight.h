@@ -54,7 +54,10 @@ public:
 
   const size_t& smooth_probability() const;
 
-  void update(Weight_Ctx& p_ctx) const;
+  // Returns true when the only change was one more unit of weight on every
+  // unsatisfied constraint and possibly on the objective, false when any
+  // other weight may have changed.
+  bool update(Weight_Ctx& p_ctx) const;
 
 private:
   enum class Method
@@ -71,7 +74,7 @@ private:
 
   size_t m_smooth_prob;
 
-  void smooth_update(Weight_Ctx& p_ctx) const;
+  bool smooth_update(Weight_Ctx& p_ctx) const;
 
   void monotone_update(Weight_Ctx& p_ctx) const;
 };
@@ -16,6 +16,7 @@
 #include "../utils/global_defs.h"
 #include "../utils/solver_error.h"
 #include "Model_API.h"
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <stdexcept>
@@ -401,10 +402,17 @@ Model_API::prepare(const Model_Prepare_Options& p_options) const
                                                  p_options.zero_tolerance);
   manager->set_bound_strengthen(p_options.bound_strengthen);
   manager->set_split_eq(p_options.split_eq);
+  manager->set_dup_presolve(p_options.dup_presolve);
+  manager->set_presolve_workers(p_options.presolve_threads);
+  Prepare_Timing timing;
+  auto start = std::chrono::steady_clock::now();
   populate_model(*manager);
+  timing.read_seconds = Prepared_Model::seconds_since(start);
+  start = std::chrono::steady_clock::now();
   if (!manager->process_after_read())
     throw Solver_Error("model is infeasible during preparation");
+  timing.presolve_seconds = Prepared_Model::seconds_since(start);
 
   return std::shared_ptr<const Prepared_Model>(
-      new Prepared_Model(std::move(manager)));
+      new Prepared_Model(std::move(manager), timing));
 }
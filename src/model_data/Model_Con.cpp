@@ -80,9 +80,9 @@ void Model_Con::delete_term_at(const size_t p_term_idx,
 {
   assert(p_term_idx < term_num());
   double delete_coeff = m_coeff_list[p_term_idx];
-  size_t moved_var_idx = m_var_idx_list.back();
+  Model_Idx moved_var_idx = m_var_idx_list.back();
   double moved_coeff = m_coeff_list.back();
-  size_t moved_pos_in_var = m_pos_in_var_list.back();
+  Model_Idx moved_pos_in_var = m_pos_in_var_list.back();
   m_var_idx_list[p_term_idx] = moved_var_idx;
   m_coeff_list[p_term_idx] = moved_coeff;
   m_pos_in_var_list[p_term_idx] = moved_pos_in_var;
@@ -98,3 +98,9 @@ void Model_Con::delete_term_at(const size_t p_term_idx,
   else
     m_rhs -= delete_coeff * p_delete_var_value;
 }
+
+void Model_Con::set_pos_in_var(const size_t p_term_idx,
+                               const size_t p_pos_in_var)
+{
+  m_pos_in_var_list[p_term_idx] = static_cast<Model_Idx>(p_pos_in_var);
+}
@@ -21,6 +21,8 @@ class Model_Manager;
 class Model_Con
 {
 private:
+  friend class Model_Snapshot;
+
   std::string m_name;
 
   size_t m_idx;
@@ -31,9 +33,9 @@ private:
 
   std::vector<double> m_coeff_list;
 
-  std::vector<size_t> m_var_idx_list;
+  std::vector<Model_Idx> m_var_idx_list;
 
-  std::vector<size_t> m_pos_in_var_list;
+  std::vector<Model_Idx> m_pos_in_var_list;
 
   double m_rhs;
 
@@ -56,6 +58,8 @@ public:
                       double var_value,
                       Model_Manager* p_model_manager);
 
+  void set_pos_in_var(const size_t p_term_idx, const size_t p_pos_in_var);
+
   inline void mark_inferred_sat();
 
   inline void add_var(const size_t p_var_idx,
@@ -66,6 +70,13 @@ public:
 
   inline void set_coeff(size_t p_term_idx, double p_coeff);
 
+  inline void resize_terms(size_t p_term_num);
+
+  inline void set_term(size_t p_term_idx,
+                       size_t p_var_idx,
+                       double p_coeff,
+                       size_t p_pos_in_var);
+
   inline void add_type(Con_Type p_type);
 
   inline size_t term_num() const;
@@ -84,7 +95,9 @@ public:
 
   inline size_t var_idx(const size_t p_term_idx) const;
 
-  inline const std::vector<size_t>& var_idx_set() const;
+  inline size_t pos_in_var(const size_t p_term_idx) const;
+
+  inline const std::vector<Model_Idx>& var_idx_set() const;
 
   inline const std::vector<double>& coeff_set() const;
 
@@ -139,7 +152,12 @@ inline size_t Model_Con::var_idx(const size_t p_term_idx) const
   return m_var_idx_list[p_term_idx];
 }
 
-inline const std::vector<size_t>& Model_Con::var_idx_set() const
+inline size_t Model_Con::pos_in_var(const size_t p_term_idx) const
+{
+  return m_pos_in_var_list[p_term_idx];
+}
+
+inline const std::vector<Model_Idx>& Model_Con::var_idx_set() const
 {
   return m_var_idx_list;
 }
@@ -195,13 +213,30 @@ inline void Model_Con::set_coeff(size_t p_term_idx, double p_coeff)
   m_coeff_list[p_term_idx] = p_coeff;
 }
 
+inline void Model_Con::resize_terms(size_t p_term_num)
+{
+  m_var_idx_list.resize(p_term_num);
+  m_coeff_list.resize(p_term_num);
+  m_pos_in_var_list.resize(p_term_num);
+}
+
+inline void Model_Con::set_term(size_t p_term_idx,
+                                size_t p_var_idx,
+                                double p_coeff,
+                                size_t p_pos_in_var)
+{
+  m_var_idx_list[p_term_idx] = static_cast<Model_Idx>(p_var_idx);
+  m_coeff_list[p_term_idx] = p_coeff;
+  m_pos_in_var_list[p_term_idx] = static_cast<Model_Idx>(p_pos_in_var);
+}
+
 inline void Model_Con::add_var(const size_t p_var_idx,
                                const double p_coeff,
                                const size_t p_pos_in_var)
 {
-  m_var_idx_list.push_back(p_var_idx);
+  m_var_idx_list.push_back(static_cast<Model_Idx>(p_var_idx));
   m_coeff_list.push_back(p_coeff);
-  m_pos_in_var_list.push_back(p_pos_in_var);
+  m_pos_in_var_list.push_back(static_cast<Model_Idx>(p_pos_in_var));
 }
 
 inline void Model_Con::mark_inferred_sat()
@@ -12,11 +12,15 @@
 =====================================================================================*/
 
 #include "../utils/global_defs.h"
+#include "../utils/parallel_tasks.h"
+#include "../utils/solver_error.h"
 #include "Model_Con.h"
 #include "Model_Manager.h"
 #include "Model_Var.h"
 #include <algorithm>
+#include <bit>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -24,16 +28,46 @@
 #include <cstdlib>
 #include <numeric>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+namespace
+{
+
+uint64_t mix_hash(uint64_t p_value)
+{
+  p_value += 0x9e3779b97f4a7c15ULL;
+  p_value = (p_value ^ (p_value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  p_value = (p_value ^ (p_value >> 27)) * 0x94d049bb133111ebULL;
+  return p_value ^ (p_value >> 31);
+}
+
+bool is_finite_bound(double p_bound)
+{
+  return std::fabs(p_bound) < k_inf;
+}
+
+double add_bounds(double p_lhs, double p_rhs)
+{
+  if (!is_finite_bound(p_lhs))
+    return p_lhs;
+  if (!is_finite_bound(p_rhs))
+    return p_rhs;
+  return p_lhs + p_rhs;
+}
+
+} // namespace
+
 Model_Manager::Model_Manager(double p_feas_tolerance,
                              double p_zero_tolerance)
     : m_bound_strengthen(1), m_feas_tolerance(p_feas_tolerance),
       m_zero_tolerance(p_zero_tolerance), m_is_min(1), m_obj_offset(0),
       m_var_num(0), m_general_integer_num(0), m_binary_num(0),
       m_fixed_num(0), m_real_num(0), m_con_num(0), m_delete_con_num(0),
-      m_delete_var_num(0), m_infer_var_num(0), m_split_eq(true)
+      m_delete_var_num(0), m_infer_var_num(0), m_split_eq(false),
+      m_dup_presolve(true), m_presolve_worker_num(0),
+      m_min_presolve_slice(k_min_presolve_slice)
 {
 }
 
@@ -51,6 +85,8 @@ Model_Manager::~Model_Manager()
 size_t Model_Manager::make_var(const std::string& p_name,
                                bool p_requires_integrality)
 {
+  if (m_var_list.size() >= k_null_idx)
+    throw Solver_Error("variable count exceeds the index width");
   auto [iter, inserted] =
       m_var_name_to_idx.try_emplace(p_name, m_var_list.size());
   if (inserted)
@@ -61,6 +97,8 @@ size_t Model_Manager::make_var(const std::string& p_name,
 size_t Model_Manager::make_con(const std::string& p_name,
                                const char p_type)
 {
+  if (m_con_list.size() >= k_null_idx)
+    throw Solver_Error("constraint count exceeds the index width");
   auto [iter, inserted] =
       m_con_name_to_idx.try_emplace(p_name, m_con_list.size());
   if (inserted)
@@ -183,6 +221,16 @@ bool Model_Manager::normalize_var_value(const Model_Var& p_var,
 
 bool Model_Manager::process_after_read()
 {
+  using Clock = std::chrono::steady_clock;
+  auto phase_start = Clock::now();
+  auto lap = [&phase_start]()
+  {
+    const auto now = Clock::now();
+    const double seconds =
+        std::chrono::duration<double>(now - phase_start).count();
+    phase_start = now;
+    return seconds;
+  };
   m_var_num = m_var_list.size();
   const size_t original_con_num = m_con_list.size();
   printf("c original problem has %zu variables and %zu constraints\n",
@@ -191,12 +239,19 @@ bool Model_Manager::process_after_read()
   if (m_split_eq)
     convert_eq_to_ineq();
   m_con_num = m_con_list.size();
-  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
-  {
-    auto& con = m_con_list[con_idx];
-    if (con.is_greater())
-      con.convert_greater_to_less();
-  }
+  const double split_time = lap();
+  const size_t row_num = m_con_num > 0 ? m_con_num - 1 : 0;
+  run_slices(row_num,
+             presolve_parts(row_num),
+             [&](size_t, size_t p_begin, size_t p_end)
+             {
+               for (size_t con_idx = p_begin + 1; con_idx <= p_end; ++con_idx)
+               {
+                 auto& con = m_con_list[con_idx];
+                 if (con.is_greater())
+                   con.convert_greater_to_less();
+               }
+             });
   if (!m_con_list.empty() && m_obj_offset == 0.0)
     m_obj_offset = -m_con_list[0].rhs();
   if (!m_con_list.empty() && m_is_min == -1)
@@ -206,40 +261,28 @@ bool Model_Manager::process_after_read()
       obj_con.set_coeff(i, -obj_con.coeff(i));
     m_obj_offset = -m_obj_offset;
   }
+  const double normalize_time = lap();
   if (!calculate_vars())
   {
     printf("c model is infeasible due to variable bounds.\n");
     return false;
   }
+  const double vars_time = lap();
   if ((m_bound_strengthen == 1 && m_real_num == 0) ||
       m_bound_strengthen == 2)
-    if (!tighten_bounds() || !global_propagation() || !calculate_vars())
+    if (!tighten_bounds() || !global_propagation() ||
+        !activity_propagation() || !calculate_vars())
     {
       printf("c model is infeasible after bound tightening.\n");
       return false;
     }
-  m_type_to_con_idx_list.clear();
-  m_type_to_con_idx_set.clear();
-  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
-  {
-    auto& con = m_con_list[con_idx];
-    if (!con.is_inferred_sat() && con.term_num() == 0 &&
-        empty_con_is_satisfied(con))
-    {
-      con.mark_inferred_sat();
-      m_delete_con_num++;
-    }
-    classify_con(con);
-    if (con.is_inferred_sat())
-      continue;
-    const auto& types = con.get_types();
-    for (Con_Type type : types)
-    {
-      m_type_to_con_idx_list[type].push_back(con_idx);
-      m_type_to_con_idx_set[type].insert(con_idx);
-    }
-  }
+  const double bounds_time = lap();
+  if (m_dup_presolve)
+    remove_duplicates();
+  const double dup_time = lap();
+  classify_cons();
   print_cons_type_summary();
+  const double classify_time = lap();
   m_var_idx_to_obj_idx.resize(m_var_num, SIZE_MAX);
   m_var_obj_cost.resize(m_var_num, 0.0);
   const auto& model_obj = obj();
@@ -252,11 +295,87 @@ bool Model_Manager::process_after_read()
   m_con_is_equality.resize(m_con_num, false);
   for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
     m_con_is_equality[con_idx] = m_con_list[con_idx].is_equality();
+  build_matrix();
+  const double matrix_time = lap();
+  printf("c presolve phases (%zu threads): split eq %.3fs, normalize %.3fs, "
+         "vars %.3fs, bounds %.3fs, duplicates %.3fs, classify %.3fs, "
+         "matrix %.3fs\n",
+         resolve_worker_num(m_presolve_worker_num),
+         split_time,
+         normalize_time,
+         vars_time,
+         bounds_time,
+         dup_time,
+         classify_time,
+         matrix_time);
   return true;
 }
 
+size_t Model_Manager::presolve_parts(size_t p_total) const
+{
+  return std::min(resolve_worker_num(m_presolve_worker_num),
+                  std::max<size_t>(1, p_total / m_min_presolve_slice));
+}
+
+void Model_Manager::build_matrix()
+{
+  m_matrix.build(m_con_list, m_var_list);
+}
+
 bool Model_Manager::calculate_vars()
 {
+  // Each slice classifies its own columns; the slices are merged in
+  // column order, so counts, index lists and the reported infeasible
+  // variable match a serial pass.
+  struct Var_Slice
+  {
+    size_t general_integer_num = 0;
+    size_t binary_num = 0;
+    size_t fixed_num = 0;
+    size_t real_num = 0;
+    std::vector<Model_Idx> binary_idxs;
+    std::vector<Model_Idx> non_fixed_var_idxs;
+    size_t infeasible_var_idx = SIZE_MAX;
+  };
+  const size_t part_num = presolve_parts(m_var_num);
+  std::vector<Var_Slice> slices(part_num);
+  run_slices(
+      m_var_num,
+      part_num,
+      [&](size_t p_part, size_t p_begin, size_t p_end)
+      {
+        Var_Slice& slice = slices[p_part];
+        for (size_t var_idx = p_begin; var_idx < p_end; var_idx++)
+        {
+          auto& model_var = m_var_list[var_idx];
+          if (!canonicalize_var_bounds(model_var))
+          {
+            slice.infeasible_var_idx = var_idx;
+            return;
+          }
+          if (var_is_fixed(model_var))
+          {
+            slice.fixed_num++;
+            set_var_type(model_var, Var_Type::fixed);
+          }
+          else if (var_is_binary(model_var))
+          {
+            slice.binary_num++;
+            set_var_type(model_var, Var_Type::binary);
+            slice.binary_idxs.push_back(static_cast<Model_Idx>(var_idx));
+          }
+          else if (model_var.type() == Var_Type::general_integer)
+            slice.general_integer_num++;
+          else
+          {
+            set_var_type(model_var, Var_Type::real);
+            slice.real_num++;
+          }
+          if (!var_is_fixed(model_var))
+            slice.non_fixed_var_idxs.push_back(
+                static_cast<Model_Idx>(var_idx));
+        }
+      });
   m_general_integer_num = 0;
   m_binary_num = 0;
   m_fixed_num = 0;
@@ -265,37 +384,27 @@ bool Model_Manager::calculate_vars()
   m_non_fixed_var_idxs.clear();
   m_binary_idx_list.reserve(m_var_num);
   m_non_fixed_var_idxs.reserve(m_var_num);
-  for (size_t var_idx = 0; var_idx < m_var_num; var_idx++)
+  for (const Var_Slice& slice : slices)
   {
-    auto& model_var = m_var_list[var_idx];
-    if (!canonicalize_var_bounds(model_var))
+    m_general_integer_num += slice.general_integer_num;
+    m_binary_num += slice.binary_num;
+    m_fixed_num += slice.fixed_num;
+    m_real_num += slice.real_num;
+    m_binary_idx_list.insert(m_binary_idx_list.end(),
+                             slice.binary_idxs.begin(),
+                             slice.binary_idxs.end());
+    m_non_fixed_var_idxs.insert(m_non_fixed_var_idxs.end(),
+                                slice.non_fixed_var_idxs.begin(),
+                                slice.non_fixed_var_idxs.end());
+    if (slice.infeasible_var_idx != SIZE_MAX)
     {
+      const auto& model_var = m_var_list[slice.infeasible_var_idx];
       printf("c infeasible variable bound: %s LB: %.15g; UB: %.15g\n",
              model_var.name().c_str(),
              model_var.lower_bound(),
              model_var.upper_bound());
       return false;
     }
-    if (var_is_fixed(model_var))
-    {
-      m_fixed_num++;
-      set_var_type(model_var, Var_Type::fixed);
-    }
-    else if (var_is_binary(model_var))
-    {
-      m_binary_num++;
-      set_var_type(model_var, Var_Type::binary);
-      m_binary_idx_list.push_back(var_idx);
-    }
-    else if (model_var.type() == Var_Type::general_integer)
-      m_general_integer_num++;
-    else
-    {
-      set_var_type(model_var, Var_Type::real);
-      m_real_num++;
-    }
-    if (!var_is_fixed(model_var))
-      m_non_fixed_var_idxs.push_back(var_idx);
   }
   printf("c fixed: %zu, binary: %zu, general integer: %zu, real: %zu\n",
          m_fixed_num,
@@ -469,10 +578,20 @@ bool Model_Manager::global_propagation()
       set_var_type(model_var, Var_Type::fixed);
       fixed_idxs.push_back(model_var.idx());
     }
-  while (fixed_idxs.size() > 0)
+  if (!eliminate_fixed_vars(fixed_idxs))
+    return false;
+  printf("c delete con num: %zu\n", m_delete_con_num);
+  printf("c delete var num: %zu\n", m_delete_var_num);
+  printf("c infer var num: %zu\n", m_infer_var_num);
+  return true;
+}
+
+bool Model_Manager::eliminate_fixed_vars(std::vector<size_t>& p_fixed_idxs)
+{
+  while (p_fixed_idxs.size() > 0)
   {
-    size_t delete_var_idx = fixed_idxs.back();
-    fixed_idxs.pop_back();
+    size_t delete_var_idx = p_fixed_idxs.back();
+    p_fixed_idxs.pop_back();
     m_delete_var_num++;
     Model_Var& delete_var = m_var_list[delete_var_idx];
     double delete_var_value =
@@ -496,7 +615,7 @@ bool Model_Manager::global_propagation()
               var_is_fixed(related_var))
           {
             set_var_type(related_var, Var_Type::fixed);
-            fixed_idxs.push_back(related_var.idx());
+            p_fixed_idxs.push_back(related_var.idx());
             m_infer_var_num++;
           }
         }
@@ -519,57 +638,590 @@ bool Model_Manager::global_propagation()
         }
       }
     }
+    // Its terms are gone from every row; the column must follow, or the
+    // matrix view would read stale positions.
+    delete_var.resize_terms(0);
   }
-  printf("c delete con num: %zu\n", m_delete_con_num);
-  printf("c delete var num: %zu\n", m_delete_var_num);
-  printf("c infer var num: %zu\n", m_infer_var_num);
   return true;
 }
 
+bool Model_Manager::activity_propagation()
+{
+  // Every live row reads sum(a_j x_j) <= rhs (and >= rhs for an equality
+  // kept whole). The smallest activity of the other terms bounds each x_j;
+  // when a bound moves, the rows of that variable are queued again, until
+  // nothing moves or the work budget is spent.
+  auto is_live = [&](const Model_Con& p_con)
+  { return !p_con.is_inferred_sat() && p_con.term_num() >= 2; };
+  std::vector<size_t> queue;
+  std::vector<char> queued(m_con_num, 0);
+  size_t nnz = 0;
+  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+    if (is_live(m_con_list[con_idx]))
+    {
+      queue.push_back(con_idx);
+      queued[con_idx] = 1;
+      nnz += m_con_list[con_idx].term_num();
+    }
+  const size_t work_limit =
+      k_propagation_work_factor * std::max(nnz, m_con_num);
+  size_t work = 0;
+  size_t row_num = 0;
+  size_t bound_change_num = 0;
+  size_t head = 0;
+  while (head < queue.size() && work < work_limit)
+  {
+    const size_t con_idx = queue[head++];
+    queued[con_idx] = 0;
+    const Model_Con& model_con = m_con_list[con_idx];
+    if (!is_live(model_con))
+      continue;
+    work += model_con.term_num();
+    row_num++;
+    // Finite part and number of infinite contributions of the smallest
+    // and largest activity.
+    double min_sum = 0.0;
+    double max_sum = 0.0;
+    size_t min_inf_num = 0;
+    size_t max_inf_num = 0;
+    for (size_t term_idx = 0; term_idx < model_con.term_num(); ++term_idx)
+    {
+      const double coeff = model_con.coeff(term_idx);
+      const Model_Var& var = m_var_list[model_con.var_idx(term_idx)];
+      const double low = coeff > 0 ? var.lower_bound() : var.upper_bound();
+      const double high = coeff > 0 ? var.upper_bound() : var.lower_bound();
+      if (std::fabs(low) >= k_inf)
+        min_inf_num++;
+      else
+        min_sum += coeff * low;
+      if (std::fabs(high) >= k_inf)
+        max_inf_num++;
+      else
+        max_sum += coeff * high;
+    }
+    const double rhs = model_con.rhs();
+    const double slack = m_feas_tolerance * std::max(1.0, std::fabs(rhs));
+    if ((min_inf_num == 0 && min_sum > rhs + slack) ||
+        (model_con.is_equality() && max_inf_num == 0 &&
+         max_sum < rhs - slack))
+    {
+      printf("c activity propagation failed due to constraint: %s, "
+             "rhs: %lf, min activity: %lf, max activity: %lf\n",
+             model_con.name().c_str(),
+             rhs,
+             min_inf_num == 0 ? min_sum : k_neg_inf,
+             max_inf_num == 0 ? max_sum : k_inf);
+      return false;
+    }
+    for (size_t term_idx = 0; term_idx < model_con.term_num(); ++term_idx)
+    {
+      const double coeff = model_con.coeff(term_idx);
+      Model_Var& var = m_var_list[model_con.var_idx(term_idx)];
+      const double low = coeff > 0 ? var.lower_bound() : var.upper_bound();
+      const double high = coeff > 0 ? var.upper_bound() : var.lower_bound();
+      const bool low_is_inf = std::fabs(low) >= k_inf;
+      const bool high_is_inf = std::fabs(high) >= k_inf;
+      bool changed = false;
+      // sum <= rhs: coeff * x_j <= rhs - (min activity of the rest).
+      if (min_inf_num == 0 || (min_inf_num == 1 && low_is_inf))
+      {
+        const double rest = low_is_inf ? min_sum : min_sum - coeff * low;
+        const double bound = (rhs + slack - rest) / coeff;
+        changed |= coeff > 0 ? propagate_upper_bound(var, bound)
+                             : propagate_lower_bound(var, bound);
+      }
+      // sum >= rhs: coeff * x_j >= rhs - (max activity of the rest).
+      if (model_con.is_equality() &&
+          (max_inf_num == 0 || (max_inf_num == 1 && high_is_inf)))
+      {
+        const double rest = high_is_inf ? max_sum : max_sum - coeff * high;
+        const double bound = (rhs - slack - rest) / coeff;
+        changed |= coeff > 0 ? propagate_lower_bound(var, bound)
+                             : propagate_upper_bound(var, bound);
+      }
+      if (!changed)
+        continue;
+      bound_change_num++;
+      if (var.lower_bound() > var.upper_bound() + m_feas_tolerance)
+      {
+        printf("c activity propagation failed due to variable: %s, "
+               "lower_bound: %lf, upper_bound: %lf\n",
+               var.name().c_str(),
+               var.lower_bound(),
+               var.upper_bound());
+        return false;
+      }
+      for (size_t var_term = 0; var_term < var.term_num(); ++var_term)
+      {
+        const size_t next_con_idx = var.con_idx(var_term);
+        // An inequality row only moves the bound its own pass ignores.
+        if (next_con_idx != 0 &&
+            (next_con_idx != con_idx || model_con.is_equality()) &&
+            !queued[next_con_idx] && is_live(m_con_list[next_con_idx]))
+        {
+          queue.push_back(next_con_idx);
+          queued[next_con_idx] = 1;
+        }
+      }
+    }
+    // Keeps the queue from growing without bound on long runs.
+    if (head > m_con_num)
+    {
+      queue.erase(queue.begin(), queue.begin() + head);
+      head = 0;
+    }
+  }
+  std::vector<size_t> fixed_idxs;
+  for (auto& model_var : m_var_list)
+    if (model_var.type() != Var_Type::fixed && var_is_fixed(model_var))
+    {
+      set_var_type(model_var, Var_Type::fixed);
+      fixed_idxs.push_back(model_var.idx());
+      m_infer_var_num++;
+    }
+  const size_t fixed_num = fixed_idxs.size();
+  if (!eliminate_fixed_vars(fixed_idxs))
+    return false;
+  printf("c activity propagation: %zu bound changes over %zu rows%s, "
+         "%zu variables fixed\n",
+         bound_change_num,
+         row_num,
+         head < queue.size() ? " (work limit reached)" : "",
+         fixed_num);
+  return true;
+}
+
+bool Model_Manager::propagate_upper_bound(Model_Var& p_var, double p_bound)
+{
+  if (p_var.requires_integrality())
+    p_bound = std::floor(p_bound + m_feas_tolerance);
+  else if (std::fabs(p_var.upper_bound()) < k_inf &&
+           p_var.upper_bound() - p_bound <=
+               k_min_bound_change * std::max(1.0, std::fabs(p_bound)))
+    return false;
+  if (p_bound >= p_var.upper_bound() ||
+      std::fabs(p_bound) > k_max_propagated_bound)
+    return false;
+  set_var_upper_bound(p_var, p_bound);
+  return true;
+}
+
+bool Model_Manager::propagate_lower_bound(Model_Var& p_var, double p_bound)
+{
+  if (p_var.requires_integrality())
+    p_bound = std::ceil(p_bound - m_feas_tolerance);
+  else if (std::fabs(p_var.lower_bound()) < k_inf &&
+           p_bound - p_var.lower_bound() <=
+               k_min_bound_change * std::max(1.0, std::fabs(p_bound)))
+    return false;
+  if (p_bound <= p_var.lower_bound() ||
+      std::fabs(p_bound) > k_max_propagated_bound)
+    return false;
+  set_var_lower_bound(p_var, p_bound);
+  return true;
+}
+
+void Model_Manager::remove_duplicates()
+{
+  const size_t row_num = drop_parallel_rows();
+  const size_t column_num = merge_duplicate_columns();
+  if (column_num > 0)
+    calculate_vars();
+  printf("c duplicate presolve: %zu parallel rows dropped, %zu columns "
+         "merged\n",
+         row_num,
+         column_num);
+}
+
+size_t Model_Manager::drop_parallel_rows()
+{
+  // A row divided by the coefficient of its smallest variable index is the
+  // same for every row parallel to it; the hash is taken over that form.
+  std::vector<double> row_scale(m_con_num, 0.0);
+  std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+  {
+    const Model_Con& model_con = m_con_list[con_idx];
+    if (model_con.is_inferred_sat() || model_con.term_num() == 0)
+      continue;
+    size_t first_term = 0;
+    for (size_t term_idx = 1; term_idx < model_con.term_num(); ++term_idx)
+      if (model_con.var_idx(term_idx) < model_con.var_idx(first_term))
+        first_term = term_idx;
+    const double scale = model_con.coeff(first_term);
+    uint64_t hash = mix_hash(model_con.term_num());
+    for (size_t term_idx = 0; term_idx < model_con.term_num(); ++term_idx)
+    {
+      const double ratio = model_con.coeff(term_idx) / scale;
+      hash += mix_hash(model_con.var_idx(term_idx) ^
+                       mix_hash(static_cast<uint64_t>(
+                           std::llround(ratio * k_parallel_hash_scale))));
+    }
+    row_scale[con_idx] = scale;
+    buckets[hash].push_back(con_idx);
+  }
+
+  std::vector<double> ratio_of(m_var_num, 0.0);
+  std::vector<size_t> stamp_of(m_var_num, SIZE_MAX);
+  auto is_parallel = [&](size_t p_rep_idx, size_t p_con_idx)
+  {
+    const Model_Con& rep = m_con_list[p_rep_idx];
+    const Model_Con& model_con = m_con_list[p_con_idx];
+    if (rep.term_num() != model_con.term_num())
+      return false;
+    for (size_t term_idx = 0; term_idx < rep.term_num(); ++term_idx)
+    {
+      stamp_of[rep.var_idx(term_idx)] = p_rep_idx;
+      ratio_of[rep.var_idx(term_idx)] =
+          rep.coeff(term_idx) / row_scale[p_rep_idx];
+    }
+    for (size_t term_idx = 0; term_idx < model_con.term_num(); ++term_idx)
+    {
+      const size_t var_idx = model_con.var_idx(term_idx);
+      const double ratio =
+          model_con.coeff(term_idx) / row_scale[p_con_idx];
+      if (stamp_of[var_idx] != p_rep_idx ||
+          std::fabs(ratio - ratio_of[var_idx]) >
+              k_parallel_tolerance * std::max(1.0, std::fabs(ratio)))
+        return false;
+    }
+    return true;
+  };
+
+  // In a class of parallel rows, row r reads t <= upper or t >= lower on
+  // t = row / scale, widened by its own tolerance. A row is dropped only
+  // when a kept row of the class implies it.
+  size_t dropped_num = 0;
+  auto reduce_class = [&](const std::vector<size_t>& p_class)
+  {
+    auto lower_of = [&](size_t p_con_idx)
+    {
+      const Model_Con& model_con = m_con_list[p_con_idx];
+      const double scale = row_scale[p_con_idx];
+      if (!model_con.is_equality() && scale > 0)
+        return k_neg_inf;
+      return model_con.rhs() / scale - m_feas_tolerance / std::fabs(scale);
+    };
+    auto upper_of = [&](size_t p_con_idx)
+    {
+      const Model_Con& model_con = m_con_list[p_con_idx];
+      const double scale = row_scale[p_con_idx];
+      if (!model_con.is_equality() && scale < 0)
+        return k_inf;
+      return model_con.rhs() / scale + m_feas_tolerance / std::fabs(scale);
+    };
+    size_t best_upper = SIZE_MAX;
+    size_t best_lower = SIZE_MAX;
+    for (size_t con_idx : p_class)
+    {
+      if (upper_of(con_idx) < k_inf &&
+          (best_upper == SIZE_MAX || upper_of(con_idx) < upper_of(best_upper)))
+        best_upper = con_idx;
+      if (lower_of(con_idx) > k_neg_inf &&
+          (best_lower == SIZE_MAX || lower_of(con_idx) > lower_of(best_lower)))
+        best_lower = con_idx;
+    }
+    for (size_t con_idx : p_class)
+    {
+      if (con_idx == best_upper || con_idx == best_lower)
+        continue;
+      // An equality also bounds the other side; it may only go when both
+      // of its sides are implied.
+      const bool upper_implied = upper_of(con_idx) >= k_inf ||
+                                 (best_upper != SIZE_MAX &&
+                                  upper_of(best_upper) <= upper_of(con_idx));
+      const bool lower_implied = lower_of(con_idx) <= k_neg_inf ||
+                                 (best_lower != SIZE_MAX &&
+                                  lower_of(best_lower) >= lower_of(con_idx));
+      if (upper_implied && lower_implied)
+      {
+        drop_con(m_con_list[con_idx]);
+        dropped_num++;
+      }
+    }
+  };
+
+  std::vector<std::vector<size_t>> classes;
+  for (const auto& [hash, con_idxs] : buckets)
+  {
+    if (con_idxs.size() < 2)
+      continue;
+    classes.clear();
+    for (size_t con_idx : con_idxs)
+    {
+      bool placed = false;
+      for (auto& parallel_class : classes)
+        if (is_parallel(parallel_class.front(), con_idx))
+        {
+          parallel_class.push_back(con_idx);
+          placed = true;
+          break;
+        }
+      if (!placed)
+        classes.push_back({con_idx});
+    }
+    for (const auto& parallel_class : classes)
+      if (parallel_class.size() > 1)
+        reduce_class(parallel_class);
+  }
+  return dropped_num;
+}
+
+void Model_Manager::drop_con(Model_Con& p_con)
+{
+  for (size_t term_idx = p_con.term_num(); term_idx-- > 0;)
+    m_var_list[p_con.var_idx(term_idx)].delete_term_at(
+        p_con.pos_in_var(term_idx), this);
+  p_con.resize_terms(0);
+  p_con.set_rhs(0.0);
+  p_con.mark_inferred_sat();
+  m_delete_con_num++;
+}
+
+size_t Model_Manager::merge_duplicate_columns()
+{
+  // Columns are equal when they hold the same coefficients (objective
+  // included) in the same rows and agree on integrality.
+  std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+  for (size_t var_idx = 0; var_idx < m_var_num; ++var_idx)
+  {
+    const Model_Var& model_var = m_var_list[var_idx];
+    if (model_var.type() == Var_Type::fixed || model_var.term_num() == 0)
+      continue;
+    uint64_t hash = mix_hash(model_var.term_num() * 2 +
+                             model_var.requires_integrality());
+    for (size_t term_idx = 0; term_idx < model_var.term_num(); ++term_idx)
+    {
+      const size_t con_idx = model_var.con_idx(term_idx);
+      const double coeff =
+          m_con_list[con_idx].coeff(model_var.pos_in_con(term_idx));
+      hash += mix_hash(con_idx ^ mix_hash(std::bit_cast<uint64_t>(coeff)));
+    }
+    buckets[hash].push_back(var_idx);
+  }
+
+  std::vector<double> coeff_of(m_con_num, 0.0);
+  std::vector<size_t> stamp_of(m_con_num, SIZE_MAX);
+  auto is_duplicate = [&](size_t p_rep_idx, size_t p_var_idx)
+  {
+    const Model_Var& rep = m_var_list[p_rep_idx];
+    const Model_Var& model_var = m_var_list[p_var_idx];
+    if (rep.term_num() != model_var.term_num() ||
+        rep.requires_integrality() != model_var.requires_integrality())
+      return false;
+    for (size_t term_idx = 0; term_idx < rep.term_num(); ++term_idx)
+    {
+      const size_t con_idx = rep.con_idx(term_idx);
+      stamp_of[con_idx] = p_rep_idx;
+      coeff_of[con_idx] = m_con_list[con_idx].coeff(rep.pos_in_con(term_idx));
+    }
+    for (size_t term_idx = 0; term_idx < model_var.term_num(); ++term_idx)
+    {
+      const size_t con_idx = model_var.con_idx(term_idx);
+      if (stamp_of[con_idx] != p_rep_idx ||
+          coeff_of[con_idx] !=
+              m_con_list[con_idx].coeff(model_var.pos_in_con(term_idx)))
+        return false;
+    }
+    return true;
+  };
+
+  // Buckets are visited in column order, so the merge records, and with
+  // them the postsolve, do not depend on the hash map layout.
+  std::vector<std::vector<size_t>> groups;
+  for (const auto& [hash, var_idxs] : buckets)
+    if (var_idxs.size() > 1)
+      groups.push_back(var_idxs);
+  std::sort(groups.begin(), groups.end());
+  size_t merged_num = 0;
+  std::vector<size_t> reps;
+  for (const auto& group : groups)
+  {
+    reps.clear();
+    for (size_t var_idx : group)
+    {
+      bool merged = false;
+      for (size_t rep_idx : reps)
+        if (is_duplicate(rep_idx, var_idx))
+        {
+          merge_columns(m_var_list[rep_idx], m_var_list[var_idx]);
+          merged_num++;
+          merged = true;
+          break;
+        }
+      if (!merged)
+        reps.push_back(var_idx);
+    }
+  }
+  return merged_num;
+}
+
+void Model_Manager::merge_columns(Model_Var& p_kept, Model_Var& p_removed)
+{
+  m_column_merges.push_back({static_cast<Model_Idx>(p_kept.idx()),
+                             static_cast<Model_Idx>(p_removed.idx()),
+                             p_kept.lower_bound(),
+                             p_kept.upper_bound(),
+                             p_removed.lower_bound(),
+                             p_removed.upper_bound()});
+  for (size_t term_idx = p_removed.term_num(); term_idx-- > 0;)
+    m_con_list[p_removed.con_idx(term_idx)].delete_term_at(
+        p_removed.pos_in_con(term_idx), 0.0, this);
+  p_removed.resize_terms(0);
+  set_var_lower_bound(p_removed, 0.0);
+  set_var_upper_bound(p_removed, 0.0);
+  set_var_type(p_removed, Var_Type::fixed);
+  const Column_Merge& merge = m_column_merges.back();
+  // Two binaries sum to a general integer in [0, 2].
+  if (p_kept.requires_integrality())
+    set_var_type(p_kept, Var_Type::general_integer);
+  set_var_lower_bound(p_kept,
+                      add_bounds(merge.kept_lower, merge.removed_lower));
+  set_var_upper_bound(p_kept,
+                      add_bounds(merge.kept_upper, merge.removed_upper));
+}
+
+void Model_Manager::postsolve_values(std::vector<double>& p_values) const
+{
+  // Undone last to first: a kept column may itself be the sum of an
+  // earlier merge.
+  for (auto merge = m_column_merges.rbegin(); merge != m_column_merges.rend();
+       ++merge)
+  {
+    const double sum = p_values[merge->kept_idx];
+    // The removed column takes a finite bound of its own and the kept
+    // column the rest, clamped into its domain; the removed column then
+    // absorbs the remainder, which stays inside its domain.
+    double removed_anchor = 0.0;
+    if (is_finite_bound(merge->removed_lower))
+      removed_anchor = merge->removed_lower;
+    else if (is_finite_bound(merge->removed_upper))
+      removed_anchor = merge->removed_upper;
+    const double kept_value = std::clamp(
+        sum - removed_anchor, merge->kept_lower, merge->kept_upper);
+    p_values[merge->kept_idx] = kept_value;
+    p_values[merge->removed_idx] = sum - kept_value;
+  }
+}
+
+void Model_Manager::presolve_values(std::vector<double>& p_values,
+                                    std::vector<char>* p_mask) const
+{
+  auto loaded = [&](size_t p_var_idx)
+  { return p_mask == nullptr || p_mask->empty() || (*p_mask)[p_var_idx]; };
+  auto closest_to_zero = [](double p_lower, double p_upper)
+  { return std::clamp(0.0, p_lower, p_upper); };
+  for (const Column_Merge& merge : m_column_merges)
+  {
+    if (!loaded(merge.kept_idx) && !loaded(merge.removed_idx))
+      continue;
+    const double kept_value =
+        loaded(merge.kept_idx)
+            ? p_values[merge.kept_idx]
+            : closest_to_zero(merge.kept_lower, merge.kept_upper);
+    const double removed_value =
+        loaded(merge.removed_idx)
+            ? p_values[merge.removed_idx]
+            : closest_to_zero(merge.removed_lower, merge.removed_upper);
+    p_values[merge.kept_idx] = kept_value + removed_value;
+    p_values[merge.removed_idx] = 0.0;
+    if (p_mask != nullptr && !p_mask->empty())
+    {
+      (*p_mask)[merge.kept_idx] = 1;
+      (*p_mask)[merge.removed_idx] = 1;
+    }
+  }
+}
+
 void Model_Manager::convert_eq_to_ineq()
 {
   const size_t original_con_num = m_con_list.size();
-  size_t equality_count = 0;
+  std::vector<size_t> source_idxs;
   for (size_t con_idx = 1; con_idx < original_con_num; ++con_idx)
   {
     if (m_con_list[con_idx].is_equality())
-      equality_count++;
+      source_idxs.push_back(con_idx);
   }
+  const size_t equality_count = source_idxs.size();
   if (equality_count == 0)
     return;
-  m_con_list.reserve(m_con_list.size() + equality_count);
-  for (size_t con_idx = 1; con_idx < original_con_num; ++con_idx)
+  if (original_con_num + equality_count > k_null_idx)
+    throw Solver_Error("constraint count exceeds the index width");
+  // Names are picked serially: a copy may collide with an earlier one.
+  std::vector<Model_Idx> copy_idx(original_con_num, k_null_idx);
+  m_con_list.reserve(original_con_num + equality_count);
+  for (size_t source_idx : source_idxs)
   {
-    Model_Con& con = m_con_list[con_idx];
-    if (!con.is_equality())
-      continue;
-    con.convert_equality_to_less();
-    append_negated_con(con);
+    const size_t new_con_idx = m_con_list.size();
+    copy_idx[source_idx] = static_cast<Model_Idx>(new_con_idx);
+    std::string new_name =
+        make_duplicate_constraint_name(m_con_list[source_idx].name());
+    m_con_list.emplace_back(new_name, new_con_idx, '<');
+    m_con_name_to_idx.emplace(std::move(new_name), new_con_idx);
   }
+  // Each copy negates its source row. Positions in the columns are filled
+  // by the column pass below.
+  run_slices(equality_count,
+             presolve_parts(equality_count),
+             [&](size_t, size_t p_begin, size_t p_end)
+             {
+               for (size_t copy = p_begin; copy < p_end; ++copy)
+               {
+                 Model_Con& source = m_con_list[source_idxs[copy]];
+                 Model_Con& new_con = m_con_list[original_con_num + copy];
+                 new_con.set_rhs(-source.rhs());
+                 new_con.resize_terms(source.term_num());
+                 for (size_t term_idx = 0; term_idx < source.term_num();
+                      ++term_idx)
+                   new_con.set_term(term_idx,
+                                    source.var_idx(term_idx),
+                                    -source.coeff(term_idx),
+                                    0);
+                 source.convert_equality_to_less();
+               }
+             });
+  // A column gains its copy terms in copy order and, within a copy, in
+  // row order, exactly as appending the copies one after another does.
+  run_slices(
+      m_var_list.size(),
+      presolve_parts(m_var_list.size()),
+      [&](size_t, size_t p_begin, size_t p_end)
+      {
+        std::vector<std::pair<Model_Idx, Model_Idx>> copy_terms;
+        for (size_t var_idx = p_begin; var_idx < p_end; ++var_idx)
+        {
+          Model_Var& var = m_var_list[var_idx];
+          copy_terms.clear();
+          for (size_t term_idx = 0; term_idx < var.term_num(); ++term_idx)
+          {
+            const size_t con_idx = var.con_idx(term_idx);
+            if (copy_idx[con_idx] != k_null_idx)
+              copy_terms.emplace_back(
+                  copy_idx[con_idx],
+                  static_cast<Model_Idx>(var.pos_in_con(term_idx)));
+          }
+          if (copy_terms.empty())
+            continue;
+          std::sort(copy_terms.begin(), copy_terms.end());
+          const size_t first_term = var.term_num();
+          var.resize_terms(first_term + copy_terms.size());
+          for (size_t idx = 0; idx < copy_terms.size(); ++idx)
+          {
+            const auto [con_idx, pos_in_con] = copy_terms[idx];
+            Model_Con& new_con = m_con_list[con_idx];
+            var.set_term(first_term + idx, con_idx, pos_in_con);
+            new_con.set_term(pos_in_con,
+                             var_idx,
+                             new_con.coeff(pos_in_con),
+                             first_term + idx);
+          }
+        }
+      });
   printf(
       "c converted %zu equality constraints to inequality constraints\n",
       equality_count);
 }
 
-void Model_Manager::append_negated_con(const Model_Con& p_source)
-{
-  const size_t new_con_idx = m_con_list.size();
-  std::string new_name = make_duplicate_constraint_name(p_source.name());
-  m_con_list.emplace_back(new_name, new_con_idx, '<');
-  m_con_name_to_idx.emplace(new_name, new_con_idx);
-  Model_Con& new_con = m_con_list.back();
-  new_con.set_rhs(-p_source.rhs());
-  const size_t term_num = p_source.term_num();
-  for (size_t term_idx = 0; term_idx < term_num; ++term_idx)
-  {
-    const size_t var_idx = p_source.var_idx(term_idx);
-    Model_Var& var = m_var_list[var_idx];
-    const double coeff = -p_source.coeff(term_idx);
-    var.add_con(new_con_idx, new_con.term_num());
-    new_con.add_var(var_idx, coeff, var.term_num() - 1);
-  }
-}
-
 std::string Model_Manager::make_duplicate_constraint_name(
     const std::string& p_base) const
 {
@@ -669,6 +1321,46 @@ void Model_Manager::print_cons_type_summary() const
   print_border();
 }
 
+void Model_Manager::classify_cons()
+{
+  // Rows are classified in parallel; the type index is then built in row
+  // order so its lists and sets are filled as a serial pass fills them.
+  const size_t row_num = m_con_num > 0 ? m_con_num - 1 : 0;
+  const size_t part_num = presolve_parts(row_num);
+  std::vector<size_t> deleted_nums(part_num, 0);
+  run_slices(row_num,
+             part_num,
+             [&](size_t p_part, size_t p_begin, size_t p_end)
+             {
+               for (size_t con_idx = p_begin + 1; con_idx <= p_end; ++con_idx)
+               {
+                 auto& con = m_con_list[con_idx];
+                 if (!con.is_inferred_sat() && con.term_num() == 0 &&
+                     empty_con_is_satisfied(con))
+                 {
+                   con.mark_inferred_sat();
+                   deleted_nums[p_part]++;
+                 }
+                 classify_con(con);
+               }
+             });
+  for (size_t deleted_num : deleted_nums)
+    m_delete_con_num += deleted_num;
+  m_type_to_con_idx_list.clear();
+  m_type_to_con_idx_set.clear();
+  for (size_t con_idx = 1; con_idx < m_con_num; ++con_idx)
+  {
+    const auto& con = m_con_list[con_idx];
+    if (con.is_inferred_sat())
+      continue;
+    for (Con_Type type : con.get_types())
+    {
+      m_type_to_con_idx_list[type].push_back(con_idx);
+      m_type_to_con_idx_set[type].insert(con_idx);
+    }
+  }
+}
+
 void Model_Manager::classify_con(Model_Con& p_con)
 {
   const size_t term_count = p_con.term_num();
@@ -14,6 +14,7 @@
 #pragma once
 #include "../utils/global_defs.h"
 #include "Model_Con.h"
+#include "Model_Matrix.h"
 #include "Model_Var.h"
 #include <cassert>
 #include <cmath>
@@ -25,9 +26,28 @@
 #include <unordered_set>
 #include <vector>
 
+// A duplicate column folded into another by presolve. The kept column
+// carries the sum of both; the bounds are those from before the merge.
+struct Column_Merge
+{
+  Model_Idx kept_idx;
+
+  Model_Idx removed_idx;
+
+  double kept_lower;
+
+  double kept_upper;
+
+  double removed_lower;
+
+  double removed_upper;
+};
+
 class Model_Manager
 {
 private:
+  friend class Model_Snapshot;
+
   int m_bound_strengthen;
 
   double m_feas_tolerance;
@@ -46,14 +66,16 @@ private:
 
   std::vector<Model_Var> m_var_list;
 
-  std::vector<size_t> m_binary_idx_list;
+  std::vector<Model_Idx> m_binary_idx_list;
 
   std::vector<bool> m_con_is_equality;
 
-  std::vector<size_t> m_non_fixed_var_idxs;
+  std::vector<Model_Idx> m_non_fixed_var_idxs;
 
   std::vector<double> m_var_obj_cost;
 
+  Model_Matrix m_matrix;
+
   int m_is_min;
 
   double m_obj_offset;
@@ -83,6 +105,32 @@ private:
 
   bool m_split_eq;
 
+  bool m_dup_presolve;
+
+  std::vector<Column_Merge> m_column_merges;
+
+  size_t m_presolve_worker_num;
+
+  size_t m_min_presolve_slice;
+
+  // Rows or columns per presolve slice below which no thread is spawned.
+  static constexpr size_t k_min_presolve_slice = 4096;
+
+  // Activity propagation stops after visiting this many terms per nonzero.
+  static constexpr size_t k_propagation_work_factor = 10;
+
+  // Relative change below which a continuous bound is left alone.
+  static constexpr double k_min_bound_change = 1e-3;
+
+  // Derived bounds beyond this magnitude only add round-off.
+  static constexpr double k_max_propagated_bound = 1e9;
+
+  // Parallel-row hashing rounds coefficient ratios to this many steps per
+  // unit; candidates are then compared with k_parallel_tolerance.
+  static constexpr double k_parallel_hash_scale = 1e9;
+
+  static constexpr double k_parallel_tolerance = 1e-12;
+
 public:
   explicit Model_Manager(
       double p_feas_tolerance = k_default_feas_tolerance,
@@ -120,6 +168,14 @@ public:
 
   inline void set_split_eq(bool p_enable);
 
+  // Drops rows implied by a parallel row and merges identical columns.
+  inline void set_dup_presolve(bool p_enable);
+
+  // Threads for the row and column passes of process_after_read(); 0 uses
+  // std::thread::hardware_concurrency(). The model is the same for every
+  // setting.
+  inline void set_presolve_workers(size_t p_worker_num);
+
   inline void set_feas_tolerance(double p_value);
 
   inline void set_zero_tolerance(double p_value);
@@ -130,6 +186,16 @@ public:
 
   bool process_after_read();
 
+  // Maps values of the presolved columns back to the original columns.
+  void postsolve_values(std::vector<double>& p_values) const;
+
+  // Maps values of the original columns onto the presolved columns. With a
+  // mask, only loaded values count; merged columns become loaded.
+  void presolve_values(std::vector<double>& p_values,
+                       std::vector<char>* p_mask = nullptr) const;
+
+  void build_matrix();
+
   inline const std::string& get_obj_name() const;
 
   inline const Model_Var& var(const size_t p_idx) const;
@@ -158,6 +224,12 @@ public:
 
   inline bool split_eq() const;
 
+  inline bool dup_presolve() const;
+
+  inline const std::vector<Column_Merge>& column_merges() const;
+
+  inline size_t presolve_workers() const;
+
   inline double feas_tolerance() const;
 
   inline double zero_tolerance() const;
@@ -167,18 +239,23 @@ public:
   inline const std::unordered_map<std::string, size_t>&
   var_name_to_idx() const;
 
+  inline const std::unordered_map<std::string, size_t>&
+  con_name_to_idx() const;
+
   inline bool exists_var(const std::string& p_name) const;
 
   inline size_t con_idx(const std::string& p_name) const;
 
-  inline const std::vector<size_t>& binary_idx_list() const;
+  inline const std::vector<Model_Idx>& binary_idx_list() const;
 
   inline const std::vector<bool>& con_is_equality() const;
 
-  inline const std::vector<size_t>& non_fixed_var_idxs() const;
+  inline const std::vector<Model_Idx>& non_fixed_var_idxs() const;
 
   inline const std::vector<double>& var_obj_cost() const;
 
+  inline const Model_Matrix& matrix() const;
+
 private:
   void normalize_integral_bounds(Model_Var& p_var) const;
 
@@ -194,17 +271,37 @@ private:
 
   bool global_propagation();
 
+  bool eliminate_fixed_vars(std::vector<size_t>& p_fixed_idxs);
+
+  bool activity_propagation();
+
+  bool propagate_upper_bound(Model_Var& p_var, double p_bound);
+
+  bool propagate_lower_bound(Model_Var& p_var, double p_bound);
+
   bool calculate_vars();
 
+  void remove_duplicates();
+
+  size_t drop_parallel_rows();
+
+  size_t merge_duplicate_columns();
+
+  void drop_con(Model_Con& p_con);
+
+  void merge_columns(Model_Var& p_kept, Model_Var& p_removed);
+
   bool singleton_deduction(Model_Con& p_con);
 
   void classify_con(Model_Con& p_con);
 
   void print_cons_type_summary() const;
 
+  size_t presolve_parts(size_t p_total) const;
+
   void convert_eq_to_ineq();
 
-  void append_negated_con(const Model_Con& p_source);
+  void classify_cons();
 
   std::string
   make_duplicate_constraint_name(const std::string& p_base) const;
@@ -265,6 +362,21 @@ inline bool Model_Manager::split_eq() const
   return m_split_eq;
 }
 
+inline bool Model_Manager::dup_presolve() const
+{
+  return m_dup_presolve;
+}
+
+inline const std::vector<Column_Merge>& Model_Manager::column_merges() const
+{
+  return m_column_merges;
+}
+
+inline size_t Model_Manager::presolve_workers() const
+{
+  return m_presolve_worker_num;
+}
+
 inline double Model_Manager::feas_tolerance() const
 {
   return m_feas_tolerance;
@@ -287,6 +399,12 @@ Model_Manager::var_name_to_idx() const
   return m_var_name_to_idx;
 }
 
+inline const std::unordered_map<std::string, size_t>&
+Model_Manager::con_name_to_idx() const
+{
+  return m_con_name_to_idx;
+}
+
 inline bool Model_Manager::exists_var(const std::string& p_name) const
 {
   return m_var_name_to_idx.find(p_name) != m_var_name_to_idx.end();
@@ -374,6 +492,16 @@ inline void Model_Manager::set_split_eq(bool p_enable)
   m_split_eq = p_enable;
 }
 
+inline void Model_Manager::set_dup_presolve(bool p_enable)
+{
+  m_dup_presolve = p_enable;
+}
+
+inline void Model_Manager::set_presolve_workers(size_t p_worker_num)
+{
+  m_presolve_worker_num = p_worker_num;
+}
+
 inline void Model_Manager::set_feas_tolerance(double p_value)
 {
   m_feas_tolerance = p_value;
@@ -384,7 +512,7 @@ inline void Model_Manager::set_zero_tolerance(double p_value)
   m_zero_tolerance = p_value;
 }
 
-inline const std::vector<size_t>& Model_Manager::binary_idx_list() const
+inline const std::vector<Model_Idx>& Model_Manager::binary_idx_list() const
 {
   return m_binary_idx_list;
 }
@@ -394,7 +522,8 @@ inline const std::vector<bool>& Model_Manager::con_is_equality() const
   return m_con_is_equality;
 }
 
-inline const std::vector<size_t>& Model_Manager::non_fixed_var_idxs() const
+inline const std::vector<Model_Idx>&
+Model_Manager::non_fixed_var_idxs() const
 {
   return m_non_fixed_var_idxs;
 }
@@ -403,3 +532,8 @@ inline const std::vector<double>& Model_Manager::var_obj_cost() const
 {
   return m_var_obj_cost;
 }
+
+inline const Model_Matrix& Model_Manager::matrix() const
+{
+  return m_matrix;
+}
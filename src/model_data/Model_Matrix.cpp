@@ -0,0 +1,63 @@
+/*=====================================================================================
+
+    Filename:     Model_Matrix.cpp
+
+    Description:  Immutable flat CSR/CSC view of the constraint matrix
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "Model_Matrix.h"
+#include <cstddef>
+#include <vector>
+
+void Model_Matrix::build(const std::vector<Model_Con>& p_con_list,
+                         const std::vector<Model_Var>& p_var_list)
+{
+  clear();
+  size_t row_nnz = 0;
+  for (const auto& model_con : p_con_list)
+    row_nnz += model_con.term_num();
+  size_t col_nnz = 0;
+  for (const auto& model_var : p_var_list)
+    col_nnz += model_var.term_num();
+  assert(row_nnz == col_nnz);
+
+  m_row_begin.reserve(p_con_list.size() + 1);
+  m_row_var_idxs.reserve(row_nnz);
+  m_row_coeffs.reserve(row_nnz);
+  m_row_begin.push_back(0);
+  for (const auto& model_con : p_con_list)
+  {
+    const auto& var_idxs = model_con.var_idx_set();
+    const auto& coeffs = model_con.coeff_set();
+    m_row_var_idxs.insert(
+        m_row_var_idxs.end(), var_idxs.begin(), var_idxs.end());
+    m_row_coeffs.insert(m_row_coeffs.end(), coeffs.begin(), coeffs.end());
+    m_row_begin.push_back(m_row_var_idxs.size());
+  }
+
+  m_col_begin.reserve(p_var_list.size() + 1);
+  m_col_terms.reserve(col_nnz);
+  m_col_begin.push_back(0);
+  for (const auto& model_var : p_var_list)
+  {
+    for (size_t term_idx = 0; term_idx < model_var.term_num(); ++term_idx)
+    {
+      const size_t con_idx = model_var.con_idx(term_idx);
+      const size_t pos_in_con = model_var.pos_in_con(term_idx);
+      m_col_terms.push_back({static_cast<Model_Idx>(con_idx),
+                             p_con_list[con_idx].coeff(pos_in_con)});
+    }
+    m_col_begin.push_back(m_col_terms.size());
+  }
+}
+
+void Model_Matrix::clear()
+{
+  m_row_begin.clear();
+  m_row_var_idxs.clear();
+  m_row_coeffs.clear();
+  m_col_begin.clear();
+  m_col_terms.clear();
+}
@@ -0,0 +1,125 @@
+/*=====================================================================================
+
+    Filename:     Model_Matrix.h
+
+    Description:  Immutable flat CSR/CSC view of the constraint matrix
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include "../utils/global_defs.h"
+#include "Model_Con.h"
+#include "Model_Var.h"
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Row 0 is the objective, matching Model_Manager::con(0). Row terms keep
+// the order of Model_Con::var_idx_set() and column terms keep the order of
+// Model_Var::con_idx_set(), so kernels switched to this view visit terms
+// in exactly the same sequence as before.
+class Model_Matrix
+{
+public:
+  struct Col_Term
+  {
+    Model_Idx con_idx;
+
+    double coeff;
+  };
+
+  Model_Matrix() = default;
+
+  void build(const std::vector<Model_Con>& p_con_list,
+             const std::vector<Model_Var>& p_var_list);
+
+  void clear();
+
+  inline size_t row_num() const;
+
+  inline size_t col_num() const;
+
+  inline size_t nnz() const;
+
+  inline bool empty() const;
+
+  inline size_t row_size(size_t p_con_idx) const;
+
+  inline std::span<const Model_Idx> row_var_idxs(size_t p_con_idx) const;
+
+  inline std::span<const double> row_coeffs(size_t p_con_idx) const;
+
+  inline size_t col_size(size_t p_var_idx) const;
+
+  inline std::span<const Col_Term> col(size_t p_var_idx) const;
+
+private:
+  std::vector<size_t> m_row_begin;
+
+  std::vector<Model_Idx> m_row_var_idxs;
+
+  std::vector<double> m_row_coeffs;
+
+  std::vector<size_t> m_col_begin;
+
+  std::vector<Col_Term> m_col_terms;
+};
+
+inline size_t Model_Matrix::row_num() const
+{
+  return m_row_begin.empty() ? 0 : m_row_begin.size() - 1;
+}
+
+inline size_t Model_Matrix::col_num() const
+{
+  return m_col_begin.empty() ? 0 : m_col_begin.size() - 1;
+}
+
+inline size_t Model_Matrix::nnz() const
+{
+  return m_row_var_idxs.size();
+}
+
+inline bool Model_Matrix::empty() const
+{
+  return m_row_begin.empty();
+}
+
+inline size_t Model_Matrix::row_size(size_t p_con_idx) const
+{
+  assert(p_con_idx + 1 < m_row_begin.size());
+  return m_row_begin[p_con_idx + 1] - m_row_begin[p_con_idx];
+}
+
+inline std::span<const Model_Idx>
+Model_Matrix::row_var_idxs(size_t p_con_idx) const
+{
+  assert(p_con_idx + 1 < m_row_begin.size());
+  return {m_row_var_idxs.data() + m_row_begin[p_con_idx],
+          m_row_begin[p_con_idx + 1] - m_row_begin[p_con_idx]};
+}
+
+inline std::span<const double>
+Model_Matrix::row_coeffs(size_t p_con_idx) const
+{
+  assert(p_con_idx + 1 < m_row_begin.size());
+  return {m_row_coeffs.data() + m_row_begin[p_con_idx],
+          m_row_begin[p_con_idx + 1] - m_row_begin[p_con_idx]};
+}
+
+inline size_t Model_Matrix::col_size(size_t p_var_idx) const
+{
+  assert(p_var_idx + 1 < m_col_begin.size());
+  return m_col_begin[p_var_idx + 1] - m_col_begin[p_var_idx];
+}
+
+inline std::span<const Model_Matrix::Col_Term>
+Model_Matrix::col(size_t p_var_idx) const
+{
+  assert(p_var_idx + 1 < m_col_begin.size());
+  return {m_col_terms.data() + m_col_begin[p_var_idx],
+          m_col_begin[p_var_idx + 1] - m_col_begin[p_var_idx]};
+}
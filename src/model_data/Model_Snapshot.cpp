@@ -0,0 +1,691 @@
+/*=====================================================================================
+
+    Filename:     Model_Snapshot.cpp
+
+    Description:  Versioned binary snapshot of a prepared Model_Manager
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "../reader/Mapped_File.h"
+#include "../utils/solver_error.h"
+#include "Model_Con.h"
+#include "Model_Snapshot.h"
+#include "Model_Var.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr char k_magic[8] = {'L', 'M', 'I', 'P', 'S', 'N', 'A', 'P'};
+
+constexpr uint32_t k_endian_tag = 0x01020304;
+
+struct Snapshot_Header
+{
+  char magic[8];
+
+  uint32_t version;
+
+  uint32_t endian_tag;
+
+  uint32_t index_bytes;
+
+  uint32_t reserved;
+
+  uint64_t payload_size;
+
+  uint64_t checksum;
+};
+
+static_assert(sizeof(Snapshot_Header) == 40);
+
+class Snapshot_Writer
+{
+public:
+  template <typename T> void value(T p_value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    append(&p_value, sizeof(T));
+  }
+
+  template <typename T> void array(const T* p_data, size_t p_size)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    value<uint64_t>(p_size);
+    append(p_data, p_size * sizeof(T));
+  }
+
+  template <typename T> void array(const std::vector<T>& p_values)
+  {
+    array(p_values.data(), p_values.size());
+  }
+
+  void text(const std::string& p_text)
+  {
+    array(p_text.data(), p_text.size());
+  }
+
+  // Names as an offset table plus one character blob.
+  template <typename Name_Of>
+  void names(size_t p_size, const Name_Of& p_name_of)
+  {
+    std::vector<uint64_t> offsets(p_size + 1, 0);
+    std::string blob;
+    for (size_t idx = 0; idx < p_size; ++idx)
+    {
+      blob += p_name_of(idx);
+      offsets[idx + 1] = blob.size();
+    }
+    array(offsets);
+    text(blob);
+  }
+
+  const std::string& payload() const
+  {
+    return m_payload;
+  }
+
+private:
+  std::string m_payload;
+
+  void append(const void* p_data, size_t p_size)
+  {
+    m_payload.append(static_cast<const char*>(p_data), p_size);
+    m_payload.resize((m_payload.size() + 7) & ~size_t(7), '\0');
+  }
+};
+
+class Snapshot_Cursor
+{
+public:
+  explicit Snapshot_Cursor(std::string_view p_payload)
+      : m_payload(p_payload), m_pos(0)
+  {
+  }
+
+  template <typename T> T value()
+  {
+    T result;
+    take(&result, sizeof(T));
+    return result;
+  }
+
+  template <typename T> void array(std::vector<T>& p_values)
+  {
+    const uint64_t size = value<uint64_t>();
+    if (size > (m_payload.size() - m_pos) / sizeof(T))
+      throw Solver_Error("model snapshot is truncated");
+    p_values.resize(size);
+    take(p_values.data(), size * sizeof(T));
+  }
+
+  std::string text()
+  {
+    std::vector<char> chars;
+    array(chars);
+    return std::string(chars.begin(), chars.end());
+  }
+
+  std::vector<std::string> names()
+  {
+    std::vector<uint64_t> offsets;
+    array(offsets);
+    const std::string blob = text();
+    offsets_in_range(offsets, blob.size());
+    std::vector<std::string> result;
+    result.reserve(offsets.empty() ? 0 : offsets.size() - 1);
+    for (size_t idx = 0; idx + 1 < offsets.size(); ++idx)
+      result.emplace_back(blob, offsets[idx], offsets[idx + 1] - offsets[idx]);
+    return result;
+  }
+
+  // Offsets must start at 0, never decrease and end at p_total.
+  static void offsets_in_range(const std::vector<uint64_t>& p_offsets,
+                               size_t p_total)
+  {
+    if (p_offsets.empty() || p_offsets.front() != 0 ||
+        p_offsets.back() != p_total ||
+        !std::is_sorted(p_offsets.begin(), p_offsets.end()))
+      throw Solver_Error("model snapshot is corrupt");
+  }
+
+  bool at_end() const
+  {
+    return m_pos == m_payload.size();
+  }
+
+private:
+  std::string_view m_payload;
+
+  size_t m_pos;
+
+  void take(void* p_data, size_t p_size)
+  {
+    const size_t padded = (p_size + 7) & ~size_t(7);
+    if (padded > m_payload.size() - m_pos)
+      throw Solver_Error("model snapshot is truncated");
+    if (p_size > 0)
+      std::memcpy(p_data, m_payload.data() + m_pos, p_size);
+    m_pos += padded;
+  }
+};
+
+template <typename Map>
+std::vector<std::pair<size_t, std::string>> sorted_entries(const Map& p_map)
+{
+  std::vector<std::pair<size_t, std::string>> entries;
+  entries.reserve(p_map.size());
+  for (const auto& [name, idx] : p_map)
+    entries.emplace_back(idx, name);
+  std::sort(entries.begin(), entries.end());
+  return entries;
+}
+
+void write_name_map(Snapshot_Writer& p_out,
+                    const std::unordered_map<std::string, size_t>& p_map)
+{
+  const auto entries = sorted_entries(p_map);
+  std::vector<uint64_t> idxs(entries.size());
+  for (size_t entry = 0; entry < entries.size(); ++entry)
+    idxs[entry] = entries[entry].first;
+  p_out.names(entries.size(),
+              [&](size_t p_entry) -> const std::string&
+              { return entries[p_entry].second; });
+  p_out.array(idxs);
+}
+
+// Every stored index must lie below p_limit.
+template <typename T>
+void idxs_below(const std::vector<T>& p_idxs, uint64_t p_limit)
+{
+  for (const T idx : p_idxs)
+  {
+    if (static_cast<uint64_t>(idx) >= p_limit)
+      throw Solver_Error("model snapshot is corrupt");
+  }
+}
+
+// Checks one side of the term cross references: term t of line l (a column
+// or a row) must name a line of the other side and a position inside it,
+// and the term found there must point back at l and t. Checked from both
+// sides, no index or position of the model can leave its array.
+void terms_point_back(const std::vector<uint64_t>& p_term_begin,
+                      const std::vector<Model_Idx>& p_other_idx,
+                      const std::vector<Model_Idx>& p_pos_in_other,
+                      const std::vector<uint64_t>& p_other_term_begin,
+                      const std::vector<Model_Idx>& p_other_back_idx,
+                      const std::vector<Model_Idx>& p_other_back_pos)
+{
+  const size_t other_num = p_other_term_begin.size() - 1;
+  for (size_t line = 0; line + 1 < p_term_begin.size(); ++line)
+  {
+    for (uint64_t term = p_term_begin[line]; term < p_term_begin[line + 1];
+         ++term)
+    {
+      const uint64_t other = p_other_idx[term];
+      if (other >= other_num)
+        throw Solver_Error("model snapshot is corrupt");
+      const uint64_t other_begin = p_other_term_begin[other];
+      const uint64_t pos = p_pos_in_other[term];
+      if (pos >= p_other_term_begin[other + 1] - other_begin ||
+          p_other_back_idx[other_begin + pos] != line ||
+          p_other_back_pos[other_begin + pos] != term - p_term_begin[line])
+        throw Solver_Error("model snapshot is corrupt");
+    }
+  }
+}
+
+void read_name_map(Snapshot_Cursor& p_in,
+                   std::unordered_map<std::string, size_t>& p_map,
+                   size_t p_idx_limit)
+{
+  std::vector<std::string> names = p_in.names();
+  std::vector<uint64_t> idxs;
+  p_in.array(idxs);
+  if (idxs.size() != names.size())
+    throw Solver_Error("model snapshot is corrupt");
+  idxs_below(idxs, p_idx_limit);
+  p_map.clear();
+  p_map.reserve(names.size());
+  for (size_t entry = 0; entry < names.size(); ++entry)
+    p_map.emplace(std::move(names[entry]), idxs[entry]);
+}
+
+} // namespace
+
+uint64_t Model_Snapshot::checksum(const char* p_data, size_t p_size)
+{
+  // FNV-1a over 64-bit words, folding the tail bytes into a last word.
+  constexpr uint64_t k_prime = 0x100000001b3ULL;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  size_t pos = 0;
+  for (; pos + 8 <= p_size; pos += 8)
+  {
+    uint64_t word;
+    std::memcpy(&word, p_data + pos, 8);
+    hash = (hash ^ word) * k_prime;
+    hash ^= hash >> 32;
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, p_data + pos, p_size - pos);
+  hash = (hash ^ tail ^ p_size) * k_prime;
+  return hash ^ (hash >> 32);
+}
+
+void Model_Snapshot::save(const Model_Manager& p_model_manager,
+                          const std::string& p_snapshot_file)
+{
+  const Model_Manager& model = p_model_manager;
+  if (model.m_var_num != model.m_var_list.size() ||
+      model.m_con_num != model.m_con_list.size())
+    throw std::logic_error("only a prepared model can be saved");
+
+  Snapshot_Writer out;
+  out.value<int64_t>(model.m_bound_strengthen);
+  out.value(model.m_feas_tolerance);
+  out.value(model.m_zero_tolerance);
+  out.value<int64_t>(model.m_is_min);
+  out.value(model.m_obj_offset);
+  out.value<uint64_t>(model.m_split_eq);
+  out.value<uint64_t>(model.m_dup_presolve);
+  out.value<uint64_t>(model.m_var_num);
+  out.value<uint64_t>(model.m_general_integer_num);
+  out.value<uint64_t>(model.m_binary_num);
+  out.value<uint64_t>(model.m_fixed_num);
+  out.value<uint64_t>(model.m_real_num);
+  out.value<uint64_t>(model.m_con_num);
+  out.value<uint64_t>(model.m_delete_con_num);
+  out.value<uint64_t>(model.m_delete_var_num);
+  out.value<uint64_t>(model.m_infer_var_num);
+  out.text(model.m_obj_name);
+
+  const auto& vars = model.m_var_list;
+  const size_t var_num = vars.size();
+  std::vector<uint64_t> var_idx(var_num);
+  std::vector<double> lower_bound(var_num);
+  std::vector<double> upper_bound(var_num);
+  std::vector<uint8_t> var_type(var_num);
+  std::vector<uint8_t> requires_integrality(var_num);
+  std::vector<uint64_t> var_term_begin(var_num + 1, 0);
+  std::vector<Model_Idx> var_con_idx;
+  std::vector<Model_Idx> var_pos_in_con;
+  for (size_t idx = 0; idx < var_num; ++idx)
+  {
+    const Model_Var& var = vars[idx];
+    var_idx[idx] = var.m_idx;
+    lower_bound[idx] = var.m_lower_bound;
+    upper_bound[idx] = var.m_upper_bound;
+    var_type[idx] = static_cast<uint8_t>(var.m_type);
+    requires_integrality[idx] = var.m_requires_integrality;
+    var_con_idx.insert(var_con_idx.end(),
+                       var.m_con_idx_list.begin(),
+                       var.m_con_idx_list.end());
+    var_pos_in_con.insert(var_pos_in_con.end(),
+                          var.m_pos_in_con_list.begin(),
+                          var.m_pos_in_con_list.end());
+    var_term_begin[idx + 1] = var_con_idx.size();
+  }
+  out.names(var_num,
+            [&](size_t p_idx) -> const std::string&
+            { return vars[p_idx].m_name; });
+  out.array(var_idx);
+  out.array(lower_bound);
+  out.array(upper_bound);
+  out.array(var_type);
+  out.array(requires_integrality);
+  out.array(var_term_begin);
+  out.array(var_con_idx);
+  out.array(var_pos_in_con);
+
+  const auto& cons = model.m_con_list;
+  const size_t con_num = cons.size();
+  std::vector<uint64_t> con_idx(con_num);
+  std::vector<double> rhs(con_num);
+  std::vector<uint8_t> con_flags(con_num);
+  std::vector<uint64_t> con_type_begin(con_num + 1, 0);
+  std::vector<uint8_t> con_types;
+  std::vector<uint64_t> con_term_begin(con_num + 1, 0);
+  std::vector<Model_Idx> con_var_idx;
+  std::vector<double> con_coeff;
+  std::vector<Model_Idx> con_pos_in_var;
+  for (size_t idx = 0; idx < con_num; ++idx)
+  {
+    const Model_Con& con = cons[idx];
+    con_idx[idx] = con.m_idx;
+    rhs[idx] = con.m_rhs;
+    con_flags[idx] = static_cast<uint8_t>(
+        (con.m_is_equality ? 1 : 0) | (con.m_is_greater ? 2 : 0) |
+        (con.m_mark_inferred_sat ? 4 : 0));
+    for (Con_Type type : con.m_types)
+      con_types.push_back(static_cast<uint8_t>(type));
+    con_type_begin[idx + 1] = con_types.size();
+    con_var_idx.insert(con_var_idx.end(),
+                       con.m_var_idx_list.begin(),
+                       con.m_var_idx_list.end());
+    con_coeff.insert(
+        con_coeff.end(), con.m_coeff_list.begin(), con.m_coeff_list.end());
+    con_pos_in_var.insert(con_pos_in_var.end(),
+                          con.m_pos_in_var_list.begin(),
+                          con.m_pos_in_var_list.end());
+    con_term_begin[idx + 1] = con_var_idx.size();
+  }
+  out.names(con_num,
+            [&](size_t p_idx) -> const std::string&
+            { return cons[p_idx].m_name; });
+  out.array(con_idx);
+  out.array(rhs);
+  out.array(con_flags);
+  out.array(con_type_begin);
+  out.array(con_types);
+  out.array(con_term_begin);
+  out.array(con_var_idx);
+  out.array(con_coeff);
+  out.array(con_pos_in_var);
+
+  out.array(std::vector<uint64_t>(model.m_var_idx_to_obj_idx.begin(),
+                                  model.m_var_idx_to_obj_idx.end()));
+  out.array(model.m_binary_idx_list);
+  out.array(std::vector<uint8_t>(model.m_con_is_equality.begin(),
+                                 model.m_con_is_equality.end()));
+  out.array(model.m_non_fixed_var_idxs);
+  out.array(model.m_var_obj_cost);
+
+  std::vector<std::pair<uint64_t, const std::vector<size_t>*>> type_lists;
+  for (const auto& [type, con_idxs] : model.m_type_to_con_idx_list)
+    type_lists.emplace_back(static_cast<uint64_t>(type), &con_idxs);
+  std::sort(type_lists.begin(), type_lists.end());
+  out.value<uint64_t>(type_lists.size());
+  for (const auto& [type, con_idxs] : type_lists)
+  {
+    out.value(type);
+    out.array(std::vector<uint64_t>(con_idxs->begin(), con_idxs->end()));
+  }
+
+  const auto& merges = model.m_column_merges;
+  std::vector<Model_Idx> merge_kept_idx;
+  std::vector<Model_Idx> merge_removed_idx;
+  std::vector<double> merge_bounds;
+  for (const Column_Merge& merge : merges)
+  {
+    merge_kept_idx.push_back(merge.kept_idx);
+    merge_removed_idx.push_back(merge.removed_idx);
+    merge_bounds.insert(merge_bounds.end(),
+                        {merge.kept_lower,
+                         merge.kept_upper,
+                         merge.removed_lower,
+                         merge.removed_upper});
+  }
+  out.array(merge_kept_idx);
+  out.array(merge_removed_idx);
+  out.array(merge_bounds);
+
+  write_name_map(out, model.m_var_name_to_idx);
+  write_name_map(out, model.m_con_name_to_idx);
+
+  const std::string& payload = out.payload();
+  Snapshot_Header header;
+  std::memcpy(header.magic, k_magic, sizeof(k_magic));
+  header.version = k_version;
+  header.endian_tag = k_endian_tag;
+  header.index_bytes = sizeof(Model_Idx);
+  header.reserved = 0;
+  header.payload_size = payload.size();
+  header.checksum = checksum(payload.data(), payload.size());
+
+  std::ofstream file(p_snapshot_file, std::ios::binary | std::ios::trunc);
+  if (!file)
+    throw Solver_Error("cannot write model snapshot: " + p_snapshot_file);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+  file.close();
+  if (!file)
+    throw Solver_Error("cannot write model snapshot: " + p_snapshot_file);
+}
+
+void Model_Snapshot::load(Model_Manager& p_model_manager,
+                          const std::string& p_snapshot_file)
+{
+  Mapped_File file;
+  if (!file.open(p_snapshot_file.c_str()))
+    throw Solver_Error("cannot open model snapshot: " + p_snapshot_file);
+  const std::string_view text = file.text();
+  Snapshot_Header header;
+  if (text.size() < sizeof(header))
+    throw Solver_Error("model snapshot is truncated");
+  std::memcpy(&header, text.data(), sizeof(header));
+  if (std::memcmp(header.magic, k_magic, sizeof(k_magic)) != 0)
+    throw Solver_Error("not a model snapshot: " + p_snapshot_file);
+  if (header.version != k_version)
+  {
+    throw Solver_Error("unsupported model snapshot version " +
+                       std::to_string(header.version));
+  }
+  if (header.endian_tag != k_endian_tag)
+    throw Solver_Error("model snapshot was written with another byte order");
+  if (header.index_bytes != sizeof(Model_Idx))
+    throw Solver_Error("model snapshot was written with another index width");
+  if (header.payload_size != text.size() - sizeof(header))
+    throw Solver_Error("model snapshot is truncated");
+  const std::string_view payload = text.substr(sizeof(header));
+  if (checksum(payload.data(), payload.size()) != header.checksum)
+    throw Solver_Error("model snapshot checksum mismatch");
+
+  Model_Manager& model = p_model_manager;
+  Snapshot_Cursor in(payload);
+  model.m_bound_strengthen = static_cast<int>(in.value<int64_t>());
+  model.m_feas_tolerance = in.value<double>();
+  model.m_zero_tolerance = in.value<double>();
+  model.m_is_min = static_cast<int>(in.value<int64_t>());
+  model.m_obj_offset = in.value<double>();
+  model.m_split_eq = in.value<uint64_t>() != 0;
+  model.m_dup_presolve = in.value<uint64_t>() != 0;
+  model.m_var_num = in.value<uint64_t>();
+  model.m_general_integer_num = in.value<uint64_t>();
+  model.m_binary_num = in.value<uint64_t>();
+  model.m_fixed_num = in.value<uint64_t>();
+  model.m_real_num = in.value<uint64_t>();
+  model.m_con_num = in.value<uint64_t>();
+  model.m_delete_con_num = in.value<uint64_t>();
+  model.m_delete_var_num = in.value<uint64_t>();
+  model.m_infer_var_num = in.value<uint64_t>();
+  model.m_obj_name = in.text();
+
+  std::vector<std::string> var_names = in.names();
+  const size_t var_num = var_names.size();
+  std::vector<uint64_t> var_idx;
+  std::vector<double> lower_bound;
+  std::vector<double> upper_bound;
+  std::vector<uint8_t> var_type;
+  std::vector<uint8_t> requires_integrality;
+  std::vector<uint64_t> var_term_begin;
+  std::vector<Model_Idx> var_con_idx;
+  std::vector<Model_Idx> var_pos_in_con;
+  in.array(var_idx);
+  in.array(lower_bound);
+  in.array(upper_bound);
+  in.array(var_type);
+  in.array(requires_integrality);
+  in.array(var_term_begin);
+  in.array(var_con_idx);
+  in.array(var_pos_in_con);
+  if (var_idx.size() != var_num || lower_bound.size() != var_num ||
+      upper_bound.size() != var_num || var_type.size() != var_num ||
+      requires_integrality.size() != var_num ||
+      var_term_begin.size() != var_num + 1 ||
+      var_pos_in_con.size() != var_con_idx.size() ||
+      var_num != model.m_var_num)
+    throw Solver_Error("model snapshot is corrupt");
+  Snapshot_Cursor::offsets_in_range(var_term_begin, var_con_idx.size());
+
+  model.m_var_list.clear();
+  model.m_var_list.reserve(var_num);
+  for (size_t idx = 0; idx < var_num; ++idx)
+  {
+    if (var_idx[idx] != idx ||
+        var_type[idx] > static_cast<uint8_t>(Var_Type::fixed))
+      throw Solver_Error("model snapshot is corrupt");
+    Model_Var& var = model.m_var_list.emplace_back(
+        var_names[idx], var_idx[idx], requires_integrality[idx] != 0);
+    var.m_lower_bound = lower_bound[idx];
+    var.m_upper_bound = upper_bound[idx];
+    var.m_type = static_cast<Var_Type>(var_type[idx]);
+    var.m_con_idx_list.assign(var_con_idx.begin() + var_term_begin[idx],
+                              var_con_idx.begin() + var_term_begin[idx + 1]);
+    var.m_pos_in_con_list.assign(
+        var_pos_in_con.begin() + var_term_begin[idx],
+        var_pos_in_con.begin() + var_term_begin[idx + 1]);
+  }
+
+  std::vector<std::string> con_names = in.names();
+  const size_t con_num = con_names.size();
+  std::vector<uint64_t> con_idx;
+  std::vector<double> rhs;
+  std::vector<uint8_t> con_flags;
+  std::vector<uint64_t> con_type_begin;
+  std::vector<uint8_t> con_types;
+  std::vector<uint64_t> con_term_begin;
+  std::vector<Model_Idx> con_var_idx;
+  std::vector<double> con_coeff;
+  std::vector<Model_Idx> con_pos_in_var;
+  in.array(con_idx);
+  in.array(rhs);
+  in.array(con_flags);
+  in.array(con_type_begin);
+  in.array(con_types);
+  in.array(con_term_begin);
+  in.array(con_var_idx);
+  in.array(con_coeff);
+  in.array(con_pos_in_var);
+  if (con_idx.size() != con_num || rhs.size() != con_num ||
+      con_flags.size() != con_num || con_type_begin.size() != con_num + 1 ||
+      con_term_begin.size() != con_num + 1 ||
+      con_coeff.size() != con_var_idx.size() ||
+      con_pos_in_var.size() != con_var_idx.size() ||
+      con_num != model.m_con_num)
+    throw Solver_Error("model snapshot is corrupt");
+  Snapshot_Cursor::offsets_in_range(con_type_begin, con_types.size());
+  Snapshot_Cursor::offsets_in_range(con_term_begin, con_var_idx.size());
+  idxs_below(con_types,
+             static_cast<uint64_t>(Con_Type::general_inequality) + 1);
+  terms_point_back(var_term_begin,
+                   var_con_idx,
+                   var_pos_in_con,
+                   con_term_begin,
+                   con_var_idx,
+                   con_pos_in_var);
+  terms_point_back(con_term_begin,
+                   con_var_idx,
+                   con_pos_in_var,
+                   var_term_begin,
+                   var_con_idx,
+                   var_pos_in_con);
+
+  model.m_con_list.clear();
+  model.m_con_list.reserve(con_num);
+  for (size_t idx = 0; idx < con_num; ++idx)
+  {
+    if (con_idx[idx] != idx)
+      throw Solver_Error("model snapshot is corrupt");
+    Model_Con& con = model.m_con_list.emplace_back(con_names[idx],
+                                                   con_idx[idx]);
+    con.m_is_equality = (con_flags[idx] & 1) != 0;
+    con.m_is_greater = (con_flags[idx] & 2) != 0;
+    con.m_mark_inferred_sat = (con_flags[idx] & 4) != 0;
+    con.m_rhs = rhs[idx];
+    con.m_types.clear();
+    for (size_t pos = con_type_begin[idx]; pos < con_type_begin[idx + 1];
+         ++pos)
+      con.m_types.push_back(static_cast<Con_Type>(con_types[pos]));
+    const auto term_begin = static_cast<std::ptrdiff_t>(con_term_begin[idx]);
+    const auto term_end = static_cast<std::ptrdiff_t>(con_term_begin[idx + 1]);
+    con.m_var_idx_list.assign(con_var_idx.begin() + term_begin,
+                              con_var_idx.begin() + term_end);
+    con.m_coeff_list.assign(con_coeff.begin() + term_begin,
+                            con_coeff.begin() + term_end);
+    con.m_pos_in_var_list.assign(con_pos_in_var.begin() + term_begin,
+                                 con_pos_in_var.begin() + term_end);
+  }
+
+  std::vector<uint64_t> var_idx_to_obj_idx;
+  in.array(var_idx_to_obj_idx);
+  in.array(model.m_binary_idx_list);
+  std::vector<uint8_t> con_is_equality;
+  in.array(con_is_equality);
+  in.array(model.m_non_fixed_var_idxs);
+  in.array(model.m_var_obj_cost);
+  if (var_idx_to_obj_idx.size() != var_num ||
+      con_is_equality.size() != con_num ||
+      model.m_var_obj_cost.size() != var_num)
+    throw Solver_Error("model snapshot is corrupt");
+  const uint64_t obj_term_num =
+      con_num == 0 ? 0 : con_term_begin[1] - con_term_begin[0];
+  for (const uint64_t obj_idx : var_idx_to_obj_idx)
+  {
+    if (obj_idx != SIZE_MAX && obj_idx >= obj_term_num)
+      throw Solver_Error("model snapshot is corrupt");
+  }
+  idxs_below(model.m_binary_idx_list, var_num);
+  idxs_below(model.m_non_fixed_var_idxs, var_num);
+  model.m_var_idx_to_obj_idx.assign(var_idx_to_obj_idx.begin(),
+                                    var_idx_to_obj_idx.end());
+  model.m_con_is_equality.assign(con_is_equality.begin(),
+                                 con_is_equality.end());
+
+  model.m_type_to_con_idx_list.clear();
+  model.m_type_to_con_idx_set.clear();
+  const uint64_t type_list_num = in.value<uint64_t>();
+  for (uint64_t entry = 0; entry < type_list_num; ++entry)
+  {
+    const uint64_t type_value = in.value<uint64_t>();
+    if (type_value > static_cast<uint64_t>(Con_Type::general_inequality))
+      throw Solver_Error("model snapshot is corrupt");
+    const auto type = static_cast<Con_Type>(type_value);
+    std::vector<uint64_t> con_idxs;
+    in.array(con_idxs);
+    idxs_below(con_idxs, con_num);
+    auto& list = model.m_type_to_con_idx_list[type];
+    list.assign(con_idxs.begin(), con_idxs.end());
+    model.m_type_to_con_idx_set[type].insert(list.begin(), list.end());
+  }
+
+  std::vector<Model_Idx> merge_kept_idx;
+  std::vector<Model_Idx> merge_removed_idx;
+  std::vector<double> merge_bounds;
+  in.array(merge_kept_idx);
+  in.array(merge_removed_idx);
+  in.array(merge_bounds);
+  if (merge_removed_idx.size() != merge_kept_idx.size() ||
+      merge_bounds.size() != 4 * merge_kept_idx.size())
+    throw Solver_Error("model snapshot is corrupt");
+  model.m_column_merges.clear();
+  for (size_t idx = 0; idx < merge_kept_idx.size(); ++idx)
+  {
+    if (merge_kept_idx[idx] >= model.m_var_num ||
+        merge_removed_idx[idx] >= model.m_var_num)
+      throw Solver_Error("model snapshot is corrupt");
+    model.m_column_merges.push_back({merge_kept_idx[idx],
+                                     merge_removed_idx[idx],
+                                     merge_bounds[4 * idx],
+                                     merge_bounds[4 * idx + 1],
+                                     merge_bounds[4 * idx + 2],
+                                     merge_bounds[4 * idx + 3]});
+  }
+
+  read_name_map(in, model.m_var_name_to_idx, var_num);
+  read_name_map(in, model.m_con_name_to_idx, con_num);
+  if (!in.at_end())
+    throw Solver_Error("model snapshot is corrupt");
+  model.build_matrix();
+}
@@ -0,0 +1,36 @@
+/*=====================================================================================
+
+    Filename:     Model_Snapshot.h
+
+    Description:  Versioned binary snapshot of a prepared Model_Manager
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include "Model_Manager.h"
+#include <cstdint>
+#include <string>
+
+// File layout: a fixed header followed by one payload. The header holds a
+// magic tag, the format version, an endianness tag, the Model_Idx width,
+// the payload size and a checksum of the payload. In the payload, arrays
+// are length-prefixed, stored column-wise (all lower bounds, then all upper
+// bounds, ...) and padded to 8 bytes, so a mapped file is copied into the
+// model one array at a time.
+class Model_Snapshot
+{
+public:
+  static constexpr uint32_t k_version = 2;
+
+  // Writes a model that has been through process_after_read().
+  static void save(const Model_Manager& p_model_manager,
+                   const std::string& p_snapshot_file);
+
+  // Rebuilds the prepared model, including its matrix view.
+  static void load(Model_Manager& p_model_manager,
+                   const std::string& p_snapshot_file);
+
+  static uint64_t checksum(const char* p_data, size_t p_size);
+};
@@ -12,6 +12,9 @@
 =====================================================================================*/
 
 #include "Model_Var.h"
+#include "Model_Con.h"
+#include "Model_Manager.h"
+#include <cassert>
 #include <cstddef>
 
 Model_Var::Model_Var(const std::string& p_name,
@@ -38,5 +41,21 @@ Model_Var::~Model_Var()
 void Model_Var::set_pos_in_con(const size_t term_idx,
                                const size_t pos_in_con)
 {
-  m_pos_in_con_list[term_idx] = pos_in_con;
+  m_pos_in_con_list[term_idx] = static_cast<Model_Idx>(pos_in_con);
+}
+
+void Model_Var::delete_term_at(const size_t p_term_idx,
+                               Model_Manager* p_model_manager)
+{
+  assert(p_term_idx < term_num());
+  Model_Idx moved_con_idx = m_con_idx_list.back();
+  Model_Idx moved_pos_in_con = m_pos_in_con_list.back();
+  m_con_idx_list[p_term_idx] = moved_con_idx;
+  m_pos_in_con_list[p_term_idx] = moved_pos_in_con;
+  m_con_idx_list.pop_back();
+  m_pos_in_con_list.pop_back();
+  auto& moved_con = p_model_manager->con(moved_con_idx);
+  assert(moved_con.pos_in_var(moved_pos_in_con) == term_num());
+  assert(moved_con.var_idx(moved_pos_in_con) == m_idx);
+  moved_con.set_pos_in_var(moved_pos_in_con, p_term_idx);
 }
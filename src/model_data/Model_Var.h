@@ -18,11 +18,14 @@
 #include <string>
 #include <vector>
 
+class Model_Manager;
 class Model_Var
 {
 private:
   friend class Model_Manager;
 
+  friend class Model_Snapshot;
+
   std::string m_name;
 
   size_t m_idx;
@@ -31,9 +34,9 @@ private:
 
   double m_lower_bound;
 
-  std::vector<size_t> m_con_idx_list;
+  std::vector<Model_Idx> m_con_idx_list;
 
-  std::vector<size_t> m_pos_in_con_list;
+  std::vector<Model_Idx> m_pos_in_con_list;
 
   Var_Type m_type;
 
@@ -50,6 +53,16 @@ public:
 
   void set_pos_in_con(const size_t p_term_idx, const size_t p_pos_in_con);
 
+  // Removes one column entry; the last entry takes its place and its row
+  // is told the new position.
+  void delete_term_at(const size_t p_term_idx,
+                      Model_Manager* p_model_manager);
+
+  inline void resize_terms(size_t p_term_num);
+
+  inline void
+  set_term(size_t p_term_idx, size_t p_con_idx, size_t p_pos_in_con);
+
   inline bool is_real() const;
 
   inline bool is_general_integer() const;
@@ -66,7 +79,7 @@ public:
 
   inline size_t con_idx(const size_t p_term_idx) const;
 
-  inline const std::vector<size_t>& con_idx_set() const;
+  inline const std::vector<Model_Idx>& con_idx_set() const;
 
   inline Var_Type type() const;
 
@@ -115,7 +128,7 @@ inline size_t Model_Var::con_idx(const size_t p_term_idx) const
   return m_con_idx_list[p_term_idx];
 }
 
-inline const std::vector<size_t>& Model_Var::con_idx_set() const
+inline const std::vector<Model_Idx>& Model_Var::con_idx_set() const
 {
   return m_con_idx_list;
 }
@@ -135,9 +148,23 @@ inline const std::string& Model_Var::name() const
   return m_name;
 }
 
+inline void Model_Var::resize_terms(size_t p_term_num)
+{
+  m_con_idx_list.resize(p_term_num);
+  m_pos_in_con_list.resize(p_term_num);
+}
+
+inline void Model_Var::set_term(size_t p_term_idx,
+                                size_t p_con_idx,
+                                size_t p_pos_in_con)
+{
+  m_con_idx_list[p_term_idx] = static_cast<Model_Idx>(p_con_idx);
+  m_pos_in_con_list[p_term_idx] = static_cast<Model_Idx>(p_pos_in_con);
+}
+
 inline void Model_Var::add_con(const size_t con_idx,
                                const size_t pos_in_con)
 {
-  m_con_idx_list.push_back(con_idx);
-  m_pos_in_con_list.push_back(pos_in_con);
+  m_con_idx_list.push_back(static_cast<Model_Idx>(con_idx));
+  m_pos_in_con_list.push_back(static_cast<Model_Idx>(pos_in_con));
 }
@@ -9,12 +9,22 @@
 
 #include "../reader/Model_Reader.h"
 #include "../utils/solver_error.h"
+#include "Model_Snapshot.h"
 #include "Prepared_Model.h"
+#include <chrono>
 #include <cmath>
 #include <memory>
 #include <stdexcept>
 #include <string>
 
+double Prepared_Model::seconds_since(
+    std::chrono::steady_clock::time_point p_start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       p_start)
+      .count();
+}
+
 void Prepared_Model::validate_options(
     const Model_Prepare_Options& p_options)
 {
@@ -41,8 +51,9 @@ void Prepared_Model::validate_options(
 }
 
 Prepared_Model::Prepared_Model(
-    std::unique_ptr<const Model_Manager> p_model_manager)
-    : m_model_manager(std::move(p_model_manager))
+    std::unique_ptr<const Model_Manager> p_model_manager,
+    const Prepare_Timing& p_timing)
+    : m_model_manager(std::move(p_model_manager)), m_timing(p_timing)
 {
   if (m_model_manager == nullptr)
     throw std::invalid_argument("prepared model manager cannot be null");
@@ -57,17 +68,54 @@ Prepared_Model::from_file(const std::string& p_model_file,
                                                  p_options.zero_tolerance);
   manager->set_bound_strengthen(p_options.bound_strengthen);
   manager->set_split_eq(p_options.split_eq);
+  manager->set_dup_presolve(p_options.dup_presolve);
+  manager->set_presolve_workers(p_options.presolve_threads);
+  Prepare_Timing timing;
+  auto start = std::chrono::steady_clock::now();
   read_model_file(p_model_file, *manager);
+  timing.read_seconds = seconds_since(start);
+  start = std::chrono::steady_clock::now();
   if (!manager->process_after_read())
     throw Solver_Error("model is infeasible during preparation");
+  timing.presolve_seconds = seconds_since(start);
+  if (manager->var_num() == 0)
+    throw Solver_Error("model must contain at least one variable");
+
+  return std::shared_ptr<const Prepared_Model>(
+      new Prepared_Model(std::move(manager), timing));
+}
+
+std::shared_ptr<const Prepared_Model>
+Prepared_Model::load(const std::string& p_snapshot_file)
+{
+  auto manager = std::make_unique<Model_Manager>();
+  Prepare_Timing timing;
+  const auto start = std::chrono::steady_clock::now();
+  Model_Snapshot::load(*manager, p_snapshot_file);
+  timing.read_seconds = seconds_since(start);
   if (manager->var_num() == 0)
     throw Solver_Error("model must contain at least one variable");
 
   return std::shared_ptr<const Prepared_Model>(
-      new Prepared_Model(std::move(manager)));
+      new Prepared_Model(std::move(manager), timing));
+}
+
+void Prepared_Model::save(const std::string& p_snapshot_file) const
+{
+  Model_Snapshot::save(*m_model_manager, p_snapshot_file);
 }
 
 const Model_Manager& Prepared_Model::model_manager() const noexcept
 {
   return *m_model_manager;
 }
+
+const Model_Matrix& Prepared_Model::matrix() const noexcept
+{
+  return m_model_manager->matrix();
+}
+
+const Prepare_Timing& Prepared_Model::timing() const noexcept
+{
+  return m_timing;
+}
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "Model_Manager.h"
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -23,7 +24,22 @@ struct Model_Prepare_Options
 
   int bound_strengthen = 1;
 
-  bool split_eq = true;
+  bool split_eq = false;
+
+  bool dup_presolve = true;
+
+  // 0 uses all hardware threads; the prepared model is the same either way.
+  size_t presolve_threads = 0;
+};
+
+// Wall time spent preparing the model. Reading covers parsing a model
+// file, populating from Model_API or loading a snapshot; a loaded snapshot
+// has no presolve time.
+struct Prepare_Timing
+{
+  double read_seconds = 0.0;
+
+  double presolve_seconds = 0.0;
 };
 
 class Prepared_Model
@@ -31,11 +47,16 @@ class Prepared_Model
 private:
   std::unique_ptr<const Model_Manager> m_model_manager;
 
-  explicit Prepared_Model(
-      std::unique_ptr<const Model_Manager> p_model_manager);
+  Prepare_Timing m_timing;
+
+  Prepared_Model(std::unique_ptr<const Model_Manager> p_model_manager,
+                 const Prepare_Timing& p_timing);
 
   static void validate_options(const Model_Prepare_Options& p_options);
 
+  static double
+  seconds_since(std::chrono::steady_clock::time_point p_start);
+
   friend class Model_API;
 
 public:
@@ -43,5 +64,17 @@ public:
   from_file(const std::string& p_model_file,
             const Model_Prepare_Options& p_options = {});
 
+  // Binary snapshot of the prepared model (see Model_Snapshot.h). Loading
+  // one skips both parsing and presolve; the preparation options are part
+  // of the snapshot.
+  static std::shared_ptr<const Prepared_Model>
+  load(const std::string& p_snapshot_file);
+
+  void save(const std::string& p_snapshot_file) const;
+
   const Model_Manager& model_manager() const noexcept;
+
+  const Model_Matrix& matrix() const noexcept;
+
+  const Prepare_Timing& timing() const noexcept;
 };
@@ -0,0 +1,553 @@
+/*=====================================================================================
+
+    Filename:     Compressed_Input.cpp
+
+    Description:  Streaming decompression of gzip/bzip2/xz/zstd model files
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "Compressed_Input.h"
+#include "../utils/solver_error.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef LOCAL_MIP_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef LOCAL_MIP_WITH_BZIP2
+#include <bzlib.h>
+#endif
+#ifdef LOCAL_MIP_WITH_LZMA
+#include <lzma.h>
+#endif
+#ifdef LOCAL_MIP_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+// One codec session. decode() moves as much data as the buffers allow and
+// returns true once the current member is complete; restart() prepares the
+// session for the next concatenated member. p_finish signals that no input
+// is left, which xz needs to close a stream decoded with
+// LZMA_CONCATENATED.
+class Compressed_Input::Decoder
+{
+public:
+  explicit Decoder(Compression p_compression);
+
+  ~Decoder();
+
+  Decoder(const Decoder&) = delete;
+
+  Decoder& operator=(const Decoder&) = delete;
+
+  bool decode(const char* p_in,
+              size_t p_in_size,
+              size_t& p_consumed,
+              char* p_out,
+              size_t p_out_size,
+              size_t& p_produced,
+              bool p_finish);
+
+  void restart();
+
+private:
+  Compression m_compression;
+
+#ifdef LOCAL_MIP_WITH_ZLIB
+  z_stream m_zlib;
+#endif
+#ifdef LOCAL_MIP_WITH_BZIP2
+  bz_stream m_bzip2;
+#endif
+#ifdef LOCAL_MIP_WITH_LZMA
+  lzma_stream m_lzma;
+#endif
+#ifdef LOCAL_MIP_WITH_ZSTD
+  ZSTD_DCtx* m_zstd;
+#endif
+
+  void init();
+
+  void end();
+
+  [[noreturn]] void corrupt() const;
+};
+
+Compressed_Input::Decoder::Decoder(Compression p_compression)
+    : m_compression(p_compression)
+{
+  init();
+}
+
+Compressed_Input::Decoder::~Decoder()
+{
+  end();
+}
+
+void Compressed_Input::Decoder::init()
+{
+  bool ok = false;
+  switch (m_compression)
+  {
+#ifdef LOCAL_MIP_WITH_ZLIB
+  case Compression::gzip:
+    std::memset(&m_zlib, 0, sizeof(m_zlib));
+    // 15 window bits plus 32 accepts both gzip and zlib headers.
+    ok = inflateInit2(&m_zlib, 15 + 32) == Z_OK;
+    break;
+#endif
+#ifdef LOCAL_MIP_WITH_BZIP2
+  case Compression::bzip2:
+    std::memset(&m_bzip2, 0, sizeof(m_bzip2));
+    ok = BZ2_bzDecompressInit(&m_bzip2, 0, 0) == BZ_OK;
+    break;
+#endif
+#ifdef LOCAL_MIP_WITH_LZMA
+  case Compression::xz:
+    m_lzma = LZMA_STREAM_INIT;
+    ok = lzma_stream_decoder(&m_lzma, UINT64_MAX, LZMA_CONCATENATED) ==
+         LZMA_OK;
+    break;
+#endif
+#ifdef LOCAL_MIP_WITH_ZSTD
+  case Compression::zstd:
+    m_zstd = ZSTD_createDCtx();
+    ok = m_zstd != nullptr;
+    break;
+#endif
+  default:
+    break;
+  }
+  if (!ok)
+    throw Solver_Error(std::string("c failed to initialize the ") +
+                       name(m_compression) + " decoder");
+}
+
+void Compressed_Input::Decoder::end()
+{
+  switch (m_compression)
+  {
+#ifdef LOCAL_MIP_WITH_ZLIB
+  case Compression::gzip:
+    inflateEnd(&m_zlib);
+    break;
+#endif
+#ifdef LOCAL_MIP_WITH_BZIP2
+  case Compression::bzip2:
+    BZ2_bzDecompressEnd(&m_bzip2);
+    break;
+#endif
+#ifdef LOCAL_MIP_WITH_LZMA
+  case Compression::xz:
+    lzma_end(&m_lzma);
+    break;
+#endif
+#ifdef LOCAL_MIP_WITH_ZSTD
+  case Compression::zstd:
+    ZSTD_freeDCtx(m_zstd);
+    m_zstd = nullptr;
+    break;
+#endif
+  default:
+    break;
+  }
+}
+
+void Compressed_Input::Decoder::restart()
+{
+  switch (m_compression)
+  {
+#ifdef LOCAL_MIP_WITH_ZLIB
+  case Compression::gzip:
+    if (inflateReset(&m_zlib) != Z_OK)
+      corrupt();
+    return;
+#endif
+#ifdef LOCAL_MIP_WITH_ZSTD
+  case Compression::zstd:
+    ZSTD_DCtx_reset(m_zstd, ZSTD_reset_session_only);
+    return;
+#endif
+  default:
+    end();
+    init();
+    return;
+  }
+}
+
+void Compressed_Input::Decoder::corrupt() const
+{
+  throw Solver_Error(std::string("corrupt or truncated ") +
+                     name(m_compression) + " data");
+}
+
+bool Compressed_Input::Decoder::decode(const char* p_in,
+                                       size_t p_in_size,
+                                       size_t& p_consumed,
+                                       char* p_out,
+                                       size_t p_out_size,
+                                       size_t& p_produced,
+                                       bool p_finish)
+{
+  p_consumed = 0;
+  p_produced = 0;
+  switch (m_compression)
+  {
+#ifdef LOCAL_MIP_WITH_ZLIB
+  case Compression::gzip:
+  {
+    m_zlib.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(p_in));
+    m_zlib.avail_in = static_cast<uInt>(p_in_size);
+    m_zlib.next_out = reinterpret_cast<Bytef*>(p_out);
+    m_zlib.avail_out = static_cast<uInt>(p_out_size);
+    const int status = inflate(&m_zlib, Z_NO_FLUSH);
+    p_consumed = p_in_size - m_zlib.avail_in;
+    p_produced = p_out_size - m_zlib.avail_out;
+    if (status == Z_STREAM_END)
+      return true;
+    if (status != Z_OK && status != Z_BUF_ERROR)
+      corrupt();
+    return false;
+  }
+#endif
+#ifdef LOCAL_MIP_WITH_BZIP2
+  case Compression::bzip2:
+  {
+    m_bzip2.next_in = const_cast<char*>(p_in);
+    m_bzip2.avail_in = static_cast<unsigned int>(p_in_size);
+    m_bzip2.next_out = p_out;
+    m_bzip2.avail_out = static_cast<unsigned int>(p_out_size);
+    const int status = BZ2_bzDecompress(&m_bzip2);
+    p_consumed = p_in_size - m_bzip2.avail_in;
+    p_produced = p_out_size - m_bzip2.avail_out;
+    if (status == BZ_STREAM_END)
+      return true;
+    if (status != BZ_OK)
+      corrupt();
+    return false;
+  }
+#endif
+#ifdef LOCAL_MIP_WITH_LZMA
+  case Compression::xz:
+  {
+    m_lzma.next_in = reinterpret_cast<const uint8_t*>(p_in);
+    m_lzma.avail_in = p_in_size;
+    m_lzma.next_out = reinterpret_cast<uint8_t*>(p_out);
+    m_lzma.avail_out = p_out_size;
+    const lzma_ret status =
+        lzma_code(&m_lzma, p_finish ? LZMA_FINISH : LZMA_RUN);
+    p_consumed = p_in_size - m_lzma.avail_in;
+    p_produced = p_out_size - m_lzma.avail_out;
+    if (status == LZMA_STREAM_END)
+      return true;
+    if (status != LZMA_OK)
+      corrupt();
+    return false;
+  }
+#endif
+#ifdef LOCAL_MIP_WITH_ZSTD
+  case Compression::zstd:
+  {
+    ZSTD_inBuffer input{p_in, p_in_size, 0};
+    ZSTD_outBuffer output{p_out, p_out_size, 0};
+    const size_t status = ZSTD_decompressStream(m_zstd, &output, &input);
+    if (ZSTD_isError(status))
+      corrupt();
+    p_consumed = input.pos;
+    p_produced = output.pos;
+    return status == 0;
+  }
+#endif
+  default:
+    (void)p_in;
+    (void)p_out;
+    (void)p_finish;
+    corrupt();
+  }
+}
+
+Compressed_Input::Compressed_Input()
+    : m_producer_done(true), m_stop(false), m_current_pos(0)
+{
+}
+
+Compressed_Input::~Compressed_Input()
+{
+  close();
+}
+
+Compression Compressed_Input::detect(std::string_view p_path)
+{
+  const size_t dot_pos = p_path.find_last_of('.');
+  if (dot_pos == std::string_view::npos)
+    return Compression::none;
+  std::string extension(p_path.substr(dot_pos + 1));
+  for (char& ch : extension)
+    ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+  if (extension == "gz")
+    return Compression::gzip;
+  if (extension == "bz2")
+    return Compression::bzip2;
+  if (extension == "xz")
+    return Compression::xz;
+  if (extension == "zst")
+    return Compression::zstd;
+  return Compression::none;
+}
+
+std::string_view Compressed_Input::strip_extension(std::string_view p_path)
+{
+  if (detect(p_path) == Compression::none)
+    return p_path;
+  return p_path.substr(0, p_path.find_last_of('.'));
+}
+
+const char* Compressed_Input::name(Compression p_compression)
+{
+  switch (p_compression)
+  {
+  case Compression::gzip:
+    return "gzip";
+  case Compression::bzip2:
+    return "bzip2";
+  case Compression::xz:
+    return "xz";
+  case Compression::zstd:
+    return "zstd";
+  default:
+    return "none";
+  }
+}
+
+bool Compressed_Input::is_supported(Compression p_compression)
+{
+  switch (p_compression)
+  {
+#ifdef LOCAL_MIP_WITH_ZLIB
+  case Compression::gzip:
+    return true;
+#endif
+#ifdef LOCAL_MIP_WITH_BZIP2
+  case Compression::bzip2:
+    return true;
+#endif
+#ifdef LOCAL_MIP_WITH_LZMA
+  case Compression::xz:
+    return true;
+#endif
+#ifdef LOCAL_MIP_WITH_ZSTD
+  case Compression::zstd:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+bool Compressed_Input::open(const char* p_path, Compression p_compression)
+{
+  close();
+  if (p_compression == Compression::none)
+    throw std::invalid_argument("Compressed_Input needs a compression format");
+  if (!is_supported(p_compression))
+    throw Solver_Error(std::string("c ") + p_path + " is " +
+                       name(p_compression) +
+                       "-compressed, but this build has no " +
+                       name(p_compression) + " support");
+  m_infile.open(p_path, std::ios::binary);
+  if (!m_infile)
+  {
+    m_infile.clear();
+    return false;
+  }
+  m_path = p_path;
+  m_decoder = std::make_unique<Decoder>(p_compression);
+  m_producer_done = false;
+  m_stop = false;
+  m_producer = std::thread(&Compressed_Input::produce, this);
+  return true;
+}
+
+void Compressed_Input::close()
+{
+  if (m_producer.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_space_cv.notify_all();
+    m_producer.join();
+  }
+  if (m_infile.is_open())
+    m_infile.close();
+  m_infile.clear();
+  m_decoder.reset();
+  m_ready.clear();
+  m_producer_done = true;
+  m_stop = false;
+  m_error = nullptr;
+  m_current.clear();
+  m_current_pos = 0;
+  m_carry.clear();
+}
+
+bool Compressed_Input::next_line(std::string_view& p_line)
+{
+  m_carry.clear();
+  while (true)
+  {
+    if (m_current_pos < m_current.size())
+    {
+      const char* begin = m_current.data() + m_current_pos;
+      const size_t remaining = m_current.size() - m_current_pos;
+      const char* end =
+          static_cast<const char*>(std::memchr(begin, '\n', remaining));
+      if (end != nullptr)
+      {
+        const size_t length = static_cast<size_t>(end - begin);
+        m_current_pos += length + 1;
+        if (m_carry.empty())
+          p_line = {begin, length};
+        else
+        {
+          m_carry.append(begin, length);
+          p_line = m_carry;
+        }
+        return true;
+      }
+      // The line continues in the next block.
+      m_carry.append(begin, remaining);
+      m_current_pos = m_current.size();
+    }
+    if (!pop_block())
+    {
+      if (m_carry.empty())
+        return false;
+      p_line = m_carry;
+      return true;
+    }
+  }
+}
+
+std::string Compressed_Input::read_all()
+{
+  std::string text(m_current, std::min(m_current_pos, m_current.size()));
+  m_current_pos = m_current.size();
+  while (pop_block())
+  {
+    text.append(m_current);
+    m_current_pos = m_current.size();
+  }
+  return text;
+}
+
+void Compressed_Input::produce()
+{
+  try
+  {
+    std::vector<char> input(k_block_size);
+    size_t input_pos = 0;
+    size_t input_size = 0;
+    bool at_eof = false;
+    bool in_member = false;
+    bool started = false;
+    std::string block(k_block_size, '\0');
+    size_t fill = 0;
+    while (true)
+    {
+      if (input_pos == input_size && !at_eof)
+      {
+        m_infile.read(input.data(), static_cast<std::streamsize>(input.size()));
+        input_size = static_cast<size_t>(m_infile.gcount());
+        input_pos = 0;
+        at_eof = input_size == 0;
+      }
+      if (at_eof && !in_member)
+        break;
+      if (!in_member)
+      {
+        if (started)
+          m_decoder->restart();
+        in_member = true;
+        started = true;
+      }
+      size_t consumed = 0;
+      size_t produced = 0;
+      const bool member_end = m_decoder->decode(input.data() + input_pos,
+                                                input_size - input_pos,
+                                                consumed,
+                                                block.data() + fill,
+                                                block.size() - fill,
+                                                produced,
+                                                at_eof);
+      input_pos += consumed;
+      fill += produced;
+      if (member_end)
+        in_member = false;
+      else if (consumed == 0 && produced == 0)
+        throw Solver_Error("unexpected end of compressed data");
+      if (fill == block.size())
+      {
+        if (!push_block(std::move(block)))
+          return;
+        block.assign(k_block_size, '\0');
+        fill = 0;
+      }
+    }
+    block.resize(fill);
+    if (fill > 0 && !push_block(std::move(block)))
+      return;
+  }
+  catch (const std::exception& error)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_error = std::make_exception_ptr(Solver_Error(
+        "c failed to decompress " + m_path + ": " + error.what()));
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_producer_done = true;
+  }
+  m_ready_cv.notify_all();
+}
+
+bool Compressed_Input::push_block(std::string&& p_block)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_space_cv.wait(
+        lock, [&] { return m_stop || m_ready.size() < k_max_queued_blocks; });
+    if (m_stop)
+      return false;
+    m_ready.push_back(std::move(p_block));
+  }
+  m_ready_cv.notify_one();
+  return true;
+}
+
+bool Compressed_Input::pop_block()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_ready_cv.wait(lock, [&] { return !m_ready.empty() || m_producer_done; });
+    if (m_ready.empty())
+    {
+      if (m_error)
+        std::rethrow_exception(m_error);
+      return false;
+    }
+    m_current = std::move(m_ready.front());
+    m_ready.pop_front();
+  }
+  m_space_cv.notify_one();
+  m_current_pos = 0;
+  return true;
+}
@@ -0,0 +1,112 @@
+/*=====================================================================================
+
+    Filename:     Compressed_Input.h
+
+    Description:  Streaming decompression of gzip/bzip2/xz/zstd model files
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+enum class Compression
+{
+  none,
+  gzip,
+  bzip2,
+  xz,
+  zstd
+};
+
+// Decompresses a model file on a producer thread while the reader consumes
+// the text line by line, so decoding and parsing overlap. Decoded blocks
+// pass through a short bounded queue; memory stays at a few blocks no
+// matter how large the model is. Concatenated members (pigz, pbzip2,
+// multi-stream xz, multi-frame zstd) are decoded back to back. A codec is
+// only available when its library was found at configure time.
+class Compressed_Input
+{
+public:
+  Compressed_Input();
+
+  ~Compressed_Input();
+
+  Compressed_Input(const Compressed_Input&) = delete;
+
+  Compressed_Input& operator=(const Compressed_Input&) = delete;
+
+  // Detected from the last extension: .gz, .bz2, .xz or .zst.
+  static Compression detect(std::string_view p_path);
+
+  // p_path without its compression extension, e.g. "a.mps.gz" -> "a.mps".
+  static std::string_view strip_extension(std::string_view p_path);
+
+  static const char* name(Compression p_compression);
+
+  static bool is_supported(Compression p_compression);
+
+  // Returns false when the file cannot be opened; throws Solver_Error when
+  // the codec was not compiled in.
+  bool open(const char* p_path, Compression p_compression);
+
+  void close();
+
+  // Same contract as std::getline. The view stays valid until the next
+  // call; corrupt or truncated input throws Solver_Error once every block
+  // decoded before the failure has been consumed.
+  bool next_line(std::string_view& p_line);
+
+  std::string read_all();
+
+private:
+  class Decoder;
+
+  static constexpr size_t k_block_size = size_t(1) << 20;
+
+  static constexpr size_t k_max_queued_blocks = 4;
+
+  std::string m_path;
+
+  std::ifstream m_infile;
+
+  std::unique_ptr<Decoder> m_decoder;
+
+  std::thread m_producer;
+
+  std::mutex m_mutex;
+
+  std::condition_variable m_ready_cv;
+
+  std::condition_variable m_space_cv;
+
+  std::deque<std::string> m_ready;
+
+  bool m_producer_done;
+
+  bool m_stop;
+
+  std::exception_ptr m_error;
+
+  std::string m_current;
+
+  size_t m_current_pos;
+
+  std::string m_carry;
+
+  void produce();
+
+  bool push_block(std::string&& p_block);
+
+  bool pop_block();
+};
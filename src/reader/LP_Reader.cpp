@@ -15,19 +15,22 @@
 #include "../model_data/Model_Var.h"
 #include "../utils/global_defs.h"
 #include "../utils/solver_error.h"
+#include "Compressed_Input.h"
 #include "LP_Reader.h"
+#include "Mapped_File.h"
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
-#include <fstream>
 #include <functional>
-#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -91,11 +94,64 @@ struct Token
   }
 };
 
+// Physical lines of an LP file, read from a memory mapping or, for
+// compressed files, from a decompression stream. Same contract as
+// std::getline; a returned view stays valid until the next call.
+class Line_Source
+{
+public:
+  Line_Source() : m_text_pos(0), m_is_streamed(false) {}
+
+  bool open(const char* p_file_name)
+  {
+    const Compression compression = Compressed_Input::detect(p_file_name);
+    m_is_streamed = compression != Compression::none;
+    if (m_is_streamed)
+      return m_stream.open(p_file_name, compression);
+    if (!m_file.open(p_file_name))
+      return false;
+    m_text = m_file.text();
+    m_text_pos = 0;
+    return true;
+  }
+
+  bool next_line(std::string_view& p_line)
+  {
+    if (m_is_streamed)
+      return m_stream.next_line(p_line);
+    if (m_text_pos >= m_text.size())
+      return false;
+    const size_t end = m_text.find('\n', m_text_pos);
+    const size_t line_end = end == std::string_view::npos ? m_text.size() : end;
+    p_line = m_text.substr(m_text_pos, line_end - m_text_pos);
+    m_text_pos = line_end + 1;
+    return true;
+  }
+
+private:
+  Mapped_File m_file;
+
+  std::string_view m_text;
+
+  size_t m_text_pos;
+
+  Compressed_Input m_stream;
+
+  bool m_is_streamed;
+};
+
+// Tokenizes the source one cleaned line at a time, so no copy of the file
+// text is made. Cleaning follows the former whole-file pass: a newline
+// inside a /* */ comment joins two lines, everything from the first "//"
+// of a line is dropped, a line whose first character is '\' is skipped,
+// and a comment still open at the end of the file discards the final line.
+// Tokens never span lines, so splitting the text this way yields the same
+// token sequence.
 class Tokenizer
 {
 public:
-  explicit Tokenizer(std::string p_content)
-      : m_content(std::move(p_content)), m_pos(0)
+  explicit Tokenizer(Line_Source& p_source)
+      : m_source(p_source), m_pos(0), m_in_block_comment(false)
   {
   }
 
@@ -123,15 +179,87 @@ public:
   }
 
 private:
+  bool read_logical_line(std::string_view& p_line)
+  {
+    m_joined_line.clear();
+    bool joined = false;
+    std::string_view line;
+    while (m_source.next_line(line))
+    {
+      for (size_t idx = 0; idx < line.size(); ++idx)
+      {
+        if (idx + 1 >= line.size())
+          break;
+        if (!m_in_block_comment && line[idx] == '/' && line[idx + 1] == '*')
+        {
+          m_in_block_comment = true;
+          ++idx;
+        }
+        else if (m_in_block_comment && line[idx] == '*' &&
+                 line[idx + 1] == '/')
+        {
+          m_in_block_comment = false;
+          ++idx;
+        }
+      }
+      if (!m_in_block_comment)
+      {
+        if (!joined)
+          p_line = line;
+        else
+        {
+          m_joined_line.append(line);
+          p_line = m_joined_line;
+        }
+        return true;
+      }
+      m_joined_line.append(line);
+      m_joined_line.push_back('\n');
+      joined = true;
+    }
+    if (m_in_block_comment)
+    {
+      printf("o Warning: unclosed block comment in LP file\n");
+      m_in_block_comment = false;
+    }
+    return false;
+  }
+
+  bool next_line()
+  {
+    std::string_view line;
+    while (read_logical_line(line))
+    {
+      const size_t comment_pos = std::min(line.find("//"), line.size());
+      size_t first_nonspace = 0;
+      while (first_nonspace < comment_pos &&
+             std::isspace(static_cast<unsigned char>(line[first_nonspace])))
+        ++first_nonspace;
+      if (first_nonspace < comment_pos && line[first_nonspace] == '\\')
+        continue;
+      m_line = line.substr(0, comment_pos);
+      m_pos = 0;
+      return true;
+    }
+    m_line = {};
+    m_pos = 0;
+    return false;
+  }
+
   Token read_token()
   {
-    const size_t size = m_content.size();
-    while (m_pos < size &&
-           std::isspace(static_cast<unsigned char>(m_content[m_pos])))
-      ++m_pos;
-    if (m_pos >= size)
-      return Token(Token_Type::end);
-    char ch = m_content[m_pos];
+    while (true)
+    {
+      while (m_pos < m_line.size() &&
+             std::isspace(static_cast<unsigned char>(m_line[m_pos])))
+        ++m_pos;
+      if (m_pos < m_line.size())
+        break;
+      if (!next_line())
+        return Token(Token_Type::end);
+    }
+    const size_t size = m_line.size();
+    char ch = m_line[m_pos];
     if (ch == ':')
     {
       ++m_pos;
@@ -145,7 +273,7 @@ private:
     if (ch == '<')
     {
       ++m_pos;
-      if (m_pos < size && m_content[m_pos] == '=')
+      if (m_pos < size && m_line[m_pos] == '=')
       {
         ++m_pos;
         return Token(Token_Type::less_equal, "<=");
@@ -155,7 +283,7 @@ private:
     if (ch == '>')
     {
       ++m_pos;
-      if (m_pos < size && m_content[m_pos] == '=')
+      if (m_pos < size && m_line[m_pos] == '=')
       {
         ++m_pos;
         return Token(Token_Type::greater_equal, ">=");
@@ -168,8 +296,8 @@ private:
       return Token(Token_Type::equal, "=");
     }
     if ((ch == '+' || ch == '-') && m_pos + 1 < size &&
-        (std::isdigit(static_cast<unsigned char>(m_content[m_pos + 1])) ||
-         m_content[m_pos + 1] == '.'))
+        (std::isdigit(static_cast<unsigned char>(m_line[m_pos + 1])) ||
+         m_line[m_pos + 1] == '.'))
       return read_number();
     if (ch == '+' || ch == '-')
     {
@@ -193,48 +321,46 @@ private:
   Token read_identifier()
   {
     size_t start = m_pos;
-    const size_t size = m_content.size();
+    const size_t size = m_line.size();
     while (m_pos < size)
     {
-      char ch = m_content[m_pos];
+      char ch = m_line[m_pos];
       if (!is_identifier_char(ch))
         break;
       ++m_pos;
     }
     return Token(Token_Type::identifier,
-                 m_content.substr(start, m_pos - start));
+                 std::string(m_line.substr(start, m_pos - start)));
   }
 
   Token read_number()
   {
     size_t start = m_pos;
-    const size_t size = m_content.size();
+    const size_t size = m_line.size();
     bool has_sign = false;
-    if (m_content[m_pos] == '+' || m_content[m_pos] == '-')
+    if (m_line[m_pos] == '+' || m_line[m_pos] == '-')
     {
       has_sign = true;
       ++m_pos;
     }
     while (m_pos < size &&
-           std::isdigit(static_cast<unsigned char>(m_content[m_pos])))
+           std::isdigit(static_cast<unsigned char>(m_line[m_pos])))
       ++m_pos;
-    if (m_pos < size && m_content[m_pos] == '.')
+    if (m_pos < size && m_line[m_pos] == '.')
     {
       ++m_pos;
       while (m_pos < size &&
-             std::isdigit(static_cast<unsigned char>(m_content[m_pos])))
+             std::isdigit(static_cast<unsigned char>(m_line[m_pos])))
         ++m_pos;
     }
-    if (m_pos < size &&
-        (m_content[m_pos] == 'e' || m_content[m_pos] == 'E'))
+    if (m_pos < size && (m_line[m_pos] == 'e' || m_line[m_pos] == 'E'))
     {
       size_t exp_pos = m_pos + 1;
-      if (exp_pos < size &&
-          (m_content[exp_pos] == '+' || m_content[exp_pos] == '-'))
+      if (exp_pos < size && (m_line[exp_pos] == '+' || m_line[exp_pos] == '-'))
         ++exp_pos;
       bool has_digit = false;
       while (exp_pos < size &&
-             std::isdigit(static_cast<unsigned char>(m_content[exp_pos])))
+             std::isdigit(static_cast<unsigned char>(m_line[exp_pos])))
       {
         has_digit = true;
         ++exp_pos;
@@ -242,18 +368,22 @@ private:
       if (has_digit)
         m_pos = exp_pos;
     }
-    std::string number_string = m_content.substr(start, m_pos - start);
-    double value;
-    try
+    std::string number_string(m_line.substr(start, m_pos - start));
+    // from_chars takes no leading '+'.
+    const char* first = number_string.data();
+    const char* last = first + number_string.size();
+    if (*first == '+')
+      ++first;
+    double value = 0.0;
+    const auto [ptr, error] = std::from_chars(first, last, value);
+    if (error == std::errc::result_out_of_range)
     {
-      value = std::stod(number_string);
+      // Overflow saturates to infinity; underflow keeps strtod's tiny value.
+      value = std::strtod(number_string.c_str(), nullptr);
+      if (std::isinf(value))
+        value = value < 0 ? k_neg_inf : k_inf;
     }
-    catch (const std::out_of_range&)
-    {
-      // Value out of double range, set to infinity
-      value = (number_string[0] == '-') ? k_neg_inf : k_inf;
-    }
-    catch (const std::invalid_argument&)
+    else if (error != std::errc() || ptr != last)
     {
       // Should not happen in theory, as we have validated the format
       printf("o invalid number format in LP file: %s\n",
@@ -265,11 +395,14 @@ private:
                     number_string.c_str());
       throw Solver_Error(message);
     }
-    return Token(Token_Type::number, number_string, value, has_sign);
+    return Token(Token_Type::number, std::move(number_string), value, has_sign);
   }
 
-  std::string m_content;
+  Line_Source& m_source;
+  std::string_view m_line;
   size_t m_pos;
+  bool m_in_block_comment;
+  std::string m_joined_line;
   std::vector<Token> m_buffer;
 };
 
@@ -350,102 +483,6 @@ bool is_binary_keyword(const std::string& p_upper)
   throw Solver_Error(p_message.c_str());
 }
 
-std::string preprocess_lp_content(const std::string& p_raw)
-{
-  std::string result;
-  result.reserve(p_raw.size());
-
-  bool in_block_comment = false;
-  const size_t size = p_raw.size();
-  size_t line_start = 0;
-
-  for (size_t idx = 0; idx < size; ++idx)
-  {
-    if (!in_block_comment && idx + 1 < size && p_raw[idx] == '/' &&
-        p_raw[idx + 1] == '*')
-    {
-      in_block_comment = true;
-      ++idx;
-      continue;
-    }
-    if (in_block_comment)
-    {
-      if (idx + 1 < size && p_raw[idx] == '*' && p_raw[idx + 1] == '/')
-      {
-        in_block_comment = false;
-        ++idx;
-      }
-      continue;
-    }
-    if (p_raw[idx] == '\n')
-    {
-      size_t line_length = idx - line_start;
-      if (line_length > 0)
-      {
-        const char* line_ptr = p_raw.data() + line_start;
-        size_t comment_pos = line_length;
-        for (size_t i = 0; i + 1 < line_length; ++i)
-        {
-          if (line_ptr[i] == '/' && line_ptr[i + 1] == '/')
-          {
-            comment_pos = i;
-            break;
-          }
-        }
-        size_t first_nonspace = 0;
-        while (first_nonspace < comment_pos &&
-               std::isspace(
-                   static_cast<unsigned char>(line_ptr[first_nonspace])))
-          ++first_nonspace;
-        if (first_nonspace < comment_pos &&
-            line_ptr[first_nonspace] == '\\')
-        {
-          line_start = idx + 1;
-          continue;
-        }
-        result.append(line_ptr, comment_pos);
-      }
-
-      result.push_back('\n');
-      line_start = idx + 1;
-      continue;
-    }
-  }
-  if (line_start < size && !in_block_comment)
-  {
-    size_t line_length = size - line_start;
-    const char* line_ptr = p_raw.data() + line_start;
-
-    size_t comment_pos = line_length;
-    for (size_t i = 0; i + 1 < line_length; ++i)
-    {
-      if (line_ptr[i] == '/' && line_ptr[i + 1] == '/')
-      {
-        comment_pos = i;
-        break;
-      }
-    }
-
-    size_t first_nonspace = 0;
-    while (
-        first_nonspace < comment_pos &&
-        std::isspace(static_cast<unsigned char>(line_ptr[first_nonspace])))
-      ++first_nonspace;
-
-    if (first_nonspace >= comment_pos || line_ptr[first_nonspace] != '\\')
-    {
-      result.append(line_ptr, comment_pos);
-      result.push_back('\n');
-    }
-  }
-  if (in_block_comment)
-  {
-    printf("o Warning: unclosed block comment in LP file\n");
-  }
-
-  return result;
-}
-
 Linear_Expression parse_linear_expression(
     Tokenizer& p_tokenizer,
     const std::function<bool(const Token&)>& p_should_stop)
@@ -558,8 +595,8 @@ LP_Reader::LP_Reader(Model_Manager* p_model_manager)
 void LP_Reader::read(const char* p_file_name)
 {
   auto start_time = std::chrono::high_resolution_clock::now();
-  std::ifstream infile(p_file_name);
-  if (!infile)
+  lp_internal::Line_Source source;
+  if (!source.open(p_file_name))
   {
     printf("o The input filename %s is invalid.\n", p_file_name);
     char message[256];
@@ -569,11 +606,7 @@ void LP_Reader::read(const char* p_file_name)
                   p_file_name);
     throw Solver_Error(message);
   }
-  std::ostringstream buffer;
-  buffer << infile.rdbuf();
-  infile.close();
-  std::string cleaned_content = preprocess_lp_content(buffer.str());
-  lp_internal::Tokenizer tokenizer(cleaned_content);
+  lp_internal::Tokenizer tokenizer(source);
   m_model_manager->make_con("");
   parse_objective(tokenizer);
   while (true)
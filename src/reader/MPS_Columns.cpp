@@ -0,0 +1,394 @@
+/*=====================================================================================
+
+    Filename:     MPS_Columns.cpp
+
+    Description:  Parallel chunked parsing of the MPS COLUMNS section
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "../model_data/Model_Con.h"
+#include "../model_data/Model_Var.h"
+#include "../utils/global_defs.h"
+#include "../utils/parallel_tasks.h"
+#include "MPS_Reader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+constexpr Model_Idx k_ignored_row = k_null_idx;
+
+} // namespace
+
+// One worker's share of COLUMNS. Workers only tokenize and resolve row
+// names; variables are numbered per chunk in order of first appearance and
+// mapped to model indices by the serial merge, which also replays the
+// INTORG/INTEND markers so integrality and error order match a serial read.
+struct MPS_Reader::Column_Chunk
+{
+  struct Term
+  {
+    Model_Idx local_var;
+
+    Model_Idx con_idx;
+
+    double coeff;
+  };
+
+  struct Marker
+  {
+    std::string_view line;
+
+    bool begins_integer;
+  };
+
+  std::string_view text;
+
+  const std::unordered_map<std::string_view, Model_Idx>* row_lookup;
+
+  std::vector<Term> terms;
+
+  std::vector<std::string_view> var_names;
+
+  // Marker state at the first appearance of each local variable; -1 means
+  // no marker was seen yet in this chunk, so the entry state applies.
+  std::vector<int8_t> var_marker;
+
+  std::vector<Marker> markers;
+
+  std::vector<Model_Idx> var_idx;
+
+  std::vector<Model_Idx> var_term_pos;
+
+  std::vector<Model_Idx> row_term_pos;
+
+  std::string_view error_line;
+
+  bool has_error = false;
+
+  size_t small_coeff_num = 0;
+};
+
+void MPS_Reader::set_column_workers(size_t p_worker_num)
+{
+  m_column_worker_num = p_worker_num;
+}
+
+size_t MPS_Reader::find_columns_end() const
+{
+  size_t pos = m_text_pos;
+  while (pos < m_text.size() && m_text[pos] != 'R')
+  {
+    pos = m_text.find('\n', pos);
+    if (pos == std::string_view::npos)
+      return m_text.size();
+    ++pos;
+  }
+  return std::min(pos, m_text.size());
+}
+
+size_t MPS_Reader::column_worker_num(size_t p_region_size) const
+{
+  const size_t worker_num = resolve_worker_num(m_column_worker_num);
+  return std::min(worker_num,
+                  std::max<size_t>(1, p_region_size / m_min_column_chunk));
+}
+
+void MPS_Reader::read_columns_parallel(size_t p_region_end,
+                                       size_t p_worker_num)
+{
+  const std::string_view region =
+      m_text.substr(m_text_pos, p_region_end - m_text_pos);
+
+  std::unordered_map<std::string_view, Model_Idx> row_lookup;
+  const auto& con_name_to_idx = m_model_manager->con_name_to_idx();
+  row_lookup.reserve(con_name_to_idx.size() + m_ignored_free_rows.size() +
+                     1);
+  for (const auto& [con_name, con_idx] : con_name_to_idx)
+    row_lookup.emplace(con_name, static_cast<Model_Idx>(con_idx));
+  row_lookup.insert_or_assign(m_model_manager->get_obj_name(), 0);
+  for (const std::string& free_row_name : m_ignored_free_rows)
+    row_lookup.insert_or_assign(free_row_name, k_ignored_row);
+
+  auto first_field = [](std::string_view p_line)
+  {
+    size_t field_pos = 0;
+    std::string_view field;
+    scan_field(p_line.substr(0, record_data_size(p_line)), field_pos, field);
+    return field;
+  };
+  // Moves a split point to the next line start whose record names a
+  // different column than the line before it.
+  auto next_column_start = [&](size_t p_pos)
+  {
+    if (p_pos == 0 || p_pos >= region.size())
+      return std::min(p_pos, region.size());
+    if (region[p_pos - 1] != '\n')
+    {
+      p_pos = region.find('\n', p_pos);
+      if (p_pos == std::string_view::npos)
+        return region.size();
+      ++p_pos;
+    }
+    const size_t prev_begin = region.rfind('\n', p_pos - 2);
+    const size_t prev_start =
+        prev_begin == std::string_view::npos ? 0 : prev_begin + 1;
+    const std::string_view prev_column =
+        first_field(region.substr(prev_start, p_pos - 1 - prev_start));
+    while (p_pos < region.size())
+    {
+      size_t line_end = region.find('\n', p_pos);
+      if (line_end == std::string_view::npos)
+        line_end = region.size();
+      if (first_field(region.substr(p_pos, line_end - p_pos)) !=
+          prev_column)
+        break;
+      p_pos = line_end + 1;
+    }
+    return std::min(p_pos, region.size());
+  };
+
+  std::vector<Column_Chunk> chunks(p_worker_num);
+  size_t chunk_begin = 0;
+  for (size_t chunk_idx = 0; chunk_idx < p_worker_num; ++chunk_idx)
+  {
+    size_t chunk_end = region.size();
+    if (chunk_idx + 1 < p_worker_num)
+      chunk_end = next_column_start(std::max(
+          chunk_begin,
+          slice_begin(region.size(), chunk_idx + 1, p_worker_num)));
+    chunks[chunk_idx].text =
+        region.substr(chunk_begin, chunk_end - chunk_begin);
+    chunks[chunk_idx].row_lookup = &row_lookup;
+    chunk_begin = chunk_end;
+  }
+
+  run_tasks(p_worker_num,
+            [&](size_t p_chunk_idx)
+            { parse_column_chunk(chunks[p_chunk_idx]); });
+  merge_column_chunks(chunks, p_worker_num);
+
+  m_text_pos = p_region_end;
+  next_line(); // consumes the RHS header, as the serial loop does
+}
+
+void MPS_Reader::parse_column_chunk(Column_Chunk& p_chunk) const
+{
+  const auto& row_lookup = *p_chunk.row_lookup;
+  const double zero_tolerance = m_model_manager->zero_tolerance();
+  std::unordered_map<std::string_view, Model_Idx> local_vars;
+  int8_t marker_state = -1;
+
+  // Mirrors add_coeff_var_to_con: the column is declared before ignored
+  // rows and small coefficients are dropped.
+  auto add_term =
+      [&](std::string_view p_con_name, double p_coeff, std::string_view p_var)
+  {
+    auto [iter, inserted] = local_vars.try_emplace(
+        p_var, static_cast<Model_Idx>(p_chunk.var_names.size()));
+    if (inserted)
+    {
+      p_chunk.var_names.push_back(p_var);
+      p_chunk.var_marker.push_back(marker_state);
+    }
+    auto row = row_lookup.find(p_con_name);
+    if (row != row_lookup.end() && row->second == k_ignored_row)
+      return true;
+    if (is_effectively_zero(p_coeff, zero_tolerance))
+    {
+      ++p_chunk.small_coeff_num;
+      return true;
+    }
+    if (row == row_lookup.end())
+      return false;
+    p_chunk.terms.push_back({iter->second, row->second, p_coeff});
+    return true;
+  };
+  auto fail = [&](std::string_view p_line)
+  {
+    p_chunk.error_line = p_line;
+    p_chunk.has_error = true;
+  };
+
+  const std::string_view text = p_chunk.text;
+  size_t line_begin = 0;
+  while (line_begin < text.size())
+  {
+    size_t line_end = text.find('\n', line_begin);
+    if (line_end == std::string_view::npos)
+      line_end = text.size();
+    const std::string_view line =
+        text.substr(line_begin, line_end - line_begin);
+    line_begin = line_end + 1;
+    if (line.empty() || line[0] == '*')
+      continue;
+
+    const std::string_view record = line.substr(0, record_data_size(line));
+    size_t field_pos = 0;
+    std::string_view var_name;
+    std::string_view con_name;
+    if (!(scan_field(record, field_pos, var_name) &&
+          scan_field(record, field_pos, con_name)))
+    {
+      if (!is_blank(line))
+      {
+        fail(line);
+        return;
+      }
+      continue;
+    }
+    if (con_name == "\'MARKER\'")
+    {
+      std::string_view marker;
+      if (!scan_field(record, field_pos, marker))
+      {
+        fail(line);
+        return;
+      }
+      if (marker == "\'INTORG\'")
+        marker_state = 1;
+      else if (marker == "\'INTEND\'")
+        marker_state = 0;
+      else
+      {
+        fail(line);
+        return;
+      }
+      p_chunk.markers.push_back({line, marker_state == 1});
+      continue;
+    }
+    double coeff = 0.0;
+    if (!scan_number(record, field_pos, coeff) || !std::isfinite(coeff) ||
+        !add_term(con_name, coeff, var_name))
+    {
+      fail(line);
+      return;
+    }
+    if (scan_field(record, field_pos, con_name))
+    {
+      if (!scan_number(record, field_pos, coeff) ||
+          !std::isfinite(coeff) || !add_term(con_name, coeff, var_name))
+      {
+        fail(line);
+        return;
+      }
+    }
+  }
+}
+
+void MPS_Reader::merge_column_chunks(std::vector<Column_Chunk>& p_chunks,
+                                     size_t p_worker_num)
+{
+  for (auto& chunk : p_chunks)
+  {
+    const bool entry_marker = m_integrality_marker;
+    for (const auto& marker : chunk.markers)
+    {
+      if (marker.begins_integer == m_integrality_marker)
+        printf_error_line(marker.line);
+      m_integrality_marker = marker.begins_integer;
+    }
+    if (chunk.has_error)
+      printf_error_line(chunk.error_line);
+    chunk.var_idx.resize(chunk.var_names.size());
+    for (size_t local_var = 0; local_var < chunk.var_names.size();
+         ++local_var)
+    {
+      const bool requires_integrality = chunk.var_marker[local_var] < 0
+                                            ? entry_marker
+                                            : chunk.var_marker[local_var] > 0;
+      chunk.var_idx[local_var] = static_cast<Model_Idx>(
+          m_model_manager->make_var(std::string(chunk.var_names[local_var]),
+                                    requires_integrality));
+    }
+    m_small_coeff_counter += chunk.small_coeff_num;
+  }
+
+  // Counting sort of the terms into rows and columns: chunk k's terms of a
+  // row start after those of chunks 0..k-1, which reproduces the serial
+  // term order. The per-chunk row counters cost one index per row each.
+  const size_t con_num = m_model_manager->con_name_to_idx().size();
+  const size_t var_num = m_model_manager->var_name_to_idx().size();
+  run_tasks(p_worker_num,
+            [&](size_t p_chunk_idx)
+            {
+              auto& chunk = p_chunks[p_chunk_idx];
+              chunk.row_term_pos.assign(con_num, 0);
+              chunk.var_term_pos.assign(chunk.var_names.size(), 0);
+              for (const auto& term : chunk.terms)
+              {
+                ++chunk.row_term_pos[term.con_idx];
+                ++chunk.var_term_pos[term.local_var];
+              }
+            });
+
+  run_tasks(p_worker_num,
+            [&](size_t p_part)
+            {
+              const size_t end = slice_begin(con_num, p_part + 1, p_worker_num);
+              for (size_t con_idx = slice_begin(con_num, p_part, p_worker_num);
+                   con_idx < end;
+                   ++con_idx)
+              {
+                auto& con = m_model_manager->con(con_idx);
+                size_t term_num = con.term_num();
+                for (auto& chunk : p_chunks)
+                {
+                  const Model_Idx count = chunk.row_term_pos[con_idx];
+                  chunk.row_term_pos[con_idx] =
+                      static_cast<Model_Idx>(term_num);
+                  term_num += count;
+                }
+                con.resize_terms(term_num);
+              }
+            });
+
+  std::vector<Model_Idx> var_term_num(var_num);
+  for (size_t var_idx = 0; var_idx < var_num; ++var_idx)
+    var_term_num[var_idx] =
+        static_cast<Model_Idx>(m_model_manager->var(var_idx).term_num());
+  for (auto& chunk : p_chunks)
+  {
+    for (size_t local_var = 0; local_var < chunk.var_idx.size(); ++local_var)
+    {
+      const Model_Idx count = chunk.var_term_pos[local_var];
+      chunk.var_term_pos[local_var] = var_term_num[chunk.var_idx[local_var]];
+      var_term_num[chunk.var_idx[local_var]] += count;
+    }
+  }
+
+  run_tasks(p_worker_num,
+            [&](size_t p_part)
+            {
+              const size_t end = slice_begin(var_num, p_part + 1, p_worker_num);
+              for (size_t var_idx = slice_begin(var_num, p_part, p_worker_num);
+                   var_idx < end;
+                   ++var_idx)
+                m_model_manager->var(var_idx).resize_terms(
+                    var_term_num[var_idx]);
+            });
+
+  run_tasks(p_worker_num,
+            [&](size_t p_chunk_idx)
+            {
+              auto& chunk = p_chunks[p_chunk_idx];
+              for (const auto& term : chunk.terms)
+              {
+                const size_t var_idx = chunk.var_idx[term.local_var];
+                const size_t pos_in_con = chunk.row_term_pos[term.con_idx]++;
+                const size_t pos_in_var = chunk.var_term_pos[term.local_var]++;
+                m_model_manager->con(term.con_idx)
+                    .set_term(pos_in_con, var_idx, term.coeff, pos_in_var);
+                m_model_manager->var(var_idx).set_term(
+                    pos_in_var, term.con_idx, pos_in_con);
+              }
+            });
+}
@@ -22,33 +22,89 @@
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
-#include <fstream>
-#include <ios>
-#include <iostream>
+#include <charconv>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 MPS_Reader::MPS_Reader(Model_Manager* p_model_manager)
-    : m_model_manager(p_model_manager), m_integrality_marker(false),
-      m_small_coeff_counter(0)
+    : m_model_manager(p_model_manager), m_is_streamed(false), m_text_pos(0),
+      m_field_pos(0), m_integrality_marker(false), m_small_coeff_counter(0),
+      m_column_worker_num(0), m_min_column_chunk(k_min_column_chunk)
 {
 }
 
+// Accepts what `std::istream >> double` accepts: an optional '+' or '-',
+// then the longest decimal prefix. A dangling exponent marker ("1e", "1e+")
+// fails instead of stopping before the 'e', and an out-of-range magnitude
+// fails on overflow but rounds on underflow, as libstdc++ does.
+bool MPS_Reader::parse_number(std::string_view p_text,
+                              double& p_value,
+                              size_t& p_consumed)
+{
+  size_t begin = 0;
+  if (!p_text.empty() && p_text[0] == '+')
+  {
+    if (p_text.size() > 1 && p_text[1] == '-')
+      return false;
+    begin = 1;
+  }
+  const char* first = p_text.data() + begin;
+  const char* last = p_text.data() + p_text.size();
+  auto [ptr, ec] = std::from_chars(first, last, p_value);
+  if (ec == std::errc::invalid_argument)
+    return false;
+  if (ptr != last && (*ptr == 'e' || *ptr == 'E') &&
+      std::string_view(first, ptr - first).find_first_of("eE") ==
+          std::string_view::npos)
+    return false;
+  if (ec == std::errc::result_out_of_range)
+  {
+    const std::string digits(first, ptr);
+    p_value = std::strtod(digits.c_str(), nullptr);
+    if (std::isinf(p_value))
+      return false;
+  }
+  p_consumed = static_cast<size_t>(ptr - p_text.data());
+  return true;
+}
+
+bool MPS_Reader::scan_number(std::string_view p_record,
+                             size_t& p_pos,
+                             double& p_value)
+{
+  skip_space(p_record, p_pos);
+  size_t consumed = 0;
+  if (!parse_number(p_record.substr(p_pos), p_value, consumed))
+  {
+    p_pos = p_record.size();
+    return false;
+  }
+  p_pos += consumed;
+  return true;
+}
+
+bool MPS_Reader::next_number(double& p_value)
+{
+  return scan_number(m_record, m_field_pos, p_value);
+}
+
 bool MPS_Reader::read_optional_bound_value(double& p_value)
 {
-  std::string value_text;
-  if (!(m_iss >> value_text))
+  std::string_view value_text;
+  if (!next_field(value_text))
     return false;
 
-  std::istringstream value_stream(value_text);
-  char trailing_char = '\0';
-  if (!(value_stream >> p_value) || (value_stream >> trailing_char))
+  size_t consumed = 0;
+  if (!parse_number(value_text, p_value, consumed) ||
+      consumed != value_text.size())
     printf_error_line(m_read_line);
 
-  std::string extra_field;
-  if (m_iss >> extra_field)
+  std::string_view extra_field;
+  if (next_field(extra_field))
     printf_error_line(m_read_line);
   return true;
 }
@@ -59,8 +115,12 @@ void MPS_Reader::read(const char* p_model_file)
   m_integrality_marker = false;
   m_small_coeff_counter = 0;
   m_ignored_free_rows.clear();
-  std::ifstream infile(p_model_file);
-  if (!infile)
+  const Compression compression = Compressed_Input::detect(p_model_file);
+  m_is_streamed = compression != Compression::none;
+  const bool opened = m_is_streamed
+                          ? m_stream.open(p_model_file, compression)
+                          : m_file.open(p_model_file);
+  if (!opened)
   {
     printf("c The model file %s is not found.\n", p_model_file);
     char message[256];
@@ -70,19 +130,20 @@ void MPS_Reader::read(const char* p_model_file)
                   p_model_file);
     throw Solver_Error(message);
   }
+  m_text = m_is_streamed ? std::string_view() : m_file.text();
+  m_text_pos = 0;
   std::string model_name;
   std::string temp_str;
   char con_type;
   std::string con_name;
   std::string var_name;
-  double coeff = 0.0;
   double rhs = 0.0;
   std::string bound_type;
   double input_bound = 0.0;
 
   auto read_next_record = [&]()
   {
-    while (std::getline(infile, m_read_line))
+    while (next_line())
     {
       if (m_read_line.empty() || m_read_line[0] == '*' ||
           is_blank(m_read_line))
@@ -95,10 +156,10 @@ void MPS_Reader::read(const char* p_model_file)
   if (!read_next_record())
     throw Solver_Error("c empty MPS file");
 
-  iss_setup();
-  if (!(m_iss >> temp_str) || temp_str != "NAME")
+  record_setup();
+  if (!next_field(temp_str) || temp_str != "NAME")
     printf_error_line(m_read_line);
-  m_iss >> model_name;
+  next_field(model_name);
   printf("c model name: %s\n", model_name.c_str());
 
   std::string requested_obj_name;
@@ -106,8 +167,8 @@ void MPS_Reader::read(const char* p_model_file)
     throw Solver_Error("c ROWS section is missing");
   while (true) // optional OBJSENSE and OBJNAME sections
   {
-    iss_setup();
-    if (!(m_iss >> temp_str))
+    record_setup();
+    if (!next_field(temp_str))
       printf_error_line(m_read_line);
     if (temp_str == "ROWS")
       break;
@@ -115,16 +176,16 @@ void MPS_Reader::read(const char* p_model_file)
     if (temp_str == "OBJSENSE")
     {
       std::string obj_sense;
-      if (!(m_iss >> obj_sense))
+      if (!(next_field(obj_sense)))
       {
         if (!read_next_record())
           throw Solver_Error("c OBJSENSE value is missing");
-        iss_setup();
-        if (!(m_iss >> obj_sense))
+        record_setup();
+        if (!(next_field(obj_sense)))
           printf_error_line(m_read_line);
       }
-      std::string extra_field;
-      if (m_iss >> extra_field)
+      std::string_view extra_field;
+      if (next_field(extra_field))
         printf_error_line(m_read_line);
       if (obj_sense == "MAX" || obj_sense == "MAXIMIZE")
         m_model_manager->setup_max();
@@ -135,16 +196,16 @@ void MPS_Reader::read(const char* p_model_file)
     {
       if (!requested_obj_name.empty())
         printf_error_line(m_read_line);
-      if (!(m_iss >> requested_obj_name))
+      if (!(next_field(requested_obj_name)))
       {
         if (!read_next_record())
           throw Solver_Error("c OBJNAME value is missing");
-        iss_setup();
-        if (!(m_iss >> requested_obj_name))
+        record_setup();
+        if (!(next_field(requested_obj_name)))
           printf_error_line(m_read_line);
       }
-      std::string extra_field;
-      if (m_iss >> extra_field)
+      std::string_view extra_field;
+      if (next_field(extra_field))
         printf_error_line(m_read_line);
     }
     else
@@ -157,14 +218,14 @@ void MPS_Reader::read(const char* p_model_file)
   std::vector<std::string> free_row_names;
   std::unordered_set<std::string> free_row_name_set;
   m_model_manager->make_con("");            // obj
-  while (std::getline(infile, m_read_line)) // ROWS section
+  while (next_line()) // ROWS section
   {
     if (m_read_line.empty() || m_read_line[0] == '*')
       continue;
     if (m_read_line[0] == 'C')
       break;
-    iss_setup();
-    if (!(m_iss >> con_type >> con_name))
+    record_setup();
+    if (!(next_char(con_type) && next_field(con_name)))
     {
       if (!is_blank(m_read_line))
         printf_error_line(m_read_line);
@@ -172,8 +233,8 @@ void MPS_Reader::read(const char* p_model_file)
         continue;
     }
 
-    std::string extra_field;
-    if (m_iss >> extra_field)
+    std::string_view extra_field;
+    if (next_field(extra_field))
       printf_error_line(m_read_line);
 
     if (con_type == 'N')
@@ -214,53 +275,16 @@ void MPS_Reader::read(const char* p_model_file)
            m_ignored_free_rows.size());
   }
 
-  while (std::getline(infile, m_read_line)) // COLUMNS section
+  if (m_is_streamed)
+    read_columns();
+  else
   {
-    if (m_read_line.empty() || m_read_line[0] == '*')
-      continue;
-    if (m_read_line[0] == 'R')
-      break;
-    iss_setup();
-    if (!(m_iss >> var_name >> con_name))
-    {
-      if (!is_blank(m_read_line))
-        printf_error_line(m_read_line);
-      else
-        continue;
-    }
-    if (con_name == "\'MARKER\'")
-    {
-      if (!(m_iss >> temp_str))
-        printf_error_line(m_read_line);
-      if (temp_str == "\'INTORG\'")
-      {
-        if (m_integrality_marker)
-          printf_error_line(m_read_line);
-        m_integrality_marker = true;
-      }
-      else if (temp_str == "\'INTEND\'")
-      {
-        if (!m_integrality_marker)
-          printf_error_line(m_read_line);
-        m_integrality_marker = false;
-      }
-      else
-        printf_error_line(m_read_line);
-      continue;
-    }
-    if (!(m_iss >> coeff))
-      printf_error_line(m_read_line);
-    if (!std::isfinite(coeff))
-      printf_error_line(m_read_line);
-    add_coeff_var_to_con(con_name, coeff, var_name);
-    if (m_iss >> con_name)
-    {
-      if (!(m_iss >> coeff))
-        printf_error_line(m_read_line);
-      if (!std::isfinite(coeff))
-        printf_error_line(m_read_line);
-      add_coeff_var_to_con(con_name, coeff, var_name);
-    }
+    const size_t columns_end = find_columns_end();
+    const size_t worker_num = column_worker_num(columns_end - m_text_pos);
+    if (worker_num > 1)
+      read_columns_parallel(columns_end, worker_num);
+    else
+      read_columns();
   }
   if (m_integrality_marker)
     throw Solver_Error("c unterminated INTORG marker in COLUMNS section");
@@ -275,7 +299,7 @@ void MPS_Reader::read(const char* p_model_file)
     else
       m_model_manager->set_rhs(row_name, rhs_value);
   };
-  while (std::getline(infile, m_read_line)) // rhs  section
+  while (next_line()) // rhs  section
   {
     if (m_read_line.empty() || m_read_line[0] == '*')
       continue;
@@ -284,8 +308,8 @@ void MPS_Reader::read(const char* p_model_file)
       break;
     if (m_read_line[0] == 'S') // do not handle SOS
       printf_error_line(m_read_line);
-    iss_setup();
-    if (!(m_iss >> temp_str >> con_name >> rhs))
+    record_setup();
+    if (!(next_field(temp_str) && next_field(con_name) && next_number(rhs)))
     {
       if (!is_blank(m_read_line))
         printf_error_line(m_read_line);
@@ -299,9 +323,9 @@ void MPS_Reader::read(const char* p_model_file)
     const bool use_rhs = temp_str == selected_rhs_name;
     if (use_rhs)
       apply_rhs_to_row(con_name, rhs);
-    if (m_iss >> con_name)
+    if (next_field(con_name))
     {
-      if (!(m_iss >> rhs))
+      if (!next_number(rhs))
         printf_error_line(m_read_line);
       if (!std::isfinite(rhs))
         printf_error_line(m_read_line);
@@ -370,7 +394,7 @@ void MPS_Reader::read(const char* p_model_file)
         add_range_constraint(con, lower_rhs, '>');
       }
     };
-    while (std::getline(infile, m_read_line))
+    while (next_line())
     {
       if (m_read_line.empty() || m_read_line[0] == '*')
         continue;
@@ -378,9 +402,10 @@ void MPS_Reader::read(const char* p_model_file)
         break;
       if (m_read_line[0] == 'S') // do not handle SOS
         printf_error_line(m_read_line);
-      iss_setup();
+      record_setup();
       double range_value = 0.0;
-      if (!(m_iss >> temp_str >> con_name >> range_value))
+      if (!(next_field(temp_str) && next_field(con_name) &&
+            next_number(range_value)))
       {
         if (!is_blank(m_read_line))
           printf_error_line(m_read_line);
@@ -394,9 +419,9 @@ void MPS_Reader::read(const char* p_model_file)
       const bool use_range = temp_str == selected_range_name;
       if (use_range)
         apply_range_to_row(con_name, range_value);
-      while (m_iss >> con_name)
+      while (next_field(con_name))
       {
-        if (!(m_iss >> range_value))
+        if (!next_number(range_value))
           printf_error_line(m_read_line);
         if (!std::isfinite(range_value))
           printf_error_line(m_read_line);
@@ -408,7 +433,7 @@ void MPS_Reader::read(const char* p_model_file)
   std::string selected_bound_name;
   std::unordered_set<std::string> lower_bound_vars;
   std::unordered_set<std::string> upper_bound_vars;
-  while (std::getline(infile, m_read_line)) // BOUNDS section
+  while (next_line()) // BOUNDS section
   {
     if (m_read_line.empty() || m_read_line[0] == '*')
       continue;
@@ -416,8 +441,9 @@ void MPS_Reader::read(const char* p_model_file)
       break;
     if (m_read_line[0] == 'I') // do not handle INDICATORS
       printf_error_line(m_read_line);
-    iss_setup();
-    if (!(m_iss >> bound_type >> temp_str >> var_name))
+    record_setup();
+    if (!(next_field(bound_type) && next_field(temp_str) &&
+          next_field(var_name)))
     {
       if (!is_blank(m_read_line))
         printf_error_line(m_read_line);
@@ -516,7 +542,11 @@ void MPS_Reader::read(const char* p_model_file)
     else if (bound_type == "PL")
       m_model_manager->set_var_upper_bound(var, k_inf);
   }
-  infile.close();
+  m_read_line = {};
+  m_record = {};
+  m_text = {};
+  m_file.close();
+  m_stream.close();
   if (m_small_coeff_counter > 0)
     printf("c skipped %zu coefficients smaller than %.3e.\n",
            m_small_coeff_counter,
@@ -528,6 +558,62 @@ void MPS_Reader::read(const char* p_model_file)
          duration.count() / 1000.0);
 }
 
+void MPS_Reader::read_columns()
+{
+  std::string var_name;
+  std::string con_name;
+  std::string temp_str;
+  double coeff = 0.0;
+  while (next_line())
+  {
+    if (m_read_line.empty() || m_read_line[0] == '*')
+      continue;
+    if (m_read_line[0] == 'R')
+      break;
+    record_setup();
+    if (!(next_field(var_name) && next_field(con_name)))
+    {
+      if (!is_blank(m_read_line))
+        printf_error_line(m_read_line);
+      else
+        continue;
+    }
+    if (con_name == "\'MARKER\'")
+    {
+      if (!next_field(temp_str))
+        printf_error_line(m_read_line);
+      if (temp_str == "\'INTORG\'")
+      {
+        if (m_integrality_marker)
+          printf_error_line(m_read_line);
+        m_integrality_marker = true;
+      }
+      else if (temp_str == "\'INTEND\'")
+      {
+        if (!m_integrality_marker)
+          printf_error_line(m_read_line);
+        m_integrality_marker = false;
+      }
+      else
+        printf_error_line(m_read_line);
+      continue;
+    }
+    if (!next_number(coeff))
+      printf_error_line(m_read_line);
+    if (!std::isfinite(coeff))
+      printf_error_line(m_read_line);
+    add_coeff_var_to_con(con_name, coeff, var_name);
+    if (next_field(con_name))
+    {
+      if (!next_number(coeff))
+        printf_error_line(m_read_line);
+      if (!std::isfinite(coeff))
+        printf_error_line(m_read_line);
+      add_coeff_var_to_con(con_name, coeff, var_name);
+    }
+  }
+}
+
 void MPS_Reader::add_coeff_var_to_con(const std::string& p_con_name,
                                       double p_coeff,
                                       const std::string& p_var_name)
@@ -550,7 +636,11 @@ void MPS_Reader::add_coeff_var_to_con(const std::string& p_con_name,
   }
   else
   {
-    con_idx = m_model_manager->con_idx(p_con_name);
+    const auto& con_name_to_idx = m_model_manager->con_name_to_idx();
+    auto iter = con_name_to_idx.find(p_con_name);
+    if (iter == con_name_to_idx.end())
+      printf_error_line(m_read_line);
+    con_idx = iter->second;
     con = &m_model_manager->con(con_idx);
   }
   auto& var = m_model_manager->var(var_idx);
@@ -14,20 +14,42 @@
 #pragma once
 #include "../model_data/Model_Manager.h"
 #include "../utils/solver_error.h"
+#include "Compressed_Input.h"
+#include "Mapped_File.h"
 #include <cctype>
 #include <cstddef>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_set>
-
+#include <vector>
+
+// Reads fixed or free MPS from a memory-mapped file. Records are views into
+// the mapping and fields are tokenized in place; the field and number
+// readers follow the semantics of the std::istream extraction used before,
+// so accepted models and reported error lines are unchanged. Large COLUMNS
+// sections are split at column boundaries and parsed by worker threads.
+// Compressed files are streamed line by line from a decompression thread
+// instead; COLUMNS is then read serially.
 class MPS_Reader
 {
 private:
   Model_Manager* m_model_manager;
 
-  std::istringstream m_iss;
+  Mapped_File m_file;
+
+  Compressed_Input m_stream;
+
+  bool m_is_streamed;
+
+  std::string_view m_text;
+
+  size_t m_text_pos;
+
+  std::string_view m_read_line;
+
+  std::string_view m_record;
 
-  std::string m_read_line;
+  size_t m_field_pos;
 
   bool m_integrality_marker;
 
@@ -35,9 +57,41 @@ private:
 
   std::unordered_set<std::string> m_ignored_free_rows;
 
-  inline size_t record_data_size(const std::string& p_record) const;
+  size_t m_column_worker_num;
+
+  size_t m_min_column_chunk;
+
+  static constexpr size_t k_min_column_chunk = size_t(1) << 20;
+
+  struct Column_Chunk;
+
+  inline static size_t record_data_size(std::string_view p_record);
+
+  inline bool next_line();
+
+  inline void record_setup();
+
+  inline static void skip_space(std::string_view p_record, size_t& p_pos);
 
-  inline void iss_setup();
+  inline static bool scan_field(std::string_view p_record,
+                                size_t& p_pos,
+                                std::string_view& p_field);
+
+  static bool scan_number(std::string_view p_record,
+                          size_t& p_pos,
+                          double& p_value);
+
+  inline bool next_field(std::string_view& p_field);
+
+  inline bool next_field(std::string& p_field);
+
+  inline bool next_char(char& p_char);
+
+  bool next_number(double& p_value);
+
+  static bool parse_number(std::string_view p_text,
+                           double& p_value,
+                           size_t& p_consumed);
 
   bool read_optional_bound_value(double& p_value);
 
@@ -47,29 +101,113 @@ private:
 
   void print_con(const Model_Con& p_con);
 
-  inline bool is_blank(const std::string& p) const;
+  void read_columns();
+
+  size_t find_columns_end() const;
 
-  inline void printf_error_line(const std::string& p) const;
+  size_t column_worker_num(size_t p_region_size) const;
+
+  void read_columns_parallel(size_t p_region_end, size_t p_worker_num);
+
+  void parse_column_chunk(Column_Chunk& p_chunk) const;
+
+  void merge_column_chunks(std::vector<Column_Chunk>& p_chunks,
+                           size_t p_worker_num);
+
+  inline static bool is_blank(std::string_view p_record);
+
+  inline void printf_error_line(std::string_view p_record) const;
 
 public:
   MPS_Reader(Model_Manager* p_model_manager);
 
+  // 0 uses std::thread::hardware_concurrency(); 1 keeps COLUMNS serial.
+  void set_column_workers(size_t p_worker_num);
+
   void read(const char* p_model_file);
 };
 
-inline void MPS_Reader::iss_setup()
+// Same contract as std::getline: the record excludes the '\n', a final
+// record without a terminator is still returned, and the record is
+// cleared once the text is exhausted.
+inline bool MPS_Reader::next_line()
 {
-  m_iss.clear();
-  const size_t data_size = record_data_size(m_read_line);
-  if (data_size == m_read_line.size())
-    m_iss.str(m_read_line);
+  if (m_is_streamed)
+  {
+    if (m_stream.next_line(m_read_line))
+      return true;
+    m_read_line = {};
+    return false;
+  }
+  if (m_text_pos >= m_text.size())
+  {
+    m_read_line = {};
+    return false;
+  }
+  const size_t end = m_text.find('\n', m_text_pos);
+  if (end == std::string_view::npos)
+  {
+    m_read_line = m_text.substr(m_text_pos);
+    m_text_pos = m_text.size();
+  }
   else
-    m_iss.str(m_read_line.substr(0, data_size));
-  m_iss.seekg(0, std::ios::beg);
+  {
+    m_read_line = m_text.substr(m_text_pos, end - m_text_pos);
+    m_text_pos = end + 1;
+  }
+  return true;
+}
+
+inline void MPS_Reader::record_setup()
+{
+  m_record = m_read_line.substr(0, record_data_size(m_read_line));
+  m_field_pos = 0;
+}
+
+inline void MPS_Reader::skip_space(std::string_view p_record, size_t& p_pos)
+{
+  while (p_pos < p_record.size() &&
+         std::isspace(static_cast<unsigned char>(p_record[p_pos])))
+    ++p_pos;
+}
+
+inline bool MPS_Reader::scan_field(std::string_view p_record,
+                                   size_t& p_pos,
+                                   std::string_view& p_field)
+{
+  skip_space(p_record, p_pos);
+  const size_t begin = p_pos;
+  while (p_pos < p_record.size() &&
+         !std::isspace(static_cast<unsigned char>(p_record[p_pos])))
+    ++p_pos;
+  p_field = p_record.substr(begin, p_pos - begin);
+  return !p_field.empty();
+}
+
+inline bool MPS_Reader::next_field(std::string_view& p_field)
+{
+  return scan_field(m_record, m_field_pos, p_field);
+}
+
+inline bool MPS_Reader::next_field(std::string& p_field)
+{
+  std::string_view field;
+  if (!next_field(field))
+    return false;
+  p_field.assign(field);
+  return true;
+}
+
+inline bool MPS_Reader::next_char(char& p_char)
+{
+  skip_space(m_record, m_field_pos);
+  if (m_field_pos >= m_record.size())
+    return false;
+  p_char = m_record[m_field_pos++];
+  return true;
 }
 
-inline size_t
-MPS_Reader::record_data_size(const std::string& p_record) const
+inline size_t MPS_Reader::record_data_size(std::string_view p_record)
 {
   for (size_t idx = 1; idx < p_record.size(); ++idx)
   {
@@ -80,7 +218,7 @@ MPS_Reader::record_data_size(const std::string& p_record) const
   return p_record.size();
 }
 
-inline bool MPS_Reader::is_blank(const std::string& p_record) const
+inline bool MPS_Reader::is_blank(std::string_view p_record)
 {
   const size_t data_size = record_data_size(p_record);
   for (size_t idx = 0; idx < data_size; ++idx)
@@ -89,9 +227,10 @@ inline bool MPS_Reader::is_blank(const std::string& p_record) const
   return true;
 }
 
-inline void MPS_Reader::printf_error_line(const std::string& a) const
+inline void MPS_Reader::printf_error_line(std::string_view a) const
 {
-  std::string message = "c error line: " + a;
+  std::string message = "c error line: ";
+  message.append(a);
   printf("%s\n", message.c_str());
   throw Solver_Error(message);
 }
@@ -0,0 +1,83 @@
+/*=====================================================================================
+
+    Filename:     Mapped_File.cpp
+
+    Description:  Read-only memory mapping of a model file
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "Mapped_File.h"
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LOCAL_MIP_HAS_MMAP 1
+#endif
+
+Mapped_File::Mapped_File() : m_data(nullptr), m_size(0), m_is_mapped(false)
+{
+}
+
+Mapped_File::~Mapped_File()
+{
+  close();
+}
+
+bool Mapped_File::open(const char* p_path)
+{
+  close();
+#ifdef LOCAL_MIP_HAS_MMAP
+  const int fd = ::open(p_path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) &&
+      file_stat.st_size > 0)
+  {
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED)
+    {
+      ::madvise(addr, size, MADV_SEQUENTIAL);
+      ::close(fd);
+      m_data = static_cast<const char*>(addr);
+      m_size = size;
+      m_is_mapped = true;
+      return true;
+    }
+  }
+  ::close(fd);
+#endif
+  return read_into_buffer(p_path);
+}
+
+void Mapped_File::close()
+{
+#ifdef LOCAL_MIP_HAS_MMAP
+  if (m_is_mapped)
+    ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+  m_data = nullptr;
+  m_size = 0;
+  m_is_mapped = false;
+  m_buffer.clear();
+  m_buffer.shrink_to_fit();
+}
+
+bool Mapped_File::read_into_buffer(const char* p_path)
+{
+  std::ifstream infile(p_path, std::ios::binary);
+  if (!infile)
+    return false;
+  m_buffer.assign(std::istreambuf_iterator<char>(infile),
+                  std::istreambuf_iterator<char>());
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+  return true;
+}
@@ -0,0 +1,59 @@
+/*=====================================================================================
+
+    Filename:     Mapped_File.h
+
+    Description:  Read-only memory mapping of a model file
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Maps a whole file read-only so readers can tokenize it in place. When
+// mapping is unavailable (non-POSIX platform, empty file, special file)
+// the contents are read into an owned buffer instead, so callers always
+// see one contiguous view.
+class Mapped_File
+{
+public:
+  Mapped_File();
+
+  ~Mapped_File();
+
+  Mapped_File(const Mapped_File&) = delete;
+
+  Mapped_File& operator=(const Mapped_File&) = delete;
+
+  bool open(const char* p_path);
+
+  void close();
+
+  inline std::string_view text() const;
+
+  inline bool is_mapped() const;
+
+private:
+  const char* m_data;
+
+  size_t m_size;
+
+  bool m_is_mapped;
+
+  std::string m_buffer;
+
+  bool read_into_buffer(const char* p_path);
+};
+
+inline std::string_view Mapped_File::text() const
+{
+  return {m_data, m_size};
+}
+
+inline bool Mapped_File::is_mapped() const
+{
+  return m_is_mapped;
+}
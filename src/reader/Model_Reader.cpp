@@ -8,11 +8,13 @@
 =====================================================================================*/
 
 #include "../utils/solver_error.h"
+#include "Compressed_Input.h"
 #include "LP_Reader.h"
 #include "MPS_Reader.h"
 #include "Model_Reader.h"
 #include <cctype>
 #include <string>
+#include <string_view>
 
 void read_model_file(const std::string& p_model_file,
                      Model_Manager& p_model_manager)
@@ -20,9 +22,13 @@ void read_model_file(const std::string& p_model_file,
   if (p_model_file.empty())
     throw Solver_Error("model file path is empty");
 
-  const auto dot_pos = p_model_file.find_last_of('.');
-  std::string extension =
-      dot_pos == std::string::npos ? "" : p_model_file.substr(dot_pos + 1);
+  // "model.mps.gz" is dispatched on "mps"; the readers decompress it.
+  const std::string_view inner_file =
+      Compressed_Input::strip_extension(p_model_file);
+  const auto dot_pos = inner_file.find_last_of('.');
+  std::string extension(dot_pos == std::string_view::npos
+                            ? std::string_view()
+                            : inner_file.substr(dot_pos + 1));
   for (char& ch : extension)
     ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
 
@@ -0,0 +1,87 @@
+/*=====================================================================================
+
+    Filename:     Sol_Writer.cpp
+
+    Description:  Buffered .sol formatting and atomic solution file writes
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "Sol_Writer.h"
+#include "../model_data/Model_Var.h"
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+constexpr size_t k_name_width = 50;
+
+constexpr const char* k_column_gap = "        ";
+
+void append_padded(std::string& p_buffer, const std::string& p_text)
+{
+  p_buffer += p_text;
+  if (p_text.size() < k_name_width)
+    p_buffer.append(k_name_width - p_text.size(), ' ');
+  p_buffer += k_column_gap;
+}
+
+} // namespace
+
+void Sol_Writer::format(const Model_Manager& p_model_manager,
+                        const std::vector<double>& p_values,
+                        std::string& p_buffer)
+{
+  p_buffer.clear();
+  append_padded(p_buffer, "Variable name");
+  p_buffer += "Variable value\n";
+  char number[64];
+  for (size_t var_idx = 0; var_idx < p_values.size(); ++var_idx)
+  {
+    if (!p_values[var_idx])
+      continue;
+    append_padded(p_buffer, p_model_manager.var(var_idx).name());
+    // Same digits as printf("%.17g").
+    const auto result =
+        std::to_chars(number,
+                      number + sizeof(number),
+                      p_values[var_idx],
+                      std::chars_format::general,
+                      std::numeric_limits<double>::max_digits10);
+    p_buffer.append(number, result.ptr);
+    p_buffer += '\n';
+  }
+}
+
+bool Sol_Writer::write_atomically(const std::string& p_path,
+                                  const std::string& p_content)
+{
+  const std::string temp_path = p_path + ".tmp";
+  FILE* file = fopen(temp_path.c_str(), "wb");
+  if (file == nullptr)
+    return false;
+  bool ok =
+      fwrite(p_content.data(), 1, p_content.size(), file) == p_content.size();
+  ok = fflush(file) == 0 && ok;
+#if defined(__unix__) || defined(__APPLE__)
+  ok = ok && fsync(fileno(file)) == 0;
+#endif
+  ok = fclose(file) == 0 && ok;
+  std::error_code error;
+  if (ok)
+    std::filesystem::rename(temp_path, p_path, error);
+  if (!ok || error)
+  {
+    std::filesystem::remove(temp_path, error);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,30 @@
+/*=====================================================================================
+
+    Filename:     Sol_Writer.h
+
+    Description:  Buffered .sol formatting and atomic solution file writes
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include "../model_data/Model_Manager.h"
+#include <string>
+#include <vector>
+
+class Sol_Writer
+{
+public:
+  // Replaces p_buffer with the .sol text of p_values, in the layout
+  // Sol_Reader reads: a header line, then name and value of every nonzero
+  // variable. Values are printed with max_digits10 significant digits.
+  static void format(const Model_Manager& p_model_manager,
+                     const std::vector<double>& p_values,
+                     std::string& p_buffer);
+
+  // Writes p_content to p_path.tmp and renames it over p_path, so readers
+  // see either the previous file or the new one, never a partial write.
+  static bool write_atomically(const std::string& p_path,
+                               const std::string& p_content);
+};
@@ -0,0 +1,693 @@
+/*=====================================================================================
+
+    Filename:     bench_main.cpp
+
+    Description:  Benchmark harness running Local-MIP over instance sets
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "../local_mip/Local_MIP.h"
+#include "../model_data/Prepared_Model.h"
+#include "../reader/Compressed_Input.h"
+#include "cmdline.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define LOCAL_MIP_BENCH_FORK
+#endif
+
+namespace
+{
+
+constexpr double k_nan = std::numeric_limits<double>::quiet_NaN();
+
+struct Bench_Job
+{
+  std::string instance;
+
+  uint32_t seed;
+
+  double time_limit;
+};
+
+struct Bench_Record
+{
+  // feasible, no_solution or error.
+  std::string status = "error";
+
+  std::string error;
+
+  int is_min = 1;
+
+  double read_seconds = 0.0;
+
+  double presolve_seconds = 0.0;
+
+  double search_seconds = 0.0;
+
+  double first_feasible_seconds = k_nan;
+
+  double final_obj = k_nan;
+
+  double primal_integral = k_nan;
+
+  size_t step_num = 0;
+
+  long peak_rss_kb = -1;
+
+  // (seconds, objective) at every improvement.
+  std::vector<std::pair<double, double>> trajectory;
+};
+
+struct Bench_Options
+{
+  std::string param_set_file;
+
+  bool verbose = false;
+};
+
+double seconds_since(std::chrono::steady_clock::time_point p_start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       p_start)
+      .count();
+}
+
+Bench_Record run_job(const Bench_Job& p_job, const Bench_Options& p_options)
+{
+  Bench_Record record;
+  try
+  {
+    auto prepared = Prepared_Model::from_file(p_job.instance);
+    record.read_seconds = prepared->timing().read_seconds;
+    record.presolve_seconds = prepared->timing().presolve_seconds;
+    record.is_min = prepared->model_manager().is_min();
+    Local_MIP solver(prepared);
+    if (!p_options.param_set_file.empty())
+      solver.set_param_set_file(p_options.param_set_file);
+    solver.set_random_seed(p_job.seed);
+    solver.set_time_limit(p_job.time_limit);
+    solver.set_log_obj(false);
+
+    const auto start = std::chrono::steady_clock::now();
+    solver.run();
+    record.search_seconds = seconds_since(start);
+    record.step_num = solver.get_step_num();
+    if (!solver.is_feasible())
+    {
+      record.status = "no_solution";
+      return record;
+    }
+    record.status = "feasible";
+    record.final_obj = solver.get_obj_value();
+    for (const auto& point : solver.get_trajectory().points())
+      record.trajectory.emplace_back(point.m_seconds, point.m_obj);
+    if (record.trajectory.empty() ||
+        record.trajectory.back().second != record.final_obj)
+      record.trajectory.emplace_back(record.search_seconds, record.final_obj);
+    record.first_feasible_seconds = record.trajectory.front().first;
+  }
+  catch (const std::exception& error)
+  {
+    record.status = "error";
+    record.error = error.what();
+  }
+  return record;
+}
+
+#ifdef LOCAL_MIP_BENCH_FORK
+
+std::string serialize(const Bench_Record& p_record)
+{
+  std::ostringstream out;
+  out.precision(17);
+  out << "status " << p_record.status << "\n"
+      << "is_min " << p_record.is_min << "\n"
+      << "read " << p_record.read_seconds << "\n"
+      << "presolve " << p_record.presolve_seconds << "\n"
+      << "search " << p_record.search_seconds << "\n"
+      << "first " << p_record.first_feasible_seconds << "\n"
+      << "obj " << p_record.final_obj << "\n"
+      << "steps " << p_record.step_num << "\n";
+  for (const auto& [seconds, obj] : p_record.trajectory)
+    out << "point " << seconds << " " << obj << "\n";
+  if (!p_record.error.empty())
+  {
+    std::string error = p_record.error;
+    std::replace(error.begin(), error.end(), '\n', ' ');
+    out << "error " << error << "\n";
+  }
+  return out.str();
+}
+
+double parse_double(std::istringstream& p_in)
+{
+  std::string token;
+  p_in >> token;
+  return token == "nan" ? k_nan : std::strtod(token.c_str(), nullptr);
+}
+
+Bench_Record deserialize(const std::string& p_text)
+{
+  Bench_Record record;
+  std::istringstream lines(p_text);
+  std::string line;
+  while (std::getline(lines, line))
+  {
+    std::istringstream in(line);
+    std::string key;
+    in >> key;
+    if (key == "status")
+      in >> record.status;
+    else if (key == "is_min")
+      in >> record.is_min;
+    else if (key == "read")
+      record.read_seconds = parse_double(in);
+    else if (key == "presolve")
+      record.presolve_seconds = parse_double(in);
+    else if (key == "search")
+      record.search_seconds = parse_double(in);
+    else if (key == "first")
+      record.first_feasible_seconds = parse_double(in);
+    else if (key == "obj")
+      record.final_obj = parse_double(in);
+    else if (key == "steps")
+      in >> record.step_num;
+    else if (key == "point")
+    {
+      const double seconds = parse_double(in);
+      record.trajectory.emplace_back(seconds, parse_double(in));
+    }
+    else if (key == "error")
+      record.error = line.substr(std::min(line.size(), size_t(6)));
+  }
+  return record;
+}
+
+// Each run is a child process, so a crash stays confined to its record and
+// the peak RSS reported by wait4 belongs to that run alone.
+std::vector<Bench_Record> run_jobs(const std::vector<Bench_Job>& p_jobs,
+                                   size_t p_job_num,
+                                   const Bench_Options& p_options,
+                                   void (*p_report)(const Bench_Job&,
+                                                    const Bench_Record&))
+{
+  struct Running
+  {
+    pid_t pid;
+    int fd;
+    size_t job_idx;
+    std::string output;
+  };
+  std::vector<Bench_Record> records(p_jobs.size());
+  std::vector<Running> running;
+  size_t next_job = 0;
+  while (next_job < p_jobs.size() || !running.empty())
+  {
+    while (next_job < p_jobs.size() && running.size() < p_job_num)
+    {
+      int fds[2];
+      if (pipe(fds) != 0)
+        throw std::runtime_error("cannot create a pipe for a benchmark run");
+      std::fflush(stdout);
+      const pid_t pid = fork();
+      if (pid < 0)
+        throw std::runtime_error("cannot fork a benchmark run");
+      if (pid == 0)
+      {
+        close(fds[0]);
+        if (!p_options.verbose)
+        {
+          const int null_fd = open("/dev/null", O_WRONLY);
+          if (null_fd >= 0)
+            dup2(null_fd, STDOUT_FILENO);
+        }
+        const std::string text =
+            serialize(run_job(p_jobs[next_job], p_options));
+        std::fflush(stdout);
+        size_t written = 0;
+        while (written < text.size())
+        {
+          const ssize_t size =
+              write(fds[1], text.data() + written, text.size() - written);
+          if (size <= 0)
+            break;
+          written += static_cast<size_t>(size);
+        }
+        _exit(0);
+      }
+      close(fds[1]);
+      running.push_back({pid, fds[0], next_job, ""});
+      ++next_job;
+    }
+
+    std::vector<pollfd> poll_fds;
+    for (const auto& run : running)
+      poll_fds.push_back({run.fd, POLLIN, 0});
+    if (poll(poll_fds.data(), poll_fds.size(), -1) < 0)
+      continue;
+    for (size_t run_idx = running.size(); run_idx-- > 0;)
+    {
+      if (poll_fds[run_idx].revents == 0)
+        continue;
+      Running& run = running[run_idx];
+      char buffer[4096];
+      const ssize_t size = read(run.fd, buffer, sizeof(buffer));
+      if (size > 0)
+      {
+        run.output.append(buffer, static_cast<size_t>(size));
+        continue;
+      }
+      close(run.fd);
+      int status = 0;
+      rusage usage{};
+      wait4(run.pid, &status, 0, &usage);
+      Bench_Record record = deserialize(run.output);
+      if (run.output.empty())
+      {
+        record.status = "error";
+        record.error = WIFSIGNALED(status)
+                           ? "terminated by signal " +
+                                 std::to_string(WTERMSIG(status))
+                           : "exited without a result";
+      }
+#ifdef __APPLE__
+      record.peak_rss_kb = static_cast<long>(usage.ru_maxrss / 1024);
+#else
+      record.peak_rss_kb = static_cast<long>(usage.ru_maxrss);
+#endif
+      p_report(p_jobs[run.job_idx], record);
+      records[run.job_idx] = std::move(record);
+      running.erase(running.begin() + static_cast<std::ptrdiff_t>(run_idx));
+    }
+  }
+  return records;
+}
+
+#else
+
+// Without fork the runs share one process: they run one after another and
+// no per-run peak RSS is available.
+std::vector<Bench_Record> run_jobs(const std::vector<Bench_Job>& p_jobs,
+                                   size_t p_job_num,
+                                   const Bench_Options& p_options,
+                                   void (*p_report)(const Bench_Job&,
+                                                    const Bench_Record&))
+{
+  (void)p_job_num;
+  std::vector<Bench_Record> records;
+  for (const auto& job : p_jobs)
+  {
+    records.push_back(run_job(job, p_options));
+    p_report(job, records.back());
+  }
+  return records;
+}
+
+#endif
+
+void report(const Bench_Job& p_job, const Bench_Record& p_record)
+{
+  printf("c %s seed %u limit %.2fs: %s",
+         p_job.instance.c_str(),
+         p_job.seed,
+         p_job.time_limit,
+         p_record.status.c_str());
+  if (p_record.status == "feasible")
+    printf(" obj %.17g", p_record.final_obj);
+  if (!p_record.error.empty())
+    printf(" (%s)", p_record.error.c_str());
+  printf("\n");
+}
+
+bool is_model_file(const std::filesystem::path& p_path)
+{
+  const std::string path = p_path.string();
+  std::string extension =
+      std::filesystem::path(
+          std::string(Compressed_Input::strip_extension(path)))
+          .extension()
+          .string();
+  std::transform(extension.begin(),
+                 extension.end(),
+                 extension.begin(),
+                 [](unsigned char ch)
+                 { return static_cast<char>(std::tolower(ch)); });
+  return extension == ".mps" || extension == ".lp";
+}
+
+// Directories contribute their model files in name order.
+void add_instance(const std::string& p_path,
+                  std::vector<std::string>& p_instances)
+{
+  if (!std::filesystem::is_directory(p_path))
+  {
+    p_instances.push_back(p_path);
+    return;
+  }
+  std::vector<std::string> files;
+  for (const auto& entry : std::filesystem::directory_iterator(p_path))
+    if (entry.is_regular_file() && is_model_file(entry.path()))
+      files.push_back(entry.path().string());
+  std::sort(files.begin(), files.end());
+  p_instances.insert(p_instances.end(), files.begin(), files.end());
+}
+
+std::vector<std::string> read_lines(const std::string& p_file)
+{
+  std::ifstream in(p_file);
+  if (!in)
+    throw std::runtime_error("cannot open " + p_file);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(in, line))
+  {
+    const size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos || line[begin] == '#')
+      continue;
+    const size_t end = line.find_last_not_of(" \t\r");
+    lines.push_back(line.substr(begin, end - begin + 1));
+  }
+  return lines;
+}
+
+std::vector<double> parse_time_limits(const std::string& p_text)
+{
+  std::vector<double> time_limits;
+  std::istringstream in(p_text);
+  std::string token;
+  while (std::getline(in, token, ','))
+  {
+    char* end = nullptr;
+    const double value = std::strtod(token.c_str(), &end);
+    if (end == token.c_str() || *end != '\0' || !(value > 0.0))
+      throw std::invalid_argument("invalid time limit: " + token);
+    time_limits.push_back(value);
+  }
+  if (time_limits.empty())
+    throw std::invalid_argument("no time limit given");
+  return time_limits;
+}
+
+double primal_integral(const Bench_Record& p_record, double p_reference)
+{
+  double integral = 0.0;
+  double last_seconds = 0.0;
+  double last_gap = 1.0;
+  for (const auto& [seconds, obj] : p_record.trajectory)
+  {
+    integral += last_gap * (seconds - last_seconds);
+    last_seconds = seconds;
+    last_gap = Primal_Trajectory::primal_gap(obj, p_reference);
+  }
+  return integral +
+         last_gap * std::max(0.0, p_record.search_seconds - last_seconds);
+}
+
+// References come from the --reference file ("instance objective" per
+// line, matched on the path as given or on the file name), otherwise from
+// the best objective any run found for the instance.
+void compute_integrals(const std::vector<Bench_Job>& p_jobs,
+                       std::vector<Bench_Record>& p_records,
+                       const std::string& p_reference_file)
+{
+  std::map<std::string, double> references;
+  if (!p_reference_file.empty())
+    for (const auto& line : read_lines(p_reference_file))
+    {
+      std::istringstream in(line);
+      std::string name;
+      double obj = k_nan;
+      if (in >> name >> obj)
+        references[name] = obj;
+    }
+  std::map<std::string, double> best_found;
+  for (size_t job_idx = 0; job_idx < p_jobs.size(); ++job_idx)
+  {
+    const Bench_Record& record = p_records[job_idx];
+    if (record.status != "feasible")
+      continue;
+    auto [best, inserted] =
+        best_found.emplace(p_jobs[job_idx].instance, record.final_obj);
+    if (!inserted && record.is_min * (record.final_obj - best->second) < 0)
+      best->second = record.final_obj;
+  }
+  for (size_t job_idx = 0; job_idx < p_jobs.size(); ++job_idx)
+  {
+    const std::string& instance = p_jobs[job_idx].instance;
+    double reference = k_nan;
+    auto given = references.find(instance);
+    if (given == references.end())
+      given = references.find(
+          std::filesystem::path(instance).filename().string());
+    if (given != references.end())
+      reference = given->second;
+    else if (best_found.count(instance) > 0)
+      reference = best_found[instance];
+    Bench_Record& record = p_records[job_idx];
+    if (record.status != "error")
+      record.primal_integral = primal_integral(record, reference);
+  }
+}
+
+// Objectives keep full precision; times and rates do not need it.
+std::string format_number(double p_value, int p_precision = 6)
+{
+  if (std::isnan(p_value))
+    return "";
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.*g", p_precision, p_value);
+  return buffer;
+}
+
+double steps_per_second(const Bench_Record& p_record)
+{
+  if (p_record.status == "error" || p_record.search_seconds <= 0.0)
+    return k_nan;
+  return static_cast<double>(p_record.step_num) / p_record.search_seconds;
+}
+
+std::string csv_field(const std::string& p_text)
+{
+  if (p_text.find_first_of(",\"\n") == std::string::npos)
+    return p_text;
+  std::string quoted = "\"";
+  for (char ch : p_text)
+  {
+    if (ch == '"')
+      quoted += '"';
+    quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+std::string json_string(const std::string& p_text)
+{
+  std::string quoted = "\"";
+  for (char ch : p_text)
+  {
+    if (ch == '"' || ch == '\\')
+    {
+      quoted += '\\';
+      quoted += ch;
+    }
+    else if (static_cast<unsigned char>(ch) < 0x20)
+    {
+      char buffer[8];
+      std::snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+      quoted += buffer;
+    }
+    else
+      quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+std::string json_number(double p_value, int p_precision = 6)
+{
+  return std::isnan(p_value) ? "null" : format_number(p_value, p_precision);
+}
+
+void write_csv(std::ostream& p_out,
+               const std::vector<Bench_Job>& p_jobs,
+               const std::vector<Bench_Record>& p_records)
+{
+  p_out << "instance,seed,time_limit,status,read_seconds,presolve_seconds,"
+           "first_feasible_seconds,primal_integral,final_objective,steps,"
+           "steps_per_second,peak_rss_kb\n";
+  for (size_t job_idx = 0; job_idx < p_jobs.size(); ++job_idx)
+  {
+    const Bench_Job& job = p_jobs[job_idx];
+    const Bench_Record& record = p_records[job_idx];
+    p_out << csv_field(job.instance) << "," << job.seed << ","
+          << format_number(job.time_limit) << "," << record.status << ","
+          << format_number(record.read_seconds) << ","
+          << format_number(record.presolve_seconds) << ","
+          << format_number(record.first_feasible_seconds) << ","
+          << format_number(record.primal_integral) << ","
+          << format_number(record.final_obj, 17) << "," << record.step_num
+          << "," << format_number(steps_per_second(record)) << ",";
+    if (record.peak_rss_kb >= 0)
+      p_out << record.peak_rss_kb;
+    p_out << "\n";
+  }
+}
+
+void write_json(std::ostream& p_out,
+                const std::vector<Bench_Job>& p_jobs,
+                const std::vector<Bench_Record>& p_records)
+{
+  p_out << "{\n  \"runs\": [";
+  for (size_t job_idx = 0; job_idx < p_jobs.size(); ++job_idx)
+  {
+    const Bench_Job& job = p_jobs[job_idx];
+    const Bench_Record& record = p_records[job_idx];
+    p_out << (job_idx == 0 ? "\n" : ",\n") << "    {\"instance\": "
+          << json_string(job.instance) << ", \"seed\": " << job.seed
+          << ", \"time_limit\": " << json_number(job.time_limit)
+          << ", \"status\": " << json_string(record.status)
+          << ", \"read_seconds\": " << json_number(record.read_seconds)
+          << ", \"presolve_seconds\": "
+          << json_number(record.presolve_seconds)
+          << ", \"first_feasible_seconds\": "
+          << json_number(record.first_feasible_seconds)
+          << ", \"primal_integral\": " << json_number(record.primal_integral)
+          << ", \"final_objective\": " << json_number(record.final_obj, 17)
+          << ", \"steps\": " << record.step_num
+          << ", \"steps_per_second\": "
+          << json_number(steps_per_second(record)) << ", \"peak_rss_kb\": ";
+    if (record.peak_rss_kb >= 0)
+      p_out << record.peak_rss_kb;
+    else
+      p_out << "null";
+    if (!record.error.empty())
+      p_out << ", \"error\": " << json_string(record.error);
+    p_out << "}";
+  }
+  p_out << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  cmdline::parser parser;
+  parser.add<std::string>(
+      "list", 'l', "File with one instance path per line", false, "");
+  parser.add<int>("seeds", 's', "Runs per instance, seeds 1..N", false, 1);
+  parser.add<std::string>("time_limits",
+                          't',
+                          "Comma-separated time limits in seconds",
+                          false,
+                          "10");
+  parser.add<int>("jobs", 'j', "Runs executed in parallel", false, 1);
+  parser.add<std::string>("csv", 'c', "CSV output file", false, "");
+  parser.add<std::string>("json", 'J', "JSON output file", false, "");
+  parser.add<std::string>(
+      "param_set_file", 'p', "Parameter file applied to every run", false, "");
+  parser.add<std::string>("reference",
+                          'r',
+                          "File of \"instance objective\" lines for the "
+                          "primal integral",
+                          false,
+                          "");
+  parser.add("verbose", 'v', "Keep the solver log of every run");
+  parser.footer("instance-file-or-directory ...");
+  parser.parse_check(argc, argv);
+
+  try
+  {
+    std::vector<std::string> instances;
+    if (!parser.get<std::string>("list").empty())
+      for (const auto& path : read_lines(parser.get<std::string>("list")))
+        add_instance(path, instances);
+    for (const auto& path : parser.rest())
+      add_instance(path, instances);
+    if (instances.empty())
+    {
+      fprintf(stderr, "%s", parser.usage().c_str());
+      return 1;
+    }
+    const int seed_num = parser.get<int>("seeds");
+    const int job_num = parser.get<int>("jobs");
+    if (seed_num < 1 || job_num < 1)
+      throw std::invalid_argument("seeds and jobs must be positive");
+    const std::vector<double> time_limits =
+        parse_time_limits(parser.get<std::string>("time_limits"));
+
+    std::vector<Bench_Job> jobs;
+    for (const auto& instance : instances)
+      for (double time_limit : time_limits)
+        for (int seed = 1; seed <= seed_num; ++seed)
+          jobs.push_back({instance, static_cast<uint32_t>(seed), time_limit});
+    Bench_Options options;
+    options.param_set_file = parser.get<std::string>("param_set_file");
+    options.verbose = parser.exist("verbose");
+    printf("c benchmark: %zu instances, %zu runs, %d in parallel\n",
+           instances.size(),
+           jobs.size(),
+           job_num);
+
+    std::vector<Bench_Record> records =
+        run_jobs(jobs, static_cast<size_t>(job_num), options, report);
+    compute_integrals(jobs, records, parser.get<std::string>("reference"));
+
+    const std::string csv_file = parser.get<std::string>("csv");
+    const std::string json_file = parser.get<std::string>("json");
+    if (!csv_file.empty())
+    {
+      std::ofstream out(csv_file);
+      write_csv(out, jobs, records);
+      if (!out)
+        throw std::runtime_error("cannot write " + csv_file);
+    }
+    if (!json_file.empty())
+    {
+      std::ofstream out(json_file);
+      write_json(out, jobs, records);
+      if (!out)
+        throw std::runtime_error("cannot write " + json_file);
+    }
+    if (csv_file.empty() && json_file.empty())
+    {
+      std::ostringstream out;
+      write_csv(out, jobs, records);
+      printf("%s", out.str().c_str());
+    }
+    for (const auto& record : records)
+      if (record.status == "error")
+        return 1;
+    return 0;
+  }
+  catch (const std::exception& error)
+  {
+    fprintf(stderr, "c benchmark failed: %s\n", error.what());
+    return 1;
+  }
+}
@@ -15,6 +15,8 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 
 #ifdef DEBUG
@@ -25,6 +27,17 @@
 #define DEBUG_CALL(...)
 #endif
 
+// Width of stored variable/constraint indices (term lists, CSR/CSC matrix,
+// unsat/sat bookkeeping). Build with LOCAL_MIP_INDEX_32 to halve index
+// bandwidth on models with fewer than 2^32 - 1 rows and columns.
+#ifdef LOCAL_MIP_INDEX_32
+using Model_Idx = uint32_t;
+#else
+using Model_Idx = size_t;
+#endif
+
+inline constexpr Model_Idx k_null_idx = std::numeric_limits<Model_Idx>::max();
+
 const double k_inf = 1e20;
 
 const double k_neg_inf = -k_inf;
@@ -56,7 +56,12 @@ int main(int argc, char* argv[])
     int log_obj = OPT(log_obj);
     int restart_step = OPT(restart_step);
     std::string sol_path = OPT(sol_path);
+    double sol_interval = OPT(sol_interval);
     std::string start_sol_path = OPT(start_sol_path);
+    std::string trajectory_path = OPT(trajectory_path);
+    std::string checkpoint_path = OPT(checkpoint_path);
+    std::string resume_path = OPT(resume_path);
+    int step_limit = OPT(step_limit);
     std::string start = OPT(start);
     std::string restart = OPT(restart);
     std::string weight = OPT(weight);
@@ -77,8 +82,17 @@ int main(int argc, char* argv[])
     int tabu_base = OPT(tabu_base);
     int tabu_variation = OPT(tabu_var);
     int activity_period = OPT(activity_period);
+    std::string activity_arithmetic = OPT(activity_arithmetic);
+    int score_cache = OPT(score_cache);
+    int score_threads = OPT(score_threads);
+    int threads = OPT(threads);
+    double obj_cutoff = OPT(obj_cutoff);
+    double obj_reference = OPT(obj_reference);
+    int incumbent_sync = OPT(incumbent_sync);
     int break_eq_feas = OPT(break_eq_feas);
     int split_eq = OPT(split_eq);
+    int presolve_threads = OPT(presolve_threads);
+    int dup_presolve = OPT(dup_presolve);
     solver = std::make_unique<Local_MIP>();
     g_solver.store(solver.get(), std::memory_order_release);
     solver->set_model_file(model_file);
@@ -128,16 +142,44 @@ int main(int argc, char* argv[])
       solver->set_tabu_base(static_cast<size_t>(tabu_base));
     if (activity_period != 100000)
       solver->set_activity_period(static_cast<size_t>(activity_period));
+    if (activity_arithmetic != "long_double")
+      solver->set_activity_arithmetic(activity_arithmetic);
+    if (score_cache != 0)
+      solver->set_score_cache(true);
+    if (score_threads != 1)
+      solver->set_score_threads(static_cast<size_t>(score_threads));
+    if (threads != 1)
+      solver->set_threads(static_cast<size_t>(threads));
+    if (obj_cutoff != k_inf)
+      solver->set_objective_cutoff(obj_cutoff);
+    if (obj_reference != k_inf)
+      solver->set_obj_reference(obj_reference);
+    if (incumbent_sync != 100)
+      solver->set_incumbent_sync_period(static_cast<size_t>(incumbent_sync));
     if (tabu_variation != 7)
       solver->set_tabu_variation(static_cast<size_t>(tabu_variation));
     if (break_eq_feas != 0)
       solver->set_break_eq_feas(true);
-    if (split_eq != 1)
-      solver->set_split_eq(false);
+    if (split_eq != 0)
+      solver->set_split_eq(true);
+    if (presolve_threads != 0)
+      solver->set_presolve_threads(static_cast<size_t>(presolve_threads));
+    if (dup_presolve != 1)
+      solver->set_dup_presolve(false);
     if (!sol_path.empty())
       solver->set_sol_path(sol_path);
+    if (sol_interval != 1.0)
+      solver->set_sol_interval(sol_interval);
     if (!start_sol_path.empty())
       solver->set_start_sol_path(start_sol_path);
+    if (!trajectory_path.empty())
+      solver->set_trajectory_path(trajectory_path);
+    if (!checkpoint_path.empty())
+      solver->set_checkpoint_path(checkpoint_path);
+    if (!resume_path.empty())
+      solver->set_resume_path(resume_path);
+    if (step_limit != 0)
+      solver->set_step_limit(static_cast<size_t>(step_limit));
     solver->run();
     g_solver.store(nullptr, std::memory_order_release);
     return 0;
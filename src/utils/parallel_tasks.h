@@ -0,0 +1,81 @@
+/*=====================================================================================
+
+    Filename:     parallel_tasks.h
+
+    Description:  Fork-join helpers for data-parallel model passes
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Runs p_task(0), ..., p_task(p_task_num - 1) on one thread each, the
+// calling thread taking task 0. The first exception is rethrown after all
+// tasks have joined.
+template <typename Task>
+void run_tasks(size_t p_task_num, const Task& p_task)
+{
+  std::vector<std::exception_ptr> errors(p_task_num);
+  auto guarded_task = [&](size_t p_task_idx)
+  {
+    try
+    {
+      p_task(p_task_idx);
+    }
+    catch (...)
+    {
+      errors[p_task_idx] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(p_task_num - 1);
+  for (size_t task_idx = 1; task_idx < p_task_num; ++task_idx)
+    threads.emplace_back(guarded_task, task_idx);
+  guarded_task(0);
+  for (auto& thread : threads)
+    thread.join();
+  for (const auto& error : errors)
+    if (error)
+      std::rethrow_exception(error);
+}
+
+inline size_t slice_begin(size_t p_total, size_t p_part, size_t p_part_num)
+{
+  return p_total * p_part / p_part_num;
+}
+
+// 0 selects std::thread::hardware_concurrency().
+inline size_t resolve_worker_num(size_t p_worker_num)
+{
+  if (p_worker_num != 0)
+    return p_worker_num;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Splits [0, p_total) into p_part_num contiguous slices and calls
+// p_body(part, begin, end) for each on its own thread. Slices depend only
+// on p_total and p_part_num, so per-slice results merged in part order are
+// the same for every worker count.
+template <typename Body>
+void run_slices(size_t p_total, size_t p_part_num, const Body& p_body)
+{
+  p_part_num = std::max<size_t>(1, std::min(p_part_num, p_total));
+  if (p_part_num == 1)
+  {
+    p_body(size_t(0), size_t(0), p_total);
+    return;
+  }
+  run_tasks(p_part_num,
+            [&](size_t p_part)
+            {
+              p_body(p_part,
+                     slice_begin(p_total, p_part, p_part_num),
+                     slice_begin(p_total, p_part + 1, p_part_num));
+            });
+}
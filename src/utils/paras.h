@@ -37,6 +37,14 @@
        0,                                                                 \
        2147483647,                                                        \
        "Random seed for local search (0 to use default)")                 \
+  PARA(step_limit,                                                        \
+       int,                                                               \
+       'V',                                                               \
+       false,                                                             \
+       0,                                                                 \
+       0,                                                                 \
+       2147483647,                                                        \
+       "Total search steps over resumed runs (0 disables)")               \
   PARA(feas_tolerance,                                                    \
        double,                                                            \
        'F',                                                               \
@@ -159,6 +167,62 @@
         1,                                                                 \
         100000000,                                                         \
         "Constraint activity recompute period")                            \
+  PARA(score_cache,                                                       \
+       int,                                                               \
+       'C',                                                               \
+       false,                                                             \
+       0,                                                                 \
+       0,                                                                 \
+       1,                                                                 \
+       "Cache constraint progress scores between moves or not")           \
+  PARA(score_threads,                                                     \
+       int,                                                               \
+       'G',                                                               \
+       false,                                                             \
+       1,                                                                 \
+       0,                                                                 \
+       1024,                                                              \
+       "Neighbor scoring threads (0 uses all hardware threads)")          \
+  PARA(threads,                                                           \
+       int,                                                               \
+       'T',                                                               \
+       false,                                                             \
+       1,                                                                 \
+       1,                                                                 \
+       1024,                                                              \
+       "Portfolio worker threads sharing the best solution")              \
+  PARA(obj_cutoff,                                                        \
+       double,                                                            \
+       'U',                                                               \
+       false,                                                             \
+       k_inf,                                                             \
+       k_neg_inf,                                                         \
+       k_inf,                                                             \
+       "Stop once this objective is reached (1e20 disables)")             \
+  PARA(obj_reference,                                                     \
+       double,                                                            \
+       'R',                                                               \
+       false,                                                             \
+       k_inf,                                                             \
+       k_neg_inf,                                                         \
+       k_inf,                                                             \
+       "Reference objective of the primal integral (1e20 uses the best)") \
+  PARA(sol_interval,                                                      \
+       double,                                                            \
+       'W',                                                               \
+       false,                                                             \
+       1.0,                                                               \
+       0,                                                                 \
+       k_max_time_limit,                                                  \
+       "Seconds between incremental .sol dumps (0 disables)")             \
+  PARA(incumbent_sync,                                                    \
+       int,                                                               \
+       'K',                                                               \
+       false,                                                             \
+       100,                                                               \
+       1,                                                                 \
+       100000000,                                                         \
+       "Steps between reads of the shared incumbent objective")           \
   PARA(break_eq_feas,                                                     \
        int,                                                               \
        'z',                                                               \
@@ -171,21 +235,52 @@
        int,                                                               \
        'j',                                                               \
        false,                                                             \
+       0,                                                                 \
+       0,                                                                 \
+       1,                                                                 \
+       "Split equalities into two inequalities")                          \
+  PARA(presolve_threads,                                                  \
+       int,                                                               \
+       'P',                                                               \
+       false,                                                             \
+       0,                                                                 \
+       0,                                                                 \
+       1024,                                                              \
+       "Presolve threads (0 uses all hardware threads)")                  \
+  PARA(dup_presolve,                                                      \
+       int,                                                               \
+       'D',                                                               \
+       false,                                                             \
        1,                                                                 \
        0,                                                                 \
        1,                                                                 \
-       "Split equalities into two inequalities")
+       "Drop parallel rows and merge duplicate columns")
 
 
 //            name,   short-name, must-need, default, comments
 #define STR_PARAS                                                         \
   STR_PARA(model_file, 'i', true, "", ".mps/.lp format model file path")  \
   STR_PARA(sol_path, 's', false, "", ".sol format solution path")         \
+  STR_PARA(trajectory_path,                                               \
+           'J',                                                           \
+           false,                                                         \
+           "",                                                            \
+           "JSON file for the incumbent trajectory")                      \
   STR_PARA(start_sol_path,                                                \
            'k',                                                           \
            false,                                                         \
            "",                                                            \
            ".sol format start solution path")                             \
+  STR_PARA(checkpoint_path,                                               \
+           'X',                                                           \
+           false,                                                         \
+           "",                                                            \
+           "search state file written when the run ends")                 \
+  STR_PARA(resume_path,                                                   \
+           'Q',                                                           \
+           false,                                                         \
+           "",                                                            \
+           "search state file to resume from")                            \
   STR_PARA(start,                                                         \
            'm',                                                           \
            false,                                                         \
@@ -208,6 +303,11 @@
            false,                                                         \
            "progress_bonus",                                              \
            "infeas scoring: progress_bonus/progress_age")                 \
+  STR_PARA(activity_arithmetic,                                           \
+           'A',                                                           \
+           false,                                                         \
+           "long_double",                                                 \
+           "uncertified activities: long_double/compensated")             \
   STR_PARA(param_set_file,                                                \
            'c',                                                           \
            false,                                                         \
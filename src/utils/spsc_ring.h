@@ -0,0 +1,106 @@
+/*=====================================================================================
+
+    Filename:     spsc_ring.h
+
+    Description:  Bounded lock-free single-producer single-consumer queue
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// One thread pushes, one other thread pops. The producer never waits: a
+// push into a full ring is dropped and counted. Head and tail live on their
+// own cache lines, and each side keeps a cached copy of the other side's
+// index so the shared lines are only touched when the cached view runs out.
+template <typename T>
+class Spsc_Ring
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+  // The capacity is rounded up to a power of two.
+  explicit Spsc_Ring(size_t p_capacity);
+
+  Spsc_Ring(const Spsc_Ring&) = delete;
+
+  Spsc_Ring& operator=(const Spsc_Ring&) = delete;
+
+  inline bool push(const T& p_value) noexcept;
+
+  inline bool pop(T& p_value) noexcept;
+
+  inline size_t dropped() const noexcept;
+
+private:
+  static constexpr size_t k_cache_line = 64;
+
+  std::vector<T> m_slots;
+
+  size_t m_mask;
+
+  // Next slot to pop; written by the consumer.
+  alignas(k_cache_line) std::atomic<size_t> m_head;
+
+  size_t m_cached_tail;
+
+  // Next slot to push; written by the producer.
+  alignas(k_cache_line) std::atomic<size_t> m_tail;
+
+  size_t m_cached_head;
+
+  std::atomic<size_t> m_dropped;
+};
+
+template <typename T>
+Spsc_Ring<T>::Spsc_Ring(size_t p_capacity)
+    : m_slots(std::bit_ceil(p_capacity < 2 ? size_t(2) : p_capacity)),
+      m_mask(m_slots.size() - 1), m_head(0), m_cached_tail(0), m_tail(0),
+      m_cached_head(0), m_dropped(0)
+{
+}
+
+template <typename T>
+inline bool Spsc_Ring<T>::push(const T& p_value) noexcept
+{
+  const size_t tail = m_tail.load(std::memory_order_relaxed);
+  if (tail - m_cached_head == m_slots.size())
+  {
+    m_cached_head = m_head.load(std::memory_order_acquire);
+    if (tail - m_cached_head == m_slots.size())
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  m_slots[tail & m_mask] = p_value;
+  m_tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+inline bool Spsc_Ring<T>::pop(T& p_value) noexcept
+{
+  const size_t head = m_head.load(std::memory_order_relaxed);
+  if (head == m_cached_tail)
+  {
+    m_cached_tail = m_tail.load(std::memory_order_acquire);
+    if (head == m_cached_tail)
+      return false;
+  }
+  p_value = m_slots[head & m_mask];
+  m_head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+inline size_t Spsc_Ring<T>::dropped() const noexcept
+{
+  return m_dropped.load(std::memory_order_relaxed);
+}
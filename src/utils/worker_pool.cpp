@@ -0,0 +1,107 @@
+/*=====================================================================================
+
+    Filename:     worker_pool.cpp
+
+    Description:  Persistent fork-join pool for short data-parallel tasks
+        Version:  2.0
+
+=====================================================================================*/
+
+#include "worker_pool.h"
+#include <algorithm>
+#include <stdexcept>
+
+Worker_Pool::Worker_Pool(size_t p_thread_num)
+    : m_threads(), m_mutex(), m_start_cv(), m_done_cv(), m_generation(0),
+      m_task_num(0), m_pending(0), m_stop(false), m_task(nullptr),
+      m_invoke(nullptr), m_error(nullptr)
+{
+  const size_t thread_num = std::max<size_t>(1, p_thread_num);
+  m_threads.reserve(thread_num - 1);
+  for (size_t worker_idx = 1; worker_idx < thread_num; ++worker_idx)
+    m_threads.emplace_back(&Worker_Pool::worker_loop, this, worker_idx);
+}
+
+Worker_Pool::~Worker_Pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_start_cv.notify_all();
+  for (auto& thread : m_threads)
+    thread.join();
+}
+
+void Worker_Pool::dispatch(size_t p_task_num,
+                           const void* p_task,
+                           void (*p_invoke)(const void*, size_t))
+{
+  if (p_task_num > thread_num())
+    throw std::invalid_argument("worker pool has fewer threads than tasks");
+  if (p_task_num == 0)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = p_task;
+    m_invoke = p_invoke;
+    m_task_num = p_task_num;
+    m_pending = p_task_num - 1;
+    m_error = nullptr;
+    ++m_generation;
+  }
+  if (p_task_num > 1)
+    m_start_cv.notify_all();
+  std::exception_ptr caller_error;
+  try
+  {
+    p_invoke(p_task, 0);
+  }
+  catch (...)
+  {
+    caller_error = std::current_exception();
+  }
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done_cv.wait(lock, [this]() { return m_pending == 0; });
+  if (caller_error == nullptr)
+    caller_error = m_error;
+  m_task = nullptr;
+  m_invoke = nullptr;
+  lock.unlock();
+  if (caller_error != nullptr)
+    std::rethrow_exception(caller_error);
+}
+
+void Worker_Pool::worker_loop(size_t p_worker_idx)
+{
+  uint64_t seen_generation = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    m_start_cv.wait(lock,
+                    [&]()
+                    { return m_stop || m_generation != seen_generation; });
+    if (m_stop)
+      return;
+    seen_generation = m_generation;
+    if (p_worker_idx >= m_task_num)
+      continue;
+    const void* task = m_task;
+    auto invoke = m_invoke;
+    lock.unlock();
+    std::exception_ptr error;
+    try
+    {
+      invoke(task, p_worker_idx);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+    lock.lock();
+    if (error != nullptr && m_error == nullptr)
+      m_error = error;
+    if (--m_pending == 0)
+      m_done_cv.notify_one();
+  }
+}
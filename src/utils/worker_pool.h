@@ -0,0 +1,85 @@
+/*=====================================================================================
+
+    Filename:     worker_pool.h
+
+    Description:  Persistent fork-join pool for short data-parallel tasks
+        Version:  2.0
+
+=====================================================================================*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Same contract as run_tasks() in parallel_tasks.h, but the threads are
+// created once and parked between calls, so a fork-join costs a wake-up
+// instead of a thread start. Meant for work issued every search step.
+class Worker_Pool
+{
+public:
+  // p_thread_num counts the calling thread, which always takes task 0.
+  explicit Worker_Pool(size_t p_thread_num);
+
+  Worker_Pool(const Worker_Pool&) = delete;
+
+  Worker_Pool& operator=(const Worker_Pool&) = delete;
+
+  ~Worker_Pool();
+
+  inline size_t thread_num() const;
+
+  // Runs p_task(0), ..., p_task(p_task_num - 1), p_task_num <=
+  // thread_num(), and returns when all have finished. The first exception
+  // is rethrown after the join.
+  template <typename Task>
+  void run(size_t p_task_num, const Task& p_task);
+
+private:
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_mutex;
+
+  std::condition_variable m_start_cv;
+
+  std::condition_variable m_done_cv;
+
+  uint64_t m_generation;
+
+  size_t m_task_num;
+
+  size_t m_pending;
+
+  bool m_stop;
+
+  const void* m_task;
+
+  void (*m_invoke)(const void*, size_t);
+
+  std::exception_ptr m_error;
+
+  void dispatch(size_t p_task_num,
+                const void* p_task,
+                void (*p_invoke)(const void*, size_t));
+
+  void worker_loop(size_t p_worker_idx);
+};
+
+inline size_t Worker_Pool::thread_num() const
+{
+  return m_threads.size() + 1;
+}
+
+template <typename Task>
+void Worker_Pool::run(size_t p_task_num, const Task& p_task)
+{
+  dispatch(p_task_num,
+           &p_task,
+           [](const void* p_erased, size_t p_task_idx)
+           { (*static_cast<const Task*>(p_erased))(p_task_idx); });
+}
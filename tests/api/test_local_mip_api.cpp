@@ -40,11 +40,13 @@
 #include "local_search/start/start.h"
 #include "local_search/weight/weight.h"
 #include "reader/Model_Reader.h"
+#include "reader/Sol_Reader.h"
 #undef private
 #undef protected
 #include "model_api/Model_Builder.h"
 #include "utils/paras.h"
 #include "utils/solver_error.h"
+#include "utils/spsc_ring.h"
 
 namespace
 {
@@ -89,8 +91,8 @@ bool test_constructor_defaults()
               "log obj should be enabled by default");
   ok &= check(!solver.m_run_started,
               "solver should not be marked as run before run()");
-  ok &= check(solver.get_model_manager()->m_split_eq,
-              "split equality conversion should be enabled by default");
+  ok &= check(!solver.get_model_manager()->m_split_eq,
+              "equalities should be kept native by default");
   return ok;
 }
 
@@ -111,8 +113,8 @@ bool test_basic_setters()
   ok &= check(!solver.get_model_manager()->m_bound_strengthen,
               "set_bound_strengthen should forward to model manager");
 
-  solver.set_split_eq(false);
-  ok &= check(!solver.get_model_manager()->m_split_eq,
+  solver.set_split_eq(true);
+  ok &= check(solver.get_model_manager()->m_split_eq,
               "set_split_eq should update model manager flag");
 
   solver.set_log_obj(true);
@@ -318,6 +320,324 @@ bool test_run_with_timeout()
   return ok;
 }
 
+bool test_telemetry()
+{
+  Local_MIP solver;
+  solver.set_model_file(TEST_MPS_PATH);
+  solver.set_time_limit(0.1);
+  solver.set_log_obj(false);
+  solver.run();
+
+  bool ok = true;
+  const Search_Telemetry telemetry = solver.get_telemetry();
+  ok &= check(telemetry.neighbors.size() == 5,
+              "telemetry should list every neighbor strategy");
+  ok &= check(!telemetry.neighbors.empty() &&
+                  telemetry.neighbors[0].name == "unsat_mtm_bm",
+              "telemetry should keep the neighbor names in list order");
+  uint64_t scored = 0;
+  uint64_t candidates = 0;
+  for (const auto& stats : telemetry.neighbors)
+  {
+    scored += stats.scored;
+    candidates += stats.candidates;
+  }
+  ok &= check(scored <= candidates,
+              "scored candidates should be a subset of generated ones");
+  if constexpr (k_telemetry_enabled)
+  {
+    ok &= check(telemetry.steps == solver.get_step_num(),
+                "telemetry steps should match the step counter");
+    ok &= check(telemetry.explore_neighbor.calls > 0 && telemetry.moves > 0,
+                "telemetry should count explorations and moves");
+    ok &= check(telemetry.neighbors[0].calls ==
+                    telemetry.explore_neighbor.calls,
+                "every exploration should start with the first neighbor");
+    ok &= check(telemetry.search_seconds > 0.0,
+                "telemetry should record the search time");
+  }
+  else
+  {
+    ok &= check(telemetry.steps == 0 && telemetry.moves == 0 &&
+                    telemetry.explore_neighbor.calls == 0 && candidates == 0,
+                "telemetry should stay zero when recording is compiled out");
+  }
+
+  Search_Telemetry merged;
+  merged.neighbors.push_back(Neighbor_Stats{"flip", 2, 8, 4, 1, 10, 20});
+  Search_Telemetry other;
+  other.steps = 3;
+  other.restart.calls = 1;
+  other.neighbors.push_back(Neighbor_Stats{"easy", 1, 1, 1, 0, 1, 1});
+  other.neighbors.push_back(Neighbor_Stats{"flip", 1, 2, 2, 1, 5, 5});
+  merged.merge(other);
+  ok &= check(merged.steps == 3 && merged.restart.calls == 1,
+              "merge should sum the counters");
+  ok &= check(merged.neighbors.size() == 2 &&
+                  merged.neighbors[0].candidates == 10 &&
+                  merged.neighbors[0].hits == 2 &&
+                  merged.neighbors[1].name == "easy",
+              "merge should match neighbors by name");
+
+  return ok;
+}
+
+bool test_primal_trajectory()
+{
+  bool ok = true;
+  Spsc_Ring<int> ring(3);
+  ok &= check(ring.push(1) && ring.push(2) && ring.push(3) && ring.push(4),
+              "ring capacity should round up to a power of two");
+  ok &= check(!ring.push(5) && ring.dropped() == 1,
+              "a full ring should drop and count the push");
+  int value = 0;
+  ok &= check(ring.pop(value) && value == 1 && ring.push(6),
+              "a pop should free a slot for the producer");
+  for (int expected : {2, 3, 4, 6})
+    ok &= check(ring.pop(value) && value == expected,
+                "the ring should keep FIFO order");
+  ok &= check(!ring.pop(value), "an empty ring should not pop");
+
+  Primal_Trajectory trajectory;
+  trajectory.reset(1, 10.0);
+  ok &= check(trajectory.record(1.0, 5, 20.0), "first point improves");
+  ok &= check(!trajectory.record(1.5, 6, 20.0),
+              "an equal objective should not be recorded");
+  ok &= check(trajectory.record(2.0, 9, 10.5) &&
+                  trajectory.reached_target_num() == 1,
+              "a 4.8% gap should reach only the 10% target");
+  ok &= check(std::fabs(trajectory.primal_integral() - 1.5) < 1e-12,
+              "integral should be updated online with a reference");
+  trajectory.finish(4.0);
+  ok &= check(std::fabs(trajectory.primal_integral() -
+                        (1.5 + 0.5 / 10.5 * 2.0)) < 1e-12,
+              "finish should close the integral at the end time");
+  ok &= check(trajectory.time_to_target(0) == 2.0 &&
+                  std::isnan(trajectory.time_to_target(1)),
+              "time to target should be the first time within the gap");
+
+  trajectory.reset(-1, k_inf);
+  trajectory.record(0.5, 1, 4.0);
+  trajectory.record(1.0, 2, 8.0);
+  ok &= check(!trajectory.record(1.2, 3, 6.0),
+              "a worse objective should not be recorded when maximizing");
+  ok &= check(std::isnan(trajectory.primal_integral()),
+              "integral should wait for the run end without reference");
+  trajectory.finish(2.0);
+  ok &= check(trajectory.reference() == 8.0 &&
+                  std::fabs(trajectory.primal_integral() - 0.75) < 1e-12 &&
+                  trajectory.time_to_target(3) == 1.0,
+              "without reference the best objective should be used");
+
+  Local_MIP solver;
+  solver.set_model_file(TEST_MPS_PATH);
+  solver.set_time_limit(0.1);
+  solver.set_log_obj(false);
+  solver.run();
+  const auto& points = solver.get_trajectory().points();
+  const int is_min = solver.get_model_manager()->is_min();
+  ok &= check(!solver.is_feasible() ||
+                  (!points.empty() &&
+                   points.back().m_obj == solver.get_obj_value()),
+              "trajectory should end at the reported objective");
+  for (size_t point_idx = 1; point_idx < points.size(); ++point_idx)
+    ok &= check(points[point_idx].m_seconds >=
+                        points[point_idx - 1].m_seconds &&
+                    is_min * points[point_idx].m_obj <
+                        is_min * points[point_idx - 1].m_obj,
+                "trajectory should improve over time");
+  return ok;
+}
+
+bool test_incremental_sol_writes()
+{
+  const std::string sol_path = "test-incremental.sol";
+  std::remove(sol_path.c_str());
+  Model_Builder builder;
+  builder.set_sense(Model_Builder::Sense::maximize);
+  std::vector<int> items;
+  std::vector<double> weights;
+  for (int item = 0; item < 8; ++item)
+  {
+    std::string name = "x";
+    name += std::to_string(item);
+    items.push_back(builder.add_var(name,
+                                    0.0,
+                                    1.0,
+                                    1.0 + item,
+                                    Var_Type::binary));
+    weights.push_back(2.0 + item % 3);
+  }
+  builder.add_con(k_neg_inf, 9.0, items, weights);
+  auto prepared_model = prepare_model(builder);
+
+  Local_MIP solver(prepared_model);
+  solver.set_time_limit(0.3);
+  solver.set_log_obj(false);
+  solver.set_sol_path(sol_path);
+  solver.set_sol_interval(0.02);
+  solver.run();
+
+  bool ok = true;
+  ok &= check(solver.m_sol_snapshot != nullptr,
+              "a sol path with a positive interval should start the writer");
+  ok &= check(solver.m_sol_writer.write_num() >= 1,
+              "the writer should dump the incumbent during the run");
+  ok &= check(!solver.m_sol_writer.m_thread.joinable(),
+              "the writer thread should be joined after run");
+  ok &= check(!std::filesystem::exists(sol_path + ".tmp"),
+              "no temporary solution file should be left behind");
+  std::vector<double> solution;
+  Sol_Read_Result result =
+      Sol_Reader::read(sol_path, *solver.get_model_manager(), solution);
+  ok &= check(result.m_success, "the written solution should be readable");
+  std::remove(sol_path.c_str());
+
+  Local_MIP disabled(prepared_model);
+  disabled.set_time_limit(0.1);
+  disabled.set_log_obj(false);
+  disabled.set_sol_path(sol_path);
+  disabled.set_sol_interval(0.0);
+  disabled.run();
+  ok &= check(disabled.m_sol_snapshot == nullptr &&
+                  disabled.m_sol_writer.write_num() == 0,
+              "interval 0 should disable incremental writes");
+  std::remove(sol_path.c_str());
+  return ok;
+}
+
+std::shared_ptr<const Prepared_Model> prepare_cover_model()
+{
+  Model_Builder builder;
+  std::vector<int> vars;
+  for (int var = 0; var < 60; ++var)
+  {
+    std::string name = "y";
+    name += std::to_string(var);
+    vars.push_back(builder.add_var(name,
+                                   0.0,
+                                   1.0,
+                                   1.0 + (var * 7) % 11,
+                                   Var_Type::binary));
+  }
+  for (int con = 0; con < 40; ++con)
+  {
+    std::vector<int> cover;
+    for (int term = 0; term < 6; ++term)
+      cover.push_back(vars[(con * 13 + term * 17) % 60]);
+    builder.add_con(
+        1.0, k_inf, cover, std::vector<double>(cover.size(), 1.0));
+  }
+  return prepare_model(builder);
+}
+
+bool test_checkpoint_resume()
+{
+  const std::string checkpoint_path = "test-resume.ckpt";
+  auto prepared_model = prepare_cover_model();
+  auto configure = [](Local_MIP& p_solver, size_t p_step_limit)
+  {
+    p_solver.set_time_limit(60.0);
+    p_solver.set_log_obj(false);
+    p_solver.set_random_seed(11);
+    p_solver.set_restart_step(400);
+    p_solver.set_weight_method("smooth");
+    p_solver.set_step_limit(p_step_limit);
+  };
+
+  Local_MIP whole(prepared_model);
+  configure(whole, 6000);
+  whole.run();
+
+  Local_MIP first(prepared_model);
+  configure(first, 2500);
+  first.set_checkpoint_path(checkpoint_path);
+  first.run();
+
+  Local_MIP second(prepared_model);
+  configure(second, 6000);
+  second.set_resume_path(checkpoint_path);
+  second.run();
+
+  bool ok = true;
+  const Local_Search& expected = *whole.m_local_search;
+  const Local_Search& resumed = *second.m_local_search;
+  ok &= check(first.m_local_search->m_cur_step == 2500,
+              "the first slice should stop at its step limit");
+  ok &= check(resumed.m_cur_step == expected.m_cur_step,
+              "the resumed run should stop at the same total step");
+  ok &= check(resumed.m_var_current_value == expected.m_var_current_value,
+              "current values should match an uninterrupted run");
+  ok &= check(resumed.m_var_best_value == expected.m_var_best_value,
+              "best values should match an uninterrupted run");
+  ok &= check(resumed.m_con_weight == expected.m_con_weight,
+              "constraint weights should match an uninterrupted run");
+  ok &= check(resumed.m_con_activity == expected.m_con_activity,
+              "activities should match an uninterrupted run bit for bit");
+  ok &= check(resumed.m_var_last_inc_step == expected.m_var_last_inc_step,
+              "age steps should match an uninterrupted run");
+  ok &= check(resumed.m_rng == expected.m_rng,
+              "the random generator should match an uninterrupted run");
+  ok &= check(second.get_trajectory().points().size() >= 1,
+              "the restored incumbent should start the trajectory");
+
+  ok &= check(second.checkpoint(checkpoint_path),
+              "checkpoint() should write the finished search state");
+  Local_MIP reconfigured(prepare_cover_model());
+  reconfigured.set_time_limit(1.0);
+  reconfigured.set_log_obj(false);
+  reconfigured.m_local_search->clear_neighbor_list();
+  reconfigured.m_local_search->add_custom_neighbor(
+      "custom", [](Neighbor::Neighbor_Ctx&, void*) {});
+  reconfigured.set_resume_path(checkpoint_path);
+  bool rejected = false;
+  try
+  {
+    reconfigured.run();
+  }
+  catch (const Solver_Error&)
+  {
+    rejected = true;
+  }
+  ok &= check(!rejected,
+              "built-in neighbors should be restored from the checkpoint");
+
+  std::FILE* file = std::fopen(checkpoint_path.c_str(), "wb");
+  if (file != nullptr)
+  {
+    std::fputs("LMIPCKPT", file);
+    std::fclose(file);
+  }
+  Local_MIP truncated(prepared_model);
+  truncated.set_time_limit(1.0);
+  truncated.set_log_obj(false);
+  truncated.set_resume_path(checkpoint_path);
+  rejected = false;
+  try
+  {
+    truncated.run();
+  }
+  catch (const Solver_Error&)
+  {
+    rejected = true;
+  }
+  ok &= check(rejected, "a truncated checkpoint should be rejected");
+
+  Local_MIP unfinished(prepared_model);
+  rejected = false;
+  try
+  {
+    unfinished.checkpoint(checkpoint_path);
+  }
+  catch (const std::logic_error&)
+  {
+    rejected = true;
+  }
+  ok &= check(rejected, "checkpoint() should require a finished search");
+  std::remove(checkpoint_path.c_str());
+  return ok;
+}
+
 bool test_concurrent_user_termination()
 {
   Model_Builder builder;
@@ -505,6 +825,10 @@ bool test_invalid_numeric_setters()
   ok &= check(
       rejects([&]() { solver.set_time_limit(k_max_time_limit + 1.0); }),
       "Time limit above the documented maximum should be rejected");
+  ok &= check(rejects([&]() { solver.set_sol_interval(-1.0); }),
+              "Negative sol interval should be rejected");
+  ok &= check(rejects([&]() { solver.set_sol_interval(nan); }),
+              "NaN sol interval should be rejected");
   ok &= check(rejects([&]() { solver.set_feas_tolerance(-1.0); }),
               "Negative feasibility tolerance should be rejected");
   ok &= check(rejects(
@@ -1254,6 +1578,10 @@ int main()
   ok &= test_basic_setters();
   ok &= test_model_file_reader();
   ok &= test_run_with_timeout();
+  ok &= test_telemetry();
+  ok &= test_primal_trajectory();
+  ok &= test_incremental_sol_writes();
+  ok &= test_checkpoint_resume();
   ok &= test_concurrent_user_termination();
   ok &= test_one_shot_run_guard();
   ok &= test_invalid_numeric_setters();
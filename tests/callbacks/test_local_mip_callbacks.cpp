@@ -19,8 +19,11 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <atomic>
 #include <random>
 #include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 #define private public
@@ -33,6 +36,8 @@
 #include "local_search/weight/weight.h"
 #undef private
 #undef protected
+#include "local_search/incumbent/incumbent_snapshot.h"
+#include "model_api/Model_Builder.h"
 
 namespace
 {
@@ -79,8 +84,8 @@ struct SharedData
   std::vector<double> con_constant;
   std::vector<bool> con_is_equality;
   std::vector<size_t> con_weight;
-  std::vector<size_t> con_unsat_idxs;
-  std::vector<size_t> con_pos_in_unsat_idxs;
+  std::vector<Model_Idx> con_unsat_idxs;
+  std::vector<Model_Idx> con_pos_in_unsat_idxs;
   std::vector<size_t> var_last_dec_step;
   std::vector<size_t> var_last_inc_step;
   std::vector<double> var_obj_cost;
@@ -92,10 +97,10 @@ struct SharedData
   std::vector<size_t> var_allow_dec_step;
   bool current_obj_breakthrough;
   size_t obj_var_num;
-  std::vector<size_t> binary_idx_list;
+  std::vector<Model_Idx> binary_idx_list;
   std::vector<double> var_current_value;
-  std::vector<size_t> con_sat_idxs;
-  std::vector<size_t> non_fixed_var_idxs;
+  std::vector<Model_Idx> con_sat_idxs;
+  std::vector<Model_Idx> non_fixed_var_idxs;
   Readonly_Ctx view;
 };
 
@@ -398,6 +403,92 @@ bool test_neighbor_validation_classification()
   return ok;
 }
 
+bool test_improvement_cbk_and_snapshot()
+{
+  // Knapsack: maximize value within a weight budget.
+  Model_Builder builder;
+  builder.set_sense(Model_Builder::Sense::maximize);
+  std::vector<int> cols;
+  std::vector<double> weights;
+  for (int item = 0; item < 30; ++item)
+  {
+    std::string name = "x";
+    name += std::to_string(item);
+    cols.push_back(builder.add_var(name,
+                                   0.0,
+                                   1.0,
+                                   1.0 + (item * 7) % 11,
+                                   Var_Type::binary));
+    weights.push_back(1.0 + (item * 5) % 9);
+  }
+  builder.add_con(k_neg_inf, 40.0, cols, weights);
+  Model_Prepare_Options options;
+  options.bound_strengthen = 0;
+  Local_MIP solver(builder.prepare(options));
+  solver.set_time_limit(0.3);
+  solver.set_log_obj(false);
+
+  std::vector<double> reported_objs;
+  size_t reported_size = 0;
+  int user_data = 7;
+  bool user_data_seen = true;
+  solver.set_improvement_cbk(
+      [&](const Improvement_Ctx& p_ctx, void* p_user_data)
+      {
+        reported_objs.push_back(p_ctx.m_obj);
+        reported_size = p_ctx.m_values.size();
+        user_data_seen &= p_user_data == &user_data;
+      },
+      &user_data);
+  auto snapshot = solver.enable_incumbent_snapshot();
+  bool ok = check(snapshot == solver.enable_incumbent_snapshot(),
+                  "the incumbent snapshot should be created once");
+
+  std::atomic<bool> done{false};
+  bool consumer_ok = true;
+  std::thread consumer(
+      [&]()
+      {
+        uint64_t last_sequence = 0;
+        double last_obj = -k_inf;
+        while (!done.load(std::memory_order_acquire))
+        {
+          if (snapshot->acquire())
+          {
+            const auto& front = snapshot->front();
+            consumer_ok &= front.m_sequence > last_sequence &&
+                           front.m_obj > last_obj;
+            last_sequence = front.m_sequence;
+            last_obj = front.m_obj;
+          }
+          std::this_thread::yield();
+        }
+      });
+  solver.run();
+  done.store(true, std::memory_order_release);
+  consumer.join();
+
+  ok &= check(solver.is_feasible() && !reported_objs.empty(),
+              "improvement callback should be invoked");
+  ok &= check(user_data_seen, "improvement callback should get user data");
+  for (size_t idx = 1; idx < reported_objs.size(); ++idx)
+    ok &= check(reported_objs[idx] > reported_objs[idx - 1],
+                "improvement callback objectives should improve");
+  ok &= check(!reported_objs.empty() &&
+                  reported_objs.back() == solver.get_obj_value(),
+              "last improvement should be the reported objective");
+  ok &= check(reported_size == solver.get_model_manager()->var_num(),
+              "improvement values should span the search model");
+  ok &= check(consumer_ok,
+              "snapshot consumer should see newer incumbents only");
+  snapshot->acquire();
+  ok &= check(snapshot->front().m_sequence == reported_objs.size() &&
+                  snapshot->front().m_obj == reported_objs.back() &&
+                  snapshot->front().m_values.size() == reported_size,
+              "snapshot should hold the last incumbent after the run");
+  return ok;
+}
+
 } // namespace
 
 int main()
@@ -411,6 +502,7 @@ int main()
   ok &= test_lift_scoring_cbk_invocation();
   ok &= test_neighbor_scoring_cbk_invocation();
   ok &= test_neighbor_validation_classification();
+  ok &= test_improvement_cbk_and_snapshot();
 
   if (!ok)
   {
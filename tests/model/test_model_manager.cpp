@@ -16,12 +16,14 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <limits>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../test_utils.h"
@@ -357,6 +359,536 @@ protected:
   }
 };
 
+class Test_Flat_Matrix_View : public Test_Runner
+{
+public:
+  Test_Flat_Matrix_View() : Test_Runner("Flat CSR/CSC Matrix View") {}
+
+protected:
+  void execute() override
+  {
+    Model_Manager manager;
+    manager.set_bound_strengthen(0);
+    manager.set_split_eq(false);
+    manager.make_con("");
+    size_t x_idx = manager.make_var("x", true);
+    size_t y_idx = manager.make_var("y", true);
+    size_t z_idx = manager.make_var("z", false);
+    size_t c1_idx = manager.make_con("c1", '<');
+    size_t c2_idx = manager.make_con("c2", '>');
+    auto link = [&](size_t p_con_idx, size_t p_var_idx, double p_coeff)
+    {
+      Model_Var& var = manager.var(p_var_idx);
+      Model_Con& con = manager.con(p_con_idx);
+      var.add_con(p_con_idx, con.term_num());
+      con.add_var(p_var_idx, p_coeff, var.term_num() - 1);
+    };
+    link(0, x_idx, 1.0);
+    link(0, z_idx, -2.0);
+    link(c1_idx, x_idx, 3.0);
+    link(c1_idx, y_idx, 4.0);
+    link(c2_idx, y_idx, 1.0);
+    link(c2_idx, z_idx, 5.0);
+    link(c2_idx, x_idx, -1.0);
+    manager.set_var_upper_bound(manager.var(x_idx), 10.0);
+    manager.set_var_upper_bound(manager.var(y_idx), 10.0);
+    manager.set_var_upper_bound(manager.var(z_idx), 10.0);
+
+    check(manager.process_after_read(),
+          "process_after_read should succeed");
+    const Model_Matrix& matrix = manager.matrix();
+    check(matrix.row_num() == manager.con_num(),
+          "CSR should have one row per constraint including objective");
+    check(matrix.col_num() == manager.var_num(),
+          "CSC should have one column per variable");
+    check(matrix.nnz() == 7, "Matrix should hold every stored term");
+
+    for (size_t con_idx = 0; con_idx < manager.con_num(); ++con_idx)
+    {
+      const Model_Con& con = manager.con(con_idx);
+      const auto var_idxs = matrix.row_var_idxs(con_idx);
+      const auto coeffs = matrix.row_coeffs(con_idx);
+      check(var_idxs.size() == con.term_num(),
+            "CSR row length should match constraint terms");
+      for (size_t term_idx = 0; term_idx < con.term_num(); ++term_idx)
+      {
+        check(var_idxs[term_idx] == con.var_idx(term_idx),
+              "CSR row should keep constraint term order");
+        check(coeffs[term_idx] == con.coeff(term_idx),
+              "CSR coefficient should match normalized constraint");
+      }
+    }
+
+    for (size_t var_idx = 0; var_idx < manager.var_num(); ++var_idx)
+    {
+      const Model_Var& var = manager.var(var_idx);
+      const auto col = matrix.col(var_idx);
+      check(col.size() == var.term_num(),
+            "CSC column length should match variable terms");
+      for (size_t term_idx = 0; term_idx < var.term_num(); ++term_idx)
+      {
+        const size_t con_idx = var.con_idx(term_idx);
+        check(col[term_idx].con_idx == con_idx,
+              "CSC column should keep variable term order");
+        check(col[term_idx].coeff ==
+                  manager.con(con_idx).coeff(var.pos_in_con(term_idx)),
+              "CSC inline coefficient should match row coefficient");
+      }
+    }
+    check_double(matrix.row_coeffs(c2_idx)[0],
+                 -1.0,
+                 "Greater-than rows should be stored after normalization");
+  }
+};
+
+// A fixed variable is substituted out of its rows by presolve; its column
+// must not keep the positions it had in those rows.
+class Test_Matrix_After_Fixed_Var_Elimination : public Test_Runner
+{
+public:
+  Test_Matrix_After_Fixed_Var_Elimination()
+      : Test_Runner("Matrix View After Fixed Variable Elimination")
+  {
+  }
+
+protected:
+  void execute() override
+  {
+    Model_Manager manager;
+    manager.set_bound_strengthen(1);
+    manager.set_split_eq(false);
+    manager.make_con("");
+    size_t x_idx = manager.make_var("x", true);
+    size_t y_idx = manager.make_var("y", true);
+    size_t z_idx = manager.make_var("z", true);
+    size_t c1_idx = manager.make_con("c1", '<');
+    size_t c2_idx = manager.make_con("c2", '<');
+    auto link = [&](size_t p_con_idx, size_t p_var_idx, double p_coeff)
+    {
+      Model_Var& var = manager.var(p_var_idx);
+      Model_Con& con = manager.con(p_con_idx);
+      var.add_con(p_con_idx, con.term_num());
+      con.add_var(p_var_idx, p_coeff, var.term_num() - 1);
+    };
+    // x is the last term of every row, so its stale position would point
+    // one past the end of the shortened rows.
+    link(0, y_idx, 1.0);
+    link(0, x_idx, 1.0);
+    link(c1_idx, y_idx, 1.0);
+    link(c1_idx, z_idx, 2.0);
+    link(c1_idx, x_idx, 3.0);
+    link(c2_idx, z_idx, 1.0);
+    link(c2_idx, x_idx, 1.0);
+    manager.con(c1_idx).set_rhs(20.0);
+    manager.con(c2_idx).set_rhs(20.0);
+    manager.set_var_lower_bound(manager.var(x_idx), 2.0);
+    manager.set_var_upper_bound(manager.var(x_idx), 2.0);
+    manager.set_var_upper_bound(manager.var(y_idx), 5.0);
+    manager.set_var_upper_bound(manager.var(z_idx), 5.0);
+
+    check(manager.process_after_read(),
+          "process_after_read should succeed");
+    check(manager.var(x_idx).type() == Var_Type::fixed,
+          "x should be fixed by its bounds");
+    const Model_Matrix& matrix = manager.matrix();
+    check(matrix.col(x_idx).empty(),
+          "Eliminated variable should have an empty column");
+    size_t row_nnz = 0;
+    for (size_t con_idx = 0; con_idx < manager.con_num(); ++con_idx)
+      row_nnz += manager.con(con_idx).term_num();
+    check(matrix.nnz() == row_nnz,
+          "Matrix should hold only the remaining row terms");
+    for (size_t var_idx = 0; var_idx < manager.var_num(); ++var_idx)
+    {
+      const Model_Var& var = manager.var(var_idx);
+      const auto col = matrix.col(var_idx);
+      check(col.size() == var.term_num(),
+            "CSC column length should match variable terms");
+      for (size_t term_idx = 0; term_idx < col.size(); ++term_idx)
+      {
+        const Model_Con& con = manager.con(col[term_idx].con_idx);
+        const size_t pos_in_con = var.pos_in_con(term_idx);
+        check(pos_in_con < con.term_num() &&
+                  con.var_idx(pos_in_con) == var_idx,
+              "CSC entry should point at its row term");
+      }
+    }
+  }
+};
+
+class Test_Parallel_Presolve : public Test_Runner
+{
+private:
+  // Built in two steps: "x" + std::to_string(...) trips GCC -Wrestrict.
+  static std::string indexed_name(const char* p_prefix, size_t p_idx)
+  {
+    std::string name = p_prefix;
+    name += std::to_string(p_idx);
+    return name;
+  }
+
+  // Mixed rows (<=, >=, =, empty) over binary, integer, continuous and
+  // fixed columns, from a fixed-seed generator.
+  static void build_model(Model_Manager& p_manager)
+  {
+    p_manager.make_con("");
+    uint64_t state = 12345;
+    auto next = [&state](uint64_t p_range)
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      return (state >> 33) % p_range;
+    };
+    const size_t var_num = 300;
+    const size_t con_num = 200;
+    for (size_t var_idx = 0; var_idx < var_num; ++var_idx)
+    {
+      Model_Var& var = p_manager.var(
+          p_manager.make_var(indexed_name("x", var_idx), var_idx % 3 != 2));
+      p_manager.set_var_upper_bound(var, double(var_idx % 3 == 0 ? 1 : 5));
+      if (var_idx % 17 == 0)
+      {
+        p_manager.set_var_lower_bound(var, 1.0);
+        p_manager.set_var_upper_bound(var, 1.0);
+      }
+    }
+    for (size_t con_idx = 1; con_idx <= con_num; ++con_idx)
+      p_manager.make_con(indexed_name("r", con_idx), "<>="[con_idx % 3]);
+    auto link = [&](size_t p_con_idx, size_t p_var_idx, double p_coeff)
+    {
+      Model_Var& var = p_manager.var(p_var_idx);
+      Model_Con& con = p_manager.con(p_con_idx);
+      var.add_con(p_con_idx, con.term_num());
+      con.add_var(p_var_idx, p_coeff, var.term_num() - 1);
+    };
+    for (size_t var_idx = 0; var_idx < var_num; ++var_idx)
+    {
+      link(0, var_idx, double(next(7)) - 3.0);
+      const size_t term_num = 1 + next(4);
+      for (size_t term_idx = 0; term_idx < term_num; ++term_idx)
+      {
+        // Rows beyond con_num - 5 stay empty.
+        const size_t con_idx = 1 + (var_idx * 7 + term_idx * 13) % (con_num - 5);
+        link(con_idx, var_idx, double(next(5)) + 1.0);
+      }
+    }
+    for (size_t con_idx = 1; con_idx <= con_num; ++con_idx)
+      p_manager.con(con_idx).set_rhs(double(next(20)));
+  }
+
+  static bool same_model(const Model_Manager& p_lhs, const Model_Manager& p_rhs)
+  {
+    bool same = p_lhs.m_var_num == p_rhs.m_var_num &&
+                p_lhs.m_con_num == p_rhs.m_con_num &&
+                p_lhs.m_delete_con_num == p_rhs.m_delete_con_num &&
+                p_lhs.m_binary_idx_list == p_rhs.m_binary_idx_list &&
+                p_lhs.m_non_fixed_var_idxs == p_rhs.m_non_fixed_var_idxs &&
+                p_lhs.m_type_to_con_idx_list == p_rhs.m_type_to_con_idx_list &&
+                p_lhs.m_con_name_to_idx == p_rhs.m_con_name_to_idx;
+    for (size_t var_idx = 0; same && var_idx < p_lhs.m_var_num; ++var_idx)
+    {
+      const Model_Var& lhs = p_lhs.var(var_idx);
+      const Model_Var& rhs = p_rhs.var(var_idx);
+      same = lhs.type() == rhs.type() &&
+             lhs.lower_bound() == rhs.lower_bound() &&
+             lhs.upper_bound() == rhs.upper_bound() &&
+             lhs.con_idx_set() == rhs.con_idx_set() &&
+             lhs.m_pos_in_con_list == rhs.m_pos_in_con_list;
+    }
+    for (size_t con_idx = 0; same && con_idx < p_lhs.m_con_num; ++con_idx)
+    {
+      const Model_Con& lhs = p_lhs.con(con_idx);
+      const Model_Con& rhs = p_rhs.con(con_idx);
+      same = lhs.name() == rhs.name() && lhs.rhs() == rhs.rhs() &&
+             lhs.is_equality() == rhs.is_equality() &&
+             lhs.is_inferred_sat() == rhs.is_inferred_sat() &&
+             lhs.var_idx_set() == rhs.var_idx_set() &&
+             lhs.coeff_set() == rhs.coeff_set() &&
+             lhs.m_pos_in_var_list == rhs.m_pos_in_var_list;
+    }
+    return same;
+  }
+
+public:
+  Test_Parallel_Presolve() : Test_Runner("Parallel Presolve Determinism") {}
+
+protected:
+  void execute() override
+  {
+    Model_Manager serial;
+    build_model(serial);
+    serial.set_presolve_workers(1);
+    check(serial.process_after_read(), "Serial presolve should succeed");
+    check(serial.m_delete_con_num > 0,
+          "Empty rows should be marked as inferred satisfied");
+
+    for (size_t worker_num : {2, 3, 8})
+    {
+      Model_Manager parallel;
+      build_model(parallel);
+      parallel.set_presolve_workers(worker_num);
+      // One row per slice at minimum, so the small model is really split.
+      parallel.m_min_presolve_slice = 1;
+      check(parallel.process_after_read(),
+            "Parallel presolve should succeed");
+      check(same_model(serial, parallel),
+            "Presolve should give the same model for every worker count");
+    }
+
+    Model_Manager infeasible;
+    infeasible.make_con("");
+    for (size_t var_idx = 0; var_idx < 64; ++var_idx)
+    {
+      Model_Var& var =
+          infeasible.var(infeasible.make_var(indexed_name("v", var_idx), false));
+      if (var_idx == 40 || var_idx == 50)
+      {
+        infeasible.set_var_lower_bound(var, 2.0);
+        infeasible.set_var_upper_bound(var, 1.0);
+      }
+    }
+    infeasible.set_presolve_workers(4);
+    infeasible.m_min_presolve_slice = 1;
+    check(!infeasible.process_after_read(),
+          "Crossed bounds should be reported by a parallel variable pass");
+  }
+};
+
+class Test_Activity_Propagation : public Test_Runner
+{
+private:
+  static void link(Model_Manager& p_manager,
+                   size_t p_con_idx,
+                   size_t p_var_idx,
+                   double p_coeff)
+  {
+    Model_Var& var = p_manager.var(p_var_idx);
+    Model_Con& con = p_manager.con(p_con_idx);
+    var.add_con(p_con_idx, con.term_num());
+    con.add_var(p_var_idx, p_coeff, var.term_num() - 1);
+  }
+
+  // x + y <= 3, z - x <= 2, y + z >= 5, 2w + x <= 8 over integers
+  // x, y, z in [0, 10] and a continuous w >= 0.
+  static void build_chain(Model_Manager& p_manager, double p_rhs_yz)
+  {
+    p_manager.make_con("");
+    for (const char* name : {"x", "y", "z"})
+    {
+      Model_Var& var = p_manager.var(p_manager.make_var(name, true));
+      p_manager.set_var_type(var, Var_Type::general_integer);
+      p_manager.set_var_upper_bound(var, 10.0);
+    }
+    const size_t w_idx = p_manager.make_var("w", false);
+    const size_t c1 = p_manager.make_con("c1", '<');
+    const size_t c2 = p_manager.make_con("c2", '<');
+    const size_t c3 = p_manager.make_con("c3", '>');
+    const size_t c4 = p_manager.make_con("c4", '<');
+    link(p_manager, 0, w_idx, 1.0);
+    link(p_manager, c1, 0, 1.0);
+    link(p_manager, c1, 1, 1.0);
+    link(p_manager, c2, 2, 1.0);
+    link(p_manager, c2, 0, -1.0);
+    link(p_manager, c3, 1, 1.0);
+    link(p_manager, c3, 2, 1.0);
+    link(p_manager, c4, w_idx, 2.0);
+    link(p_manager, c4, 0, 1.0);
+    p_manager.con(c1).set_rhs(3.0);
+    p_manager.con(c2).set_rhs(2.0);
+    p_manager.con(c3).set_rhs(p_rhs_yz);
+    p_manager.con(c4).set_rhs(8.0);
+  }
+
+public:
+  Test_Activity_Propagation() : Test_Runner("Activity Bound Propagation") {}
+
+protected:
+  void execute() override
+  {
+    Model_Manager manager;
+    build_chain(manager, 5.0);
+    manager.set_bound_strengthen(2);
+    check(manager.process_after_read(), "Propagation should succeed");
+    check_double(manager.var("x").upper_bound(), 3.0, "x <= 3 from c1");
+    check_double(manager.var("y").upper_bound(), 3.0, "y <= 3 from c1");
+    check_double(manager.var("z").upper_bound(),
+                 5.0,
+                 "z <= 5 needs the tightened bound of x");
+    check_double(manager.var("z").lower_bound(),
+                 2.0,
+                 "z >= 2 needs the tightened bound of y");
+    check(manager.var("w").upper_bound() <= 4.0 + 1e-5,
+          "Continuous bounds should be tightened too");
+
+    Model_Manager unchanged;
+    build_chain(unchanged, 5.0);
+    unchanged.set_bound_strengthen(1);
+    check(unchanged.process_after_read(), "Level 1 MIP should succeed");
+    check_double(unchanged.var("x").upper_bound(),
+                 10.0,
+                 "Level 1 should not propagate a model with real columns");
+
+    Model_Manager infeasible;
+    build_chain(infeasible, 7.0);
+    infeasible.set_bound_strengthen(2);
+    check(!infeasible.process_after_read(),
+          "y + z >= 7 cannot hold once y <= 3 and z <= 3 + 2");
+
+    // Level 1 on a pure integer model: u + v <= 0 fixes both at zero,
+    // leaving u + v + t <= 4 to bound t alone.
+    Model_Manager integer;
+    integer.make_con("");
+    for (const char* name : {"u", "v", "t"})
+    {
+      Model_Var& var = integer.var(integer.make_var(name, true));
+      integer.set_var_type(var, Var_Type::general_integer);
+      integer.set_var_upper_bound(var, 10.0);
+    }
+    const size_t d1 = integer.make_con("d1", '<');
+    const size_t d2 = integer.make_con("d2", '<');
+    link(integer, d1, 0, 1.0);
+    link(integer, d1, 1, 1.0);
+    link(integer, d2, 0, 1.0);
+    link(integer, d2, 1, 1.0);
+    link(integer, d2, 2, 1.0);
+    integer.con(d2).set_rhs(4.0);
+    check(integer.process_after_read(), "Integer propagation should succeed");
+    check(integer.var("u").type() == Var_Type::fixed &&
+              integer.var("v").type() == Var_Type::fixed,
+          "Variables pinned by propagation should be fixed");
+    check(integer.con(d1).is_inferred_sat(),
+          "A row emptied by fixed variables should be removed");
+    check_double(integer.var("t").upper_bound(),
+                 4.0,
+                 "The surviving row should bound t");
+  }
+};
+
+class Test_Duplicate_Presolve : public Test_Runner
+{
+private:
+  static void link(Model_Manager& p_manager,
+                   size_t p_con_idx,
+                   size_t p_var_idx,
+                   double p_coeff)
+  {
+    Model_Var& var = p_manager.var(p_var_idx);
+    Model_Con& con = p_manager.con(p_con_idx);
+    var.add_con(p_con_idx, con.term_num());
+    con.add_var(p_var_idx, p_coeff, var.term_num() - 1);
+  }
+
+  // Integers x, y in [0, 10] and z, w in [0, 5]; z and w share every
+  // coefficient, objective included. r2 is a tighter multiple of r1 and r3
+  // is looser, while r4 bounds x + y from the other side and e1 splits into
+  // two opposite rows.
+  static void build(Model_Manager& p_manager, bool p_dup_presolve)
+  {
+    p_manager.make_con("");
+    for (const char* name : {"x", "y", "z", "w"})
+    {
+      Model_Var& var = p_manager.var(p_manager.make_var(name, true));
+      p_manager.set_var_type(var, Var_Type::general_integer);
+      p_manager.set_var_upper_bound(var, name[0] < 'w' ? 10.0 : 5.0);
+    }
+    const size_t r1 = p_manager.make_con("r1", '<');
+    const size_t r2 = p_manager.make_con("r2", '<');
+    const size_t r3 = p_manager.make_con("r3", '<');
+    const size_t r4 = p_manager.make_con("r4", '>');
+    const size_t e1 = p_manager.make_con("e1", '=');
+    const size_t r5 = p_manager.make_con("r5", '<');
+    const size_t r6 = p_manager.make_con("r6", '<');
+    for (const auto& [con_idx, scale] :
+         {std::pair{r1, 1.0}, {r2, 2.0}, {r3, 1.0}, {r4, 1.0}})
+    {
+      link(p_manager, con_idx, 0, scale);
+      link(p_manager, con_idx, 1, scale);
+    }
+    p_manager.con(r1).set_rhs(8.0);
+    p_manager.con(r2).set_rhs(14.0);
+    p_manager.con(r3).set_rhs(12.0);
+    p_manager.con(r4).set_rhs(1.0);
+    link(p_manager, e1, 0, 1.0);
+    link(p_manager, e1, 1, -1.0);
+    p_manager.con(e1).set_rhs(2.0);
+    for (size_t var_idx : {2, 3})
+    {
+      link(p_manager, 0, var_idx, 1.0);
+      link(p_manager, r5, var_idx, 1.0);
+      link(p_manager, r6, var_idx, 3.0);
+    }
+    link(p_manager, r5, 0, 1.0);
+    link(p_manager, r6, 1, -1.0);
+    p_manager.con(r5).set_rhs(9.0);
+    p_manager.con(r6).set_rhs(20.0);
+    p_manager.set_bound_strengthen(0);
+    p_manager.set_dup_presolve(p_dup_presolve);
+  }
+
+public:
+  Test_Duplicate_Presolve() : Test_Runner("Duplicate Row and Column Presolve")
+  {
+  }
+
+protected:
+  void execute() override
+  {
+    Model_Manager manager;
+    build(manager, true);
+    check(manager.process_after_read(), "Duplicate presolve should succeed");
+    check(manager.con("r1").is_inferred_sat(),
+          "A row implied by a scaled parallel row should be dropped");
+    check(manager.con("r3").is_inferred_sat(),
+          "A looser parallel row should be dropped");
+    check(!manager.con("r2").is_inferred_sat() &&
+              !manager.con("r4").is_inferred_sat(),
+          "The tightest row on each side should be kept");
+    check(!manager.con("e1").is_inferred_sat(),
+          "Both halves of a split equality should be kept");
+    check(manager.con("r1").term_num() == 0,
+          "A dropped row should leave the matrix");
+
+    check(manager.column_merges().size() == 1,
+          "z and w should be merged into one column");
+    if (manager.column_merges().size() != 1)
+      return;
+    const Column_Merge& merge = manager.column_merges().front();
+    const Model_Var& kept = manager.var(merge.kept_idx);
+    const Model_Var& removed = manager.var(merge.removed_idx);
+    check(removed.type() == Var_Type::fixed && removed.term_num() == 0,
+          "The removed column should be fixed and empty");
+    check_double(kept.upper_bound(),
+                 10.0,
+                 "The kept column should span both domains");
+
+    std::vector<double> values(manager.var_num(), 0.0);
+    values[merge.kept_idx] = 7.0;
+    manager.postsolve_values(values);
+    check_double(values[merge.kept_idx] + values[merge.removed_idx],
+                 7.0,
+                 "Postsolve should preserve the merged value");
+    check(values[merge.kept_idx] <= 5.0 && values[merge.removed_idx] <= 5.0,
+          "Postsolve should respect the original bounds");
+
+    std::vector<char> mask(manager.var_num(), 0);
+    mask[merge.kept_idx] = 1;
+    mask[merge.removed_idx] = 1;
+    manager.presolve_values(values, &mask);
+    check_double(values[merge.kept_idx],
+                 7.0,
+                 "Presolve should fold the removed value into the kept one");
+    check_double(values[merge.removed_idx],
+                 0.0,
+                 "The removed column should be reset");
+
+    Model_Manager disabled;
+    build(disabled, false);
+    check(disabled.process_after_read(), "Disabled presolve should succeed");
+    check(!disabled.con("r1").is_inferred_sat() &&
+              disabled.column_merges().empty(),
+          "Disabling duplicate presolve should keep the model as read");
+  }
+};
+
 } // namespace
 
 int main()
@@ -373,6 +905,11 @@ int main()
   suite.add_test(new Test_Objective_Function());
   suite.add_test(new Test_Split_Equality_Conversion());
   suite.add_test(new Test_Integer_Domain_Integrity());
+  suite.add_test(new Test_Flat_Matrix_View());
+  suite.add_test(new Test_Matrix_After_Fixed_Var_Elimination());
+  suite.add_test(new Test_Parallel_Presolve());
+  suite.add_test(new Test_Activity_Propagation());
+  suite.add_test(new Test_Duplicate_Presolve());
 
   bool ok = suite.run_all();
 
@@ -42,9 +42,9 @@ void test_neighbor_ctx_output_helpers()
   std::vector<double> con_constant;
   std::vector<bool> con_is_equality;
   std::vector<size_t> con_weight;
-  std::vector<size_t> con_unsat_idxs;
-  std::vector<size_t> con_pos_in_unsat_idxs;
-  std::vector<size_t> con_sat_idxs;
+  std::vector<Model_Idx> con_unsat_idxs;
+  std::vector<Model_Idx> con_pos_in_unsat_idxs;
+  std::vector<Model_Idx> con_sat_idxs;
   std::vector<size_t> var_last_dec_step;
   std::vector<size_t> var_last_inc_step;
   std::vector<size_t> var_allow_inc_step;
@@ -56,8 +56,8 @@ void test_neighbor_ctx_output_helpers()
   size_t cur_step = 0;
   size_t last_improve_step = 0;
   bool current_obj_breakthrough = false;
-  std::vector<size_t> binary_idx_list;
-  std::vector<size_t> non_fixed_var_idx_list;
+  std::vector<Model_Idx> binary_idx_list;
+  std::vector<Model_Idx> non_fixed_var_idx_list;
   Readonly_Ctx shared(model_manager,
                       var_current_value,
                       var_best_value,
@@ -7,12 +7,14 @@
 
 =====================================================================================*/
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <limits>
 #include <memory>
+#include <random>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -21,6 +23,8 @@
 #define protected public
 #include "Local_MIP.h"
 #include "local_search/Local_Search.h"
+#include "local_search/activity/row_activity.h"
+#include "utils/worker_pool.h"
 #undef private
 #undef protected
 
@@ -394,7 +398,7 @@ bool test_extended_precision_certification()
               "objective comparison must use the wide recomputed value");
   ok &= check(search->m_con_activity[1] == k_exact_limit,
               "stored double should expose the boundary rounding case");
-  ok &= check(search->m_con_pos_in_unsat_idxs[1] != SIZE_MAX,
+  ok &= check(search->m_con_pos_in_unsat_idxs[1] != k_null_idx,
               "constraint classification must use the wide recomputed value");
   search->m_var_best_value = search->m_var_current_value;
   ok &= check(!search->verify_solution(),
@@ -407,7 +411,7 @@ bool test_extended_precision_certification()
   search->m_con_constant[1] = k_exact_limit;
 
   search->apply_move(static_cast<size_t>(y), -1.0);
-  ok &= check(search->m_con_pos_in_sat_idxs[1] != SIZE_MAX,
+  ok &= check(search->m_con_is_sat[1],
               "move update should preserve stored-state consistency");
   search->apply_move(static_cast<size_t>(y), 1.0);
   if (search->m_con_unsat_idxs.empty())
@@ -416,7 +420,7 @@ bool test_extended_precision_certification()
                 "a rounded fallback state must require certification");
     search->refresh_activities();
   }
-  ok &= check(search->m_con_pos_in_unsat_idxs[1] != SIZE_MAX,
+  ok &= check(search->m_con_pos_in_unsat_idxs[1] != k_null_idx,
               "wide certification must reject a false-feasible round trip");
 
   Model_Builder equality_builder;
@@ -434,11 +438,11 @@ bool test_extended_precision_certification()
   equality_search->m_var_current_value[static_cast<size_t>(eq_x)] = 1.0;
   equality_search->m_var_current_value[static_cast<size_t>(eq_y)] = 1.0;
   equality_search->refresh_activities();
-  ok &= check(equality_search->m_con_pos_in_unsat_idxs[1] != SIZE_MAX,
+  ok &= check(equality_search->m_con_pos_in_unsat_idxs[1] != k_null_idx,
               "wide equality refresh must reject a rounded boundary value");
   equality_search->apply_move(static_cast<size_t>(eq_y), -1.0);
   equality_search->refresh_activities();
-  ok &= check(equality_search->m_con_pos_in_sat_idxs[1] != SIZE_MAX,
+  ok &= check(equality_search->m_con_is_sat[1],
               "wide equality refresh must accept the exact boundary value");
 
   Model_Builder incremental_builder;
@@ -455,12 +459,12 @@ bool test_extended_precision_certification()
   Local_Search* incremental_search = initialize_search(incremental_solver);
   incremental_search->init_state();
   incremental_search->apply_move(static_cast<size_t>(inc_x), 1.0);
-  ok &= check(incremental_search->m_con_pos_in_sat_idxs[1] != SIZE_MAX,
+  ok &= check(incremental_search->m_con_is_sat[1],
               "exact boundary activity should be feasible");
   incremental_search->apply_move(static_cast<size_t>(inc_y), 1.0);
   ok &= check(incremental_search->m_con_activity[1] == k_exact_limit,
               "incremental boundary case should expose double rounding");
-  ok &= check(incremental_search->m_con_pos_in_unsat_idxs[1] != SIZE_MAX,
+  ok &= check(incremental_search->m_con_pos_in_unsat_idxs[1] != k_null_idx,
               "incremental classification must precede double write-back");
   return ok;
 }
@@ -509,6 +513,372 @@ bool test_objective_only_dispatch()
   return ok;
 }
 
+// The intervals must reproduce the tolerance test bit for bit, including
+// fractional and far-away constants where the gap itself rounds.
+bool test_sat_intervals_match_tolerance_test()
+{
+  bool ok = true;
+  for (const double tolerance : {1e-6, 0.0, 0.01})
+  {
+    Model_Builder builder;
+    const int x = builder.add_var(
+        "x", -1000.0, 1000.0, 1.0, Var_Type::general_integer);
+    builder.add_con(
+        k_neg_inf, 7.0, std::vector<int>{x}, std::vector<double>{1.0});
+    builder.add_con(
+        4.0, 4.0, std::vector<int>{x}, std::vector<double>{1.0});
+    Model_Prepare_Options options;
+    options.bound_strengthen = 0;
+    options.split_eq = false;
+    options.feas_tolerance = tolerance;
+    Local_MIP solver(builder.prepare(options));
+    Local_Search* search = initialize_search(solver);
+    ok &= check(search->m_use_exact_double_activity &&
+                    search->m_readonly_ctx.m_con_sat_interval ==
+                        search->m_con_sat_interval.data(),
+                "certified model should publish its sat intervals");
+    for (const double constant : {7.0,
+                                  7.5,
+                                  -3.25,
+                                  0.1,
+                                  1e15 + 0.5,
+                                  k_exact_limit - 0.5,
+                                  -k_exact_limit,
+                                  1e20})
+    {
+      for (size_t con_idx = 1; con_idx < search->m_con_num; ++con_idx)
+        search->m_con_constant[con_idx] = constant;
+      search->build_sat_intervals();
+      for (size_t con_idx = 1; con_idx < search->m_con_num; ++con_idx)
+      {
+        const Sat_Interval& interval = search->m_con_sat_interval[con_idx];
+        const double base = std::clamp(
+            std::floor(constant), -k_exact_limit + 8.0, k_exact_limit - 8.0);
+        for (double offset = -8.0; offset <= 8.0; offset += 1.0)
+        {
+          const double activity = base + offset;
+          ok &= check(interval.contains(activity) ==
+                          search->con_sat(con_idx, activity),
+                      "sat interval should match the tolerance test");
+        }
+        ok &= check(interval.contains(k_exact_limit) ==
+                        search->con_sat(con_idx, k_exact_limit),
+                    "sat interval should hold at the exact range end");
+      }
+    }
+  }
+  return ok;
+}
+
+bool test_compensated_activity()
+{
+  bool ok = true;
+  Model_Builder builder;
+  const int x = builder.add_var("x", 0.0, 1e6, 0.1, Var_Type::real);
+  const int y = builder.add_var("y", 0.0, 1e6, -0.3, Var_Type::real);
+  builder.add_con(k_neg_inf,
+                  3e4,
+                  std::vector<int>{x, y},
+                  std::vector<double>{0.1, 0.7});
+  builder.add_con(k_neg_inf,
+                  5.5,
+                  std::vector<int>{x, y},
+                  std::vector<double>{0.3, -0.1});
+  Local_MIP solver(prepare_model(builder));
+  solver.set_activity_arithmetic("compensated");
+  Local_Search* search = initialize_search(solver);
+  ok &= check(!search->m_use_exact_double_activity &&
+                  search->m_use_compensated_activity,
+              "fractional model should use compensated double on request");
+  ok &= check(search->m_con_activity_tail.size() == search->m_con_num,
+              "compensated mode should allocate the activity tails");
+  search->init_state();
+
+  std::mt19937 rng(3);
+  const double deltas[] = {0.1, -0.1, 1e4 + 0.3, -1e4 - 0.3, 0.7};
+  bool bounded = true;
+  bool classified = true;
+  for (int move = 0; move < 2000; ++move)
+  {
+    search->apply_move(static_cast<size_t>(rng() % 2), deltas[rng() % 5]);
+    for (size_t con_idx = 0; con_idx < search->m_con_num; ++con_idx)
+    {
+      const auto coeffs = search->m_matrix->row_coeffs(con_idx);
+      const auto var_idxs = search->m_matrix->row_var_idxs(con_idx);
+      long double exact = 0.0L;
+      long double magnitude = 0.0L;
+      for (size_t term = 0; term < coeffs.size(); ++term)
+      {
+        const long double product =
+            static_cast<long double>(coeffs[term]) *
+            search->m_var_current_value[var_idxs[term]];
+        exact += product;
+        magnitude += std::fabs(product);
+      }
+      const Activity_Tail& tail = search->m_con_activity_tail[con_idx];
+      const long double compensated =
+          static_cast<long double>(search->m_con_activity[con_idx]) +
+          static_cast<long double>(tail.m_comp);
+      // A recomputation rounds each of its products once.
+      bounded &= std::fabs(exact - compensated) <=
+                 tail.m_err + 2.0L * k_unit_roundoff * magnitude;
+      if (con_idx != 0)
+        classified &=
+            search->con_sat(con_idx, search->m_con_activity[con_idx]) ==
+            search->m_con_is_sat[con_idx];
+    }
+  }
+  ok &= check(bounded, "tracked error should bound the compensated drift");
+  ok &= check(classified, "compensated updates should keep the sat bitset");
+  ok &= check(search->m_activity_hits == 0,
+              "compensated mode should not count toward periodic refresh");
+
+  // An error bound wider than the gap forces a row recomputation.
+  search->m_con_activity_tail[1].m_err = 1e9;
+  const size_t refreshes = search->m_uncertain_row_refreshes;
+  search->apply_move(static_cast<size_t>(x),
+                     search->m_var_current_value[static_cast<size_t>(x)] >
+                             5e5
+                         ? -0.1
+                         : 0.1);
+  ok &= check(search->m_uncertain_row_refreshes == refreshes + 1,
+              "uncertain row should be recomputed");
+  ok &= check(search->m_con_activity_tail[1].m_err == 0.0,
+              "recomputed row should restart its error bound");
+
+  Model_Builder integer_builder;
+  const int z = integer_builder.add_var(
+      "z", 0.0, 10.0, 1.0, Var_Type::general_integer);
+  integer_builder.add_con(
+      k_neg_inf, 7.0, std::vector<int>{z}, std::vector<double>{3.0});
+  Local_MIP integer_solver(prepare_model(integer_builder));
+  integer_solver.set_activity_arithmetic("compensated");
+  Local_Search* integer_search = initialize_search(integer_solver);
+  ok &= check(integer_search->m_use_exact_double_activity &&
+                  !integer_search->m_use_compensated_activity,
+              "certified model should keep exact double");
+  return ok;
+}
+
+// Rows of every length around the 4- and 8-lane widths, with values set
+// directly so the refresh sees a mix of satisfied and violated rows.
+bool test_row_activity_kernels()
+{
+  Model_Builder builder;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> coeff_dist(1, 9);
+  const int var_num = 64;
+  for (int var = 0; var < var_num; ++var)
+  {
+    std::string name = "x";
+    name += std::to_string(var);
+    builder.add_var(name,
+                    -50.0,
+                    50.0,
+                    static_cast<double>(var % 5 - 2),
+                    Var_Type::general_integer);
+  }
+  for (int term_num = 1; term_num <= 37; ++term_num)
+  {
+    std::vector<int> var_idxs;
+    std::vector<double> coeffs;
+    for (int term = 0; term < term_num; ++term)
+    {
+      var_idxs.push_back((term_num * 11 + term * 3) % var_num);
+      coeffs.push_back(coeff_dist(rng) * (term % 2 == 0 ? 1.0 : -1.0));
+    }
+    builder.add_con(k_neg_inf, static_cast<double>(term_num), var_idxs, coeffs);
+  }
+
+  bool ok = true;
+  Local_MIP solver(prepare_model(builder));
+  solver.set_score_threads(3);
+  Local_Search* search = initialize_search(solver);
+  ok &= check(search->m_use_exact_double_activity,
+              "bounded integer model should use exact double");
+  std::uniform_int_distribution<int> value_dist(-50, 50);
+  for (auto& value : search->m_var_current_value)
+    value = value_dist(rng);
+  const Model_Matrix& matrix = *search->m_matrix;
+  const double* values = search->m_var_current_value.data();
+  std::vector<double> expected(matrix.row_num());
+  for (size_t row = 0; row < matrix.row_num(); ++row)
+  {
+    const auto coeffs = matrix.row_coeffs(row);
+    const auto var_idxs = matrix.row_var_idxs(row);
+    for (size_t term = 0; term < coeffs.size(); ++term)
+      expected[row] += coeffs[term] * values[var_idxs[term]];
+  }
+
+  Worker_Pool pool(3);
+  for (Activity_Kernel kernel : {Activity_Kernel::scalar,
+                                 Activity_Kernel::avx2,
+                                 Activity_Kernel::avx512})
+  {
+    if (!Row_Activity::is_supported(kernel))
+    {
+      std::printf("Skipping %s kernel: not supported by this CPU.\n",
+                  Row_Activity::kernel_name(kernel));
+      continue;
+    }
+    Row_Activity row_activity(kernel, 1);
+    ok &= check(row_activity.kernel() == kernel,
+                "supported kernel should be selected as requested");
+    std::vector<double> serial(matrix.row_num(), -1.0);
+    row_activity.compute(matrix, values, 0, matrix.row_num(), serial.data());
+    ok &= check(serial == expected,
+                "vector kernel should match the scalar row loop");
+    std::vector<double> parallel(matrix.row_num(), -1.0);
+    row_activity.compute_all(matrix, values, parallel.data(), &pool);
+    ok &= check(parallel == expected,
+                "row-parallel kernel should match the scalar row loop");
+  }
+
+  ok &= check(search->m_worker_pool != nullptr,
+              "several scoring threads should create the worker pool");
+  search->m_row_activity = Row_Activity(Row_Activity::best_supported(), 1);
+  search->m_con_constant[0] = k_inf;
+  search->refresh_activities();
+  ok &= check(search->m_con_activity == expected,
+              "parallel refresh should store the scalar activities");
+  for (size_t con_idx = 1; con_idx < search->m_con_num; ++con_idx)
+  {
+    const bool is_sat = expected[con_idx] <= search->m_con_constant[con_idx];
+    ok &= check(is_sat == search->m_con_is_sat[con_idx],
+                "parallel refresh should classify rows like the scalar loop");
+  }
+  ok &= check(!search->m_con_unsat_idxs.empty() &&
+                  search->m_con_unsat_idxs.size() + 1 < search->m_con_num,
+              "kernel test model should have both row states");
+  return ok;
+}
+
+bool test_con_status_bitset()
+{
+  Model_Builder builder;
+  std::vector<int> vars;
+  for (int var_idx = 0; var_idx < 30; ++var_idx)
+  {
+    std::string name = "x";
+    name += std::to_string(var_idx);
+    vars.push_back(builder.add_var(name,
+                                   0.0,
+                                   3.0,
+                                   1.0,
+                                   Var_Type::general_integer));
+  }
+  std::mt19937 model_rng(11);
+  for (int con_idx = 0; con_idx < 80; ++con_idx)
+  {
+    std::vector<int> con_vars;
+    std::vector<double> coeffs;
+    for (int term = 0; term < 4; ++term)
+    {
+      const int var = vars[model_rng() % vars.size()];
+      if (std::find(con_vars.begin(), con_vars.end(), var) !=
+          con_vars.end())
+        continue;
+      con_vars.push_back(var);
+      coeffs.push_back(static_cast<double>(model_rng() % 5) + 1.0);
+    }
+    builder.add_con(
+        k_neg_inf, static_cast<double>(model_rng() % 40), con_vars, coeffs);
+  }
+  Local_MIP solver(prepare_model(builder));
+  Local_Search* search = initialize_search(solver);
+  search->init_state();
+
+  bool ok = true;
+  bool matches = true;
+  std::mt19937 rng(5);
+  auto random_move = [&]()
+  {
+    const size_t var_idx = rng() % search->m_var_num;
+    const double value = search->m_var_current_value[var_idx];
+    double delta = (rng() % 2 == 0) ? 1.0 : -1.0;
+    if (value + delta < 0.0 || value + delta > 3.0)
+      delta = -delta;
+    search->apply_move(var_idx, delta);
+  };
+  for (int move = 0; move < 3000; ++move)
+  {
+    random_move();
+    for (size_t con_idx = 1; con_idx < search->m_con_num; ++con_idx)
+      matches &= search->m_con_is_sat[con_idx] ==
+                 (search->m_con_pos_in_unsat_idxs[con_idx] == k_null_idx);
+  }
+  ok &= check(matches, "sat bitset should complement the unsat list");
+  ok &= check(!search->m_con_unsat_idxs.empty() &&
+                  search->m_con_unsat_idxs.size() + 1 < search->m_con_num,
+              "bitset test model should have both row states");
+
+  search->sync_con_sat_idxs();
+  ok &= check(search->m_con_sat_idxs.empty(),
+              "sat list should not be built without a callback");
+  search->m_publish_con_sat_idxs = true;
+  search->sync_con_sat_idxs();
+  std::vector<Model_Idx> expected;
+  for (size_t con_idx = 1; con_idx < search->m_con_num; ++con_idx)
+  {
+    if (search->m_con_is_sat[con_idx])
+      expected.push_back(static_cast<Model_Idx>(con_idx));
+  }
+  ok &= check(search->m_con_sat_idxs == expected,
+              "synced sat list should hold the sat rows in order");
+
+  Neighbor neighbor("sat_mtm", 1, 1);
+  const size_t sat_num = expected.size();
+  ok &= check(4 * sat_num >= search->m_con_num - 1,
+              "bitset test model should be dense enough for rejection");
+  // 1 and 4 take the rejection path, the last two scan the bitset.
+  for (const size_t max_sample :
+       {size_t{1}, size_t{4}, sat_num - 1, sat_num})
+  {
+    for (int trial = 0; trial < 200; ++trial)
+    {
+      size_t sample_num = 0;
+      std::vector<Model_Idx> sample =
+          neighbor.sample_sat_idxs(search->m_con_is_sat,
+                                   sat_num,
+                                   max_sample,
+                                   sample_num,
+                                   search->m_neighbor_ctx);
+      sample.resize(sample_num);
+      bool valid = sample_num == max_sample;
+      for (const Model_Idx con_idx : sample)
+        valid &= con_idx != 0 && search->m_con_is_sat[con_idx];
+      std::sort(sample.begin(), sample.end());
+      valid &= std::adjacent_find(sample.begin(), sample.end()) ==
+               sample.end();
+      if (!check(valid, "sat sample should hold distinct sat rows"))
+        return false;
+    }
+  }
+
+  // Once published, flips update the list in place instead of marking it
+  // for a rebuild.
+  for (int move = 0; move < 3000; ++move)
+    random_move();
+  bool list_matches = !search->m_con_sat_idxs_stale;
+  size_t listed_num = 0;
+  for (size_t con_idx = 1; con_idx < search->m_con_num; ++con_idx)
+  {
+    const Model_Idx pos = search->m_con_pos_in_sat_idxs[con_idx];
+    if (!search->m_con_is_sat[con_idx])
+    {
+      list_matches &= pos == k_null_idx;
+      continue;
+    }
+    ++listed_num;
+    list_matches &= pos != k_null_idx &&
+                    search->m_con_sat_idxs[pos] == con_idx;
+  }
+  list_matches &= listed_num == search->m_con_sat_idxs.size();
+  ok &= check(list_matches,
+              "published sat list should follow moves without a rebuild");
+  return ok;
+}
+
 } // namespace
 
 int main()
@@ -519,6 +889,10 @@ int main()
   ok &= test_long_exact_move_sequence();
   ok &= test_extended_precision_certification();
   ok &= test_objective_only_dispatch();
+  ok &= test_row_activity_kernels();
+  ok &= test_compensated_activity();
+  ok &= test_sat_intervals_match_tolerance_test();
+  ok &= test_con_status_bitset();
   if (!ok)
     return 1;
   std::printf("All activity arithmetic tests passed.\n");
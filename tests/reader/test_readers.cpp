@@ -29,10 +29,12 @@
 #define private public
 #define protected public
 #include "model_data/Model_Manager.h"
+#include "reader/Compressed_Input.h"
 #include "reader/LP_Reader.h"
 #include "reader/MPS_Reader.h"
 #include "reader/Model_Reader.h"
 #include "reader/Sol_Reader.h"
+#include "reader/Sol_Writer.h"
 #undef private
 #undef protected
 
@@ -418,6 +420,63 @@ protected:
   }
 };
 
+class Test_Sol_Writer_Round_Trip : public Test_Runner
+{
+public:
+  Test_Sol_Writer_Round_Trip() : Test_Runner("SOL Writer Round Trip") {}
+
+protected:
+  void execute() override
+  {
+    const std::string sol_file = "tmp_writer_round_trip.sol";
+
+    Model_Manager manager;
+    MPS_Reader reader(&manager);
+    reader.read(TEST_MPS_PATH);
+    manager.process_after_read();
+
+    std::vector<double> values(manager.var_num(), 0.0);
+    values[manager.var("x17750").idx()] = 1.0;
+    values[manager.var("x17751").idx()] = 0.1;
+
+    std::string buffer;
+    Sol_Writer::format(manager, values, buffer);
+    check(buffer.find("Variable name") == 0,
+          "Formatted solution should start with the header");
+    check(buffer.find("x17752") == std::string::npos,
+          "Zero values should not be written");
+
+    check(Sol_Writer::write_atomically(sol_file, buffer),
+          "Atomic write should succeed");
+    std::FILE* tmp = std::fopen((sol_file + ".tmp").c_str(), "r");
+    check(tmp == nullptr, "Temporary file should be renamed away");
+    if (tmp != nullptr)
+      std::fclose(tmp);
+
+    std::vector<double> solution;
+    Sol_Read_Result result =
+        Sol_Reader::read(sol_file, manager, solution);
+    check(result.m_success, "Written solution should be readable");
+    check(result.m_loaded_var_num == 2,
+          "Only nonzero values should be read back");
+    check(solution[manager.var("x17751").idx()] == 0.1,
+          "Values should round-trip exactly");
+
+    std::string previous = buffer;
+    values[manager.var("x17751").idx()] = 2.5;
+    Sol_Writer::format(manager, values, buffer);
+    check(buffer != previous, "Formatting should replace the buffer");
+    check(Sol_Writer::write_atomically(sol_file, buffer),
+          "Atomic write should replace an existing file");
+    result = Sol_Reader::read(sol_file, manager, solution);
+    check(result.m_success &&
+              solution[manager.var("x17751").idx()] == 2.5,
+          "Replaced file should hold the new solution");
+
+    std::remove(sol_file.c_str());
+  }
+};
+
 class Test_Sol_Reader_Integrality : public Test_Runner
 {
 public:
@@ -1098,6 +1157,447 @@ protected:
   }
 };
 
+class Test_MPS_Number_Syntax : public Test_Runner
+{
+private:
+  const char* m_mps_file = "tmp_mps_number_syntax.mps";
+
+  bool write_model(const char* p_coeff, bool p_final_newline)
+  {
+    std::FILE* fp = std::fopen(m_mps_file, "w");
+    if (fp == nullptr)
+    {
+      check(false, "Should create MPS number-syntax test file");
+      return false;
+    }
+    std::fprintf(fp,
+                 "NAME test\n"
+                 "ROWS\n N OBJ\n L C\n"
+                 "COLUMNS\n x OBJ 1 C %s\n"
+                 "RHS\n RHS C +2.5\n"
+                 "BOUNDS\n UP BND x 4\n"
+                 "ENDATA%s",
+                 p_coeff,
+                 p_final_newline ? "\n" : "");
+    std::fclose(fp);
+    return true;
+  }
+
+  bool read_coeff(const char* p_coeff, double& p_coeff_value)
+  {
+    if (!write_model(p_coeff, true))
+      return false;
+    bool accepted = true;
+    try
+    {
+      Model_Manager manager;
+      MPS_Reader reader(&manager);
+      reader.read(m_mps_file);
+      const Model_Con& con = manager.con("C");
+      p_coeff_value = con.term_num() == 1 ? con.coeff(0) : 0.0;
+    }
+    catch (const Solver_Error&)
+    {
+      accepted = false;
+    }
+    std::remove(m_mps_file);
+    return accepted;
+  }
+
+public:
+  Test_MPS_Number_Syntax() : Test_Runner("MPS Number Syntax") {}
+
+protected:
+  void execute() override
+  {
+    double value = 0.0;
+    check(read_coeff("+3", value), "A leading plus sign should be accepted");
+    check_double(value, 3.0, "A leading plus sign should keep the value");
+    check(read_coeff(".5e1", value), "A bare fraction should be accepted");
+    check_double(value, 5.0, "A bare fraction should parse its exponent");
+    check(read_coeff("-2.", value), "A trailing decimal point is valid");
+    check_double(value, -2.0, "A trailing decimal point keeps the value");
+    check(read_coeff("1e-400", value),
+          "An underflowing coefficient should be accepted");
+    check_double(value, 0.0, "An underflowing coefficient is skipped");
+    check(!read_coeff("1e", value),
+          "A dangling exponent marker should be rejected");
+    check(!read_coeff("1e400", value),
+          "An overflowing coefficient should be rejected");
+    check(!read_coeff("inf", value),
+          "A non-finite coefficient should be rejected");
+    check(!read_coeff("+-1", value),
+          "Two signs should be rejected");
+
+    if (!write_model("2", false))
+      return;
+    Model_Manager manager;
+    MPS_Reader reader(&manager);
+    reader.read(m_mps_file);
+    check_double(manager.con("C").rhs(),
+                 2.5,
+                 "RHS values should be read from the mapped file");
+    check_double(manager.var("x").upper_bound(),
+                 4.0,
+                 "A final record without a newline should still be read");
+    std::remove(m_mps_file);
+  }
+};
+
+class Test_MPS_Parallel_Columns : public Test_Runner
+{
+private:
+  const char* m_mps_file = "tmp_mps_parallel_columns.mps";
+
+  void write_model(bool p_with_error)
+  {
+    std::FILE* fp = std::fopen(m_mps_file, "w");
+    if (fp == nullptr)
+      return;
+    std::fprintf(fp, "NAME parallel\nROWS\n N OBJ\n N FREE\n");
+    for (size_t row = 0; row < 20; ++row)
+      std::fprintf(fp, " %c R%zu\n", "LGE"[row % 3], row);
+    std::fprintf(fp, "COLUMNS\n");
+    for (size_t col = 0; col < 200; ++col)
+    {
+      if (col % 50 == 10)
+        std::fprintf(fp, "    M1 'MARKER' 'INTORG'\n");
+      if (col % 50 == 30)
+        std::fprintf(fp, "    M2 'MARKER' 'INTEND'\n");
+      std::fprintf(fp, "    X%zu OBJ %zu FREE 1\n", col, col % 5);
+      std::fprintf(fp,
+                   "    X%zu R%zu %zu.5 R%zu 1e-12\n",
+                   col,
+                   col % 20,
+                   col % 7,
+                   (col * 7) % 20);
+      if (col % 3 == 0)
+        std::fprintf(fp, "* comment\n    X%zu R%zu -2\n", col, (col + 3) % 20);
+      if (p_with_error && col == 150)
+        std::fprintf(fp, "    X%zu R1 1abc\n", col);
+    }
+    std::fprintf(fp, "    X5 R19 3\n    X120 R0 4\n");
+    std::fprintf(fp, "RHS\n    RHS R0 1 R1 2\nBOUNDS\n UP BND X3 4\nENDATA\n");
+    std::fclose(fp);
+  }
+
+  std::string read_error(size_t p_worker_num)
+  {
+    try
+    {
+      Model_Manager manager;
+      MPS_Reader reader(&manager);
+      reader.set_column_workers(p_worker_num);
+      reader.m_min_column_chunk = 1;
+      reader.read(m_mps_file);
+    }
+    catch (const Solver_Error& error)
+    {
+      return error.what();
+    }
+    return "";
+  }
+
+public:
+  Test_MPS_Parallel_Columns() : Test_Runner("MPS Parallel Columns") {}
+
+protected:
+  void execute() override
+  {
+    write_model(false);
+    Model_Manager serial;
+    MPS_Reader serial_reader(&serial);
+    serial_reader.set_column_workers(1);
+    serial_reader.read(m_mps_file);
+
+    for (size_t worker_num : {2, 3, 8})
+    {
+      Model_Manager parallel;
+      MPS_Reader parallel_reader(&parallel);
+      parallel_reader.set_column_workers(worker_num);
+      parallel_reader.m_min_column_chunk = 1;
+      parallel_reader.read(m_mps_file);
+
+      bool same = serial.m_var_list.size() == parallel.m_var_list.size() &&
+                  serial.m_con_list.size() == parallel.m_con_list.size() &&
+                  serial_reader.m_small_coeff_counter ==
+                      parallel_reader.m_small_coeff_counter;
+      for (size_t var_idx = 0; same && var_idx < serial.m_var_list.size();
+           ++var_idx)
+      {
+        const Model_Var& lhs = serial.var(var_idx);
+        const Model_Var& rhs = parallel.var(var_idx);
+        same = lhs.name() == rhs.name() && lhs.type() == rhs.type() &&
+               lhs.upper_bound() == rhs.upper_bound() &&
+               lhs.con_idx_set() == rhs.con_idx_set() &&
+               lhs.m_pos_in_con_list == rhs.m_pos_in_con_list;
+      }
+      for (size_t con_idx = 0; same && con_idx < serial.m_con_list.size();
+           ++con_idx)
+      {
+        const Model_Con& lhs = serial.con(con_idx);
+        const Model_Con& rhs = parallel.con(con_idx);
+        same = lhs.name() == rhs.name() && lhs.rhs() == rhs.rhs() &&
+               lhs.var_idx_set() == rhs.var_idx_set() &&
+               lhs.coeff_set() == rhs.coeff_set() &&
+               lhs.m_pos_in_var_list == rhs.m_pos_in_var_list;
+      }
+      check(same, "Parallel COLUMNS parsing should build the serial model");
+    }
+
+    write_model(true);
+    const std::string serial_error = read_error(1);
+    check(!serial_error.empty(), "A malformed coefficient should be rejected");
+    check(read_error(4) == serial_error,
+          "Parallel COLUMNS parsing should report the serial error line");
+    std::remove(m_mps_file);
+  }
+};
+
+class Test_Compressed_Model_Input : public Test_Runner
+{
+private:
+  const char* m_mps_file = "tmp_compressed_input.mps";
+
+  const char* m_lp_file = "tmp_compressed_input.lp";
+
+  // Larger than a decode block, so records straddle block boundaries.
+  void write_models()
+  {
+    std::FILE* fp = std::fopen(m_mps_file, "w");
+    if (fp == nullptr)
+      return;
+    std::fprintf(fp, "NAME compressed\nROWS\n N OBJ\n");
+    for (size_t row = 0; row < 20; ++row)
+      std::fprintf(fp, " %c R%zu\n", "LGE"[row % 3], row);
+    std::fprintf(fp, "COLUMNS\n");
+    for (size_t col = 0; col < 40000; ++col)
+    {
+      std::fprintf(fp, "    X%zu OBJ %zu R%zu 1.5\n", col, col % 5, col % 20);
+      std::fprintf(
+          fp, "    X%zu R%zu -%zu\n", col, (col * 7 + 3) % 20, col % 9 + 1);
+    }
+    std::fprintf(fp, "RHS\n    RHS R0 1 R1 2\nBOUNDS\n UP BND X3 4\nENDATA\n");
+    std::fclose(fp);
+
+    fp = std::fopen(m_lp_file, "w");
+    if (fp == nullptr)
+      return;
+    std::fprintf(fp,
+                 "Minimize\n obj: x + 2 y\nSubject To\n c1: x + y >= 1\n"
+                 "Bounds\n 0 <= x <= 4\nGenerals\n y\nEnd\n");
+    std::fclose(fp);
+  }
+
+  static bool run_tool(const std::string& p_command)
+  {
+    return std::system((p_command + " 2>/dev/null").c_str()) == 0;
+  }
+
+  static bool same_model(const Model_Manager& p_lhs, const Model_Manager& p_rhs)
+  {
+    bool same = p_lhs.m_var_list.size() == p_rhs.m_var_list.size() &&
+                p_lhs.m_con_list.size() == p_rhs.m_con_list.size();
+    for (size_t var_idx = 0; same && var_idx < p_lhs.m_var_list.size();
+         ++var_idx)
+    {
+      const Model_Var& lhs = p_lhs.var(var_idx);
+      const Model_Var& rhs = p_rhs.var(var_idx);
+      same = lhs.name() == rhs.name() && lhs.type() == rhs.type() &&
+             lhs.upper_bound() == rhs.upper_bound() &&
+             lhs.con_idx_set() == rhs.con_idx_set();
+    }
+    for (size_t con_idx = 0; same && con_idx < p_lhs.m_con_list.size();
+         ++con_idx)
+    {
+      const Model_Con& lhs = p_lhs.con(con_idx);
+      const Model_Con& rhs = p_rhs.con(con_idx);
+      same = lhs.name() == rhs.name() && lhs.rhs() == rhs.rhs() &&
+             lhs.var_idx_set() == rhs.var_idx_set() &&
+             lhs.coeff_set() == rhs.coeff_set();
+    }
+    return same;
+  }
+
+  static std::string read_error(const std::string& p_file)
+  {
+    try
+    {
+      Model_Manager manager;
+      read_model_file(p_file, manager);
+    }
+    catch (const Solver_Error& error)
+    {
+      return error.what();
+    }
+    return "";
+  }
+
+  // Keeps the first half, so the stream ends inside a member.
+  static void truncate_file(const std::string& p_file)
+  {
+    std::FILE* fp = std::fopen(p_file.c_str(), "rb");
+    if (fp == nullptr)
+      return;
+    std::string bytes;
+    char buffer[4096];
+    size_t size = 0;
+    while ((size = std::fread(buffer, 1, sizeof(buffer), fp)) > 0)
+      bytes.append(buffer, size);
+    std::fclose(fp);
+    fp = std::fopen(p_file.c_str(), "wb");
+    if (fp == nullptr)
+      return;
+    std::fwrite(bytes.data(), 1, bytes.size() / 2, fp);
+    std::fclose(fp);
+  }
+
+public:
+  Test_Compressed_Model_Input() : Test_Runner("Compressed Model Input") {}
+
+protected:
+  void execute() override
+  {
+    write_models();
+    Model_Manager plain_mps;
+    read_model_file(m_mps_file, plain_mps);
+    Model_Manager plain_lp;
+    read_model_file(m_lp_file, plain_lp);
+
+    const struct
+    {
+      Compression compression;
+      const char* extension;
+      const char* tool;
+    } formats[] = {{Compression::gzip, ".gz", "gzip"},
+                   {Compression::bzip2, ".bz2", "bzip2"},
+                   {Compression::xz, ".xz", "xz"},
+                   {Compression::zstd, ".zst", "zstd -q"}};
+    // Files are compressed with the command line tools; a format whose
+    // tool is not installed is skipped.
+    for (const auto& format : formats)
+    {
+      const std::string mps_file = std::string(m_mps_file) + format.extension;
+      const std::string lp_file = std::string(m_lp_file) + format.extension;
+      const std::string tool = format.tool;
+      if (run_tool(tool + " -c " + m_mps_file + " > " + mps_file) &&
+          run_tool(tool + " -c " + m_lp_file + " > " + lp_file))
+      {
+        if (!Compressed_Input::is_supported(format.compression))
+        {
+          check(read_error(mps_file).find(Compressed_Input::name(
+                    format.compression)) != std::string::npos,
+                "A codec missing from the build should be reported by name");
+        }
+        else
+        {
+          Model_Manager mps_manager;
+          read_model_file(mps_file, mps_manager);
+          check(same_model(plain_mps, mps_manager),
+                "A compressed MPS file should read like the plain file");
+          Model_Manager lp_manager;
+          read_model_file(lp_file, lp_manager);
+          check(same_model(plain_lp, lp_manager),
+                "A compressed LP file should read like the plain file");
+          truncate_file(mps_file);
+          check(!read_error(mps_file).empty(),
+                "A truncated compressed file should be rejected");
+        }
+      }
+      std::remove(mps_file.c_str());
+      std::remove(lp_file.c_str());
+    }
+
+    // pigz-style output: several gzip members back to back.
+    if (Compressed_Input::is_supported(Compression::gzip))
+    {
+      std::FILE* fp = std::fopen("tmp_compressed_head.mps", "w");
+      if (fp != nullptr)
+      {
+        std::fprintf(fp, "NAME members\nROWS\n N OBJ\n L R0\nCOLUMNS\n");
+        std::fclose(fp);
+      }
+      fp = std::fopen("tmp_compressed_tail.mps", "w");
+      if (fp != nullptr)
+      {
+        std::fprintf(fp, "    X0 OBJ 1 R0 2\nRHS\n    RHS R0 3\nENDATA\n");
+        std::fclose(fp);
+      }
+      const std::string gz_file = "tmp_compressed_members.mps.gz";
+      if (run_tool("gzip -c tmp_compressed_head.mps > " + gz_file) &&
+          run_tool("gzip -c tmp_compressed_tail.mps >> " + gz_file))
+      {
+        Model_Manager manager;
+        read_model_file(gz_file, manager);
+        check(manager.m_var_list.size() == 1 &&
+                  manager.con("R0").coeff_set().size() == 1,
+              "Concatenated gzip members should be decoded in sequence");
+        check_double(manager.con("R0").rhs(),
+                     3.0,
+                     "Records after a member boundary should be read");
+      }
+      std::remove("tmp_compressed_head.mps");
+      std::remove("tmp_compressed_tail.mps");
+      std::remove(gz_file.c_str());
+
+      check(read_error("tmp_compressed_missing.mps.gz").find("not found") !=
+                std::string::npos,
+            "A missing compressed file should be reported as not found");
+    }
+    std::remove(m_mps_file);
+    std::remove(m_lp_file);
+  }
+};
+
+class Test_LP_Streaming_Tokenizer : public Test_Runner
+{
+public:
+  Test_LP_Streaming_Tokenizer() : Test_Runner("LP Streaming Tokenizer") {}
+
+protected:
+  void execute() override
+  {
+    const char* lp_file = "tmp_lp_streaming.lp";
+    std::FILE* fp = std::fopen(lp_file, "wb");
+    if (fp == nullptr)
+    {
+      check(false, "Should create LP tokenizer test file");
+      return;
+    }
+    // CRLF records, comments, a skipped '\' line, an out-of-range and an
+    // underflowing coefficient, and no newline after End.
+    std::fprintf(fp,
+                 "Minimize\r\n obj: x + 2.5e0 y // + 7 z\r\n"
+                 "Subject To\r\n \\ c0: x >= 9\r\n"
+                 " c1: +.5 x - 1e400 y + 1e-400 z\r\n >= -3\r\n"
+                 "Bounds\r\n -1E+1 <= x <= 4.\r\nEnd");
+    std::fclose(fp);
+
+    Model_Manager manager;
+    LP_Reader reader(&manager);
+    reader.read(lp_file);
+    std::remove(lp_file);
+    check(manager.m_con_list.size() == 2,
+          "A line starting with '\\' should be skipped");
+    check(manager.m_var_list.size() == 2,
+          "Text after // and zero coefficients should not create variables");
+    const Model_Con& con = manager.con("c1");
+    check(con.var_idx_set().size() == 2,
+          "A constraint may span several lines");
+    check_double(con.coeff_set()[0], 0.5, "A leading '+' should be accepted");
+    check_double(con.coeff_set()[1],
+                 -k_inf,
+                 "An overflowing coefficient should saturate to infinity");
+    check_double(con.rhs(), -3.0, "The right-hand side should be read");
+    check_double(manager.var("x").lower_bound(),
+                 -10.0,
+                 "Exponent numbers should be parsed");
+    check_double(manager.var("x").upper_bound(),
+                 4.0,
+                 "A trailing '.' should be accepted");
+  }
+};
+
 } // namespace
 
 int main()
@@ -1116,12 +1616,17 @@ int main()
   suite.add_test(new Test_Sol_Reader_Bound_Error());
   suite.add_test(new Test_Sol_Reader_Duplicate_Variable());
   suite.add_test(new Test_Sol_Reader_Integrality());
+  suite.add_test(new Test_Sol_Writer_Round_Trip());
   suite.add_test(new Test_LP_Integer_Bound_Normalization());
   suite.add_test(new Test_MPS_Fractional_Integer_Fixed_Bound());
   suite.add_test(new Test_MPS_Integer_Bound_Types());
   suite.add_test(new Test_MPS_Bound_Semantics());
   suite.add_test(new Test_MPS_Bound_Value_Syntax());
   suite.add_test(new Test_MPS_Free_Row_Semantics());
+  suite.add_test(new Test_MPS_Number_Syntax());
+  suite.add_test(new Test_MPS_Parallel_Columns());
+  suite.add_test(new Test_Compressed_Model_Input());
+  suite.add_test(new Test_LP_Streaming_Tokenizer());
 
   bool ok = suite.run_all();
 
@@ -29,13 +29,18 @@
 
 #define private public
 #define protected public
+#include "Local_MIP.h"
+#include "local_search/Local_Search.h"
 #include "local_search/context/context.h"
+#include "local_search/scoring/parallel_scoring.h"
 #include "local_search/scoring/scoring.h"
 #include "model_data/Model_Manager.h"
 
 #undef private
 #undef protected
 
+#include "model_api/Model_Builder.h"
+
 using namespace test_utils;
 
 namespace
@@ -84,8 +89,8 @@ struct Test_Shared_Data
   std::vector<double> con_constant;
   std::vector<bool> con_is_equality;
   std::vector<size_t> con_weight;
-  std::vector<size_t> con_unsat_idxs;
-  std::vector<size_t> con_pos_in_unsat_idxs;
+  std::vector<Model_Idx> con_unsat_idxs;
+  std::vector<Model_Idx> con_pos_in_unsat_idxs;
   std::vector<size_t> var_last_dec_step;
   std::vector<size_t> var_last_inc_step;
   std::vector<double> var_obj_cost;
@@ -97,10 +102,10 @@ struct Test_Shared_Data
   std::vector<size_t> var_allow_dec_step;
   bool current_obj_breakthrough;
   size_t obj_var_num;
-  std::vector<size_t> binary_idx_list;
+  std::vector<Model_Idx> binary_idx_list;
   std::vector<double> var_current_value;
-  std::vector<size_t> con_sat_idxs;
-  std::vector<size_t> non_fixed_var_idxs;
+  std::vector<Model_Idx> con_sat_idxs;
+  std::vector<Model_Idx> non_fixed_var_idxs;
   Readonly_Ctx view;
 };
 
@@ -116,6 +121,7 @@ long score_single_constraint_move(const char* p_method,
   Model_Con& con = manager.con(con_idx);
   var.add_con(con_idx, con.term_num());
   con.add_var(var_idx, 1.0, var.term_num() - 1);
+  manager.build_matrix();
 
   Test_Shared_Data shared(manager);
   shared.con_activity = {0.0, 2.0};
@@ -271,13 +277,278 @@ protected:
           "full progress should remain twice the half-progress score");
     check(negative_half == -1,
           "negative half progress should preserve its sign");
-    check(equality_partial == 2,
-          "equality partial progress should retain its original weight");
-    check(equality_full == 4,
+    check(equality_partial == 1,
+          "equality partial progress should score like an inequality");
+    check(equality_full == 2,
           "equality full progress should remain twice partial progress");
   }
 };
 
+// Test cached neighbor scores against full column rescoring
+class Test_Score_Cache_Consistency : public Test_Runner
+{
+public:
+  Test_Score_Cache_Consistency()
+      : Test_Runner("Infeas Scoring: score cache matches rescoring")
+  {
+  }
+
+protected:
+  void execute() override
+  {
+    for (const char* method : {"progress_bonus", "progress_age"})
+      run_walk(method);
+  }
+
+private:
+  void run_walk(const std::string& p_method)
+  {
+    Model_Builder builder;
+    std::vector<int> vars;
+    for (int var_idx = 0; var_idx < 6; ++var_idx)
+    {
+      const bool is_binary = var_idx % 2 == 0;
+      std::string name = "x";
+      name += std::to_string(var_idx);
+      vars.push_back(builder.add_var(name,
+                                     0.0,
+                                     is_binary ? 1.0 : 5.0,
+                                     var_idx % 3 == 0 ? 0.0 : 1.0 + var_idx,
+                                     is_binary
+                                         ? Var_Type::binary
+                                         : Var_Type::general_integer));
+    }
+    builder.add_con(4.0,
+                    k_inf,
+                    std::vector<int>{vars[0], vars[1], vars[2]},
+                    std::vector<double>{1.0, 2.0, 1.0});
+    builder.add_con(k_neg_inf,
+                    6.0,
+                    std::vector<int>{vars[1], vars[3], vars[4]},
+                    std::vector<double>{1.0, 1.0, 3.0});
+    builder.add_con(3.0,
+                    3.0,
+                    std::vector<int>{vars[2], vars[4], vars[5]},
+                    std::vector<double>{1.0, 1.0, 1.0});
+    builder.add_con(2.0,
+                    k_inf,
+                    std::vector<int>{vars[0], vars[3], vars[5]},
+                    std::vector<double>{2.0, 1.0, 1.0});
+    Model_Prepare_Options options;
+    options.bound_strengthen = 0;
+    options.split_eq = false;
+    Local_MIP solver(builder.prepare(options));
+    solver.set_neighbor_scoring_method(p_method);
+    solver.set_score_cache(true);
+    Local_Search* search = solver.m_local_search.get();
+    search->init_data();
+    search->init_state();
+
+    Scoring::Neighbor_Ctx fresh_ctx(search->m_readonly_ctx,
+                                    search->m_binary_op_stamp,
+                                    search->m_binary_op_stamp_token,
+                                    search->m_best_neighbor_score,
+                                    search->m_best_neighbor_subscore,
+                                    search->m_best_age,
+                                    search->m_best_var_idx,
+                                    search->m_best_delta);
+    std::mt19937 rng(7);
+    size_t mismatches = 0;
+    for (int step = 0; step < 300; ++step)
+    {
+      if (search->m_con_unsat_idxs.empty())
+      {
+        search->update_best_solution();
+        search->m_is_found_feasible = true;
+      }
+      search->explore_neighbor(search->m_explore_neighbor_list);
+      for (size_t var_idx = 0; var_idx < search->m_var_num; ++var_idx)
+      {
+        for (double delta : {-1.0, 1.0})
+        {
+          const double value = search->m_var_current_value[var_idx] + delta;
+          const auto& model_var = search->m_model_manager->var(var_idx);
+          if (value < model_var.lower_bound() ||
+              value > model_var.upper_bound())
+            continue;
+          search->reset_op(false);
+          search->m_scoring.score_neighbor(
+              search->m_scoring_ctx, var_idx, delta);
+          const long cached_score = search->m_best_neighbor_score;
+          const long cached_subscore = search->m_best_neighbor_subscore;
+          search->reset_op(false);
+          search->m_scoring.score_neighbor(fresh_ctx, var_idx, delta);
+          if (cached_score != search->m_best_neighbor_score ||
+              cached_subscore != search->m_best_neighbor_subscore)
+            ++mismatches;
+        }
+      }
+      size_t move_var = search->m_best_var_idx;
+      double move_delta = search->m_best_delta;
+      if (move_var == SIZE_MAX || rng() % 4 == 0)
+      {
+        move_var = rng() % search->m_var_num;
+        const auto& model_var = search->m_model_manager->var(move_var);
+        move_delta = search->m_var_current_value[move_var] <
+                             model_var.upper_bound()
+                         ? 1.0
+                         : -1.0;
+      }
+      search->apply_move(move_var, move_delta);
+      ++search->m_cur_step;
+    }
+    check(mismatches == 0,
+          "Cached scores should match full rescoring");
+    check(search->m_score_cache.hits() > 0,
+          "Score cache should serve repeated lookups");
+  }
+};
+
+class Test_Parallel_Scoring_Matches_Serial : public Test_Runner
+{
+public:
+  Test_Parallel_Scoring_Matches_Serial()
+      : Test_Runner("Infeas Scoring: parallel scoring matches serial order")
+  {
+  }
+
+protected:
+  void execute() override
+  {
+    for (const char* method : {"progress_bonus", "progress_age"})
+      run_walk(method);
+  }
+
+private:
+  struct Choice
+  {
+    size_t var_idx;
+    double delta;
+    long score;
+    long subscore;
+    size_t age;
+
+    bool operator==(const Choice& p_other) const
+    {
+      return var_idx == p_other.var_idx && delta == p_other.delta &&
+             score == p_other.score && subscore == p_other.subscore &&
+             age == p_other.age;
+    }
+  };
+
+  static Choice choice(const Local_Search& p_search)
+  {
+    return Choice{p_search.m_best_var_idx,
+                  p_search.m_best_delta,
+                  p_search.m_best_neighbor_score,
+                  p_search.m_best_neighbor_subscore,
+                  p_search.m_best_age};
+  }
+
+  void run_walk(const std::string& p_method)
+  {
+    std::mt19937 rng(17);
+    Model_Builder builder;
+    std::vector<int> vars;
+    for (int var_idx = 0; var_idx < 80; ++var_idx)
+    {
+      const bool is_binary = var_idx % 3 != 0;
+      std::string name = "x";
+      name += std::to_string(var_idx);
+      vars.push_back(builder.add_var(name,
+                                     0.0,
+                                     is_binary ? 1.0 : 4.0,
+                                     1.0 + var_idx % 5,
+                                     is_binary
+                                         ? Var_Type::binary
+                                         : Var_Type::general_integer));
+    }
+    for (int con_idx = 0; con_idx < 40; ++con_idx)
+    {
+      std::vector<int> con_vars;
+      std::vector<double> coeffs;
+      for (int term = 0; term < 5; ++term)
+      {
+        con_vars.push_back(vars[(con_idx * 7 + term * 11) % 80]);
+        coeffs.push_back(1.0 + (con_idx + term) % 3);
+      }
+      if (con_idx % 4 == 0)
+        builder.add_con(k_neg_inf, 4.0, con_vars, coeffs);
+      else
+        builder.add_con(3.0, k_inf, con_vars, coeffs);
+    }
+    Model_Prepare_Options options;
+    options.bound_strengthen = 0;
+    Local_MIP solver(builder.prepare(options));
+    solver.set_neighbor_scoring_method(p_method);
+    Local_Search* search = solver.m_local_search.get();
+    search->init_data();
+    search->init_state();
+    Worker_Pool pool(3);
+    Parallel_Scoring parallel(pool, 1);
+
+    size_t mismatches = 0;
+    for (int step = 0; step < 200; ++step)
+    {
+      // Repeated variables exercise the binary deduplication.
+      std::vector<size_t> op_var_idxs;
+      std::vector<double> op_var_deltas;
+      for (int op = 0; op < 120; ++op)
+      {
+        const size_t var_idx = rng() % search->m_var_num;
+        const auto& model_var = search->m_model_manager->var(var_idx);
+        const double value = search->m_var_current_value[var_idx];
+        op_var_idxs.push_back(var_idx);
+        op_var_deltas.push_back(value < model_var.upper_bound() ? 1.0
+                                                                : -1.0);
+      }
+      const bool require_positive = step % 2 == 0;
+      search->reset_op(require_positive);
+      for (size_t op = 0; op < op_var_idxs.size(); ++op)
+        search->m_scoring.score_neighbor(
+            search->m_scoring_ctx, op_var_idxs[op], op_var_deltas[op]);
+      const Choice serial = choice(*search);
+      const std::vector<uint32_t> serial_stamps =
+          search->m_binary_op_stamp;
+
+      search->reset_op(require_positive);
+      parallel.score(search->m_scoring,
+                     search->m_scoring_ctx,
+                     op_var_idxs,
+                     op_var_deltas,
+                     op_var_idxs.size());
+      if (!(choice(*search) == serial))
+        ++mismatches;
+      for (size_t var_idx = 0; var_idx < search->m_var_num; ++var_idx)
+      {
+        if ((serial_stamps[var_idx] + 1 ==
+             search->m_binary_op_stamp_token) !=
+            (search->m_binary_op_stamp[var_idx] ==
+             search->m_binary_op_stamp_token))
+          ++mismatches;
+      }
+
+      size_t move_var = search->m_best_var_idx;
+      double move_delta = search->m_best_delta;
+      if (move_var == SIZE_MAX || rng() % 3 == 0)
+      {
+        move_var = op_var_idxs[rng() % op_var_idxs.size()];
+        const auto& model_var = search->m_model_manager->var(move_var);
+        move_delta = search->m_var_current_value[move_var] <
+                             model_var.upper_bound()
+                         ? 1.0
+                         : -1.0;
+      }
+      search->apply_move(move_var, move_delta);
+      ++search->m_cur_step;
+      if (step % 50 == 49)
+        search->m_weight.update(search->m_weight_ctx);
+    }
+    check(mismatches == 0,
+          "Parallel scoring should select the serial move");
+  }
+};
+
 // Test scoring method switching
 class Test_Scoring_Method_Switch : public Test_Runner
 {
@@ -351,6 +622,8 @@ int main()
   suite.add_test(new Test_Infeas_Scoring_Progress_Bonus());
   suite.add_test(new Test_Infeas_Scoring_Progress_Age());
   suite.add_test(new Test_Half_Progress_Scoring());
+  suite.add_test(new Test_Score_Cache_Consistency());
+  suite.add_test(new Test_Parallel_Scoring_Matches_Serial());
   suite.add_test(new Test_Scoring_Method_Switch());
   suite.add_test(new Test_Scoring_Cbk_Priority());
 
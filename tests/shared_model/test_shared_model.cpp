@@ -11,7 +11,10 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <fstream>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <sstream>
@@ -25,6 +28,7 @@
 #define protected public
 #include "Local_MIP.h"
 #include "model_api/Model_Builder.h"
+#include "model_data/Model_Snapshot.h"
 #undef private
 #undef protected
 
@@ -475,6 +479,276 @@ bool test_parallel_shared_search()
   return ok;
 }
 
+bool test_portfolio_search()
+{
+  Shared_Incumbent incumbent;
+  bool ok = true;
+  ok &= check(incumbent.publish(5.0, std::vector<double>{1.0}),
+              "First incumbent should be published");
+  ok &= check(!incumbent.publish(6.0, std::vector<double>{2.0}),
+              "A worse incumbent must not replace the shared best");
+  ok &= check(incumbent.publish(4.0, std::vector<double>{3.0}) &&
+                  incumbent.snapshot()->m_values[0] == 3.0,
+              "A better incumbent should replace the shared snapshot");
+  incumbent.set_cutoff(4.0);
+  ok &= check(incumbent.stop_requested(),
+              "Reaching the cutoff should request a stop");
+
+  Model_Builder builder;
+  std::vector<int> vars;
+  std::vector<double> weights;
+  for (int var_idx = 0; var_idx < 12; ++var_idx)
+  {
+    std::string name = "x";
+    name += std::to_string(var_idx);
+    vars.push_back(builder.add_var(name,
+                                   0.0,
+                                   1.0,
+                                   -(var_idx + 1.0),
+                                   Var_Type::binary));
+    weights.push_back(var_idx + 1.0);
+  }
+  builder.add_con(k_neg_inf, 20.0, vars, weights);
+  Model_Prepare_Options options;
+  options.bound_strengthen = 0;
+  auto prepared = builder.prepare(options);
+
+  Local_MIP solver(prepared);
+  solver.set_threads(3);
+  solver.set_objective_cutoff(-15.0);
+  solver.set_time_limit(5.0);
+  solver.set_log_obj(false);
+  std::exception_ptr error;
+  try
+  {
+    solver.run();
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+  ok &= check(error == nullptr, "Portfolio run should not throw");
+  ok &= check(solver.m_helper_searches.size() == 2,
+              "Portfolio should start one helper per extra thread");
+  ok &= check(solver.is_feasible() && solver.get_obj_value() <= -15.0,
+              "Portfolio should stop at the objective cutoff");
+  ok &= check(solver.m_shared_incumbent != nullptr &&
+                  solver.m_shared_incumbent->best_obj() ==
+                      solver.m_local_search->m_best_obj,
+              "Primary worker should report the shared incumbent");
+  return ok;
+}
+
+bool test_shared_incumbent_cutoff()
+{
+  Model_Builder builder;
+  std::vector<int> vars;
+  std::vector<double> weights;
+  for (int var_idx = 0; var_idx < 8; ++var_idx)
+  {
+    std::string name = "y";
+    name += std::to_string(var_idx);
+    vars.push_back(builder.add_var(name,
+                                   0.0,
+                                   1.0,
+                                   -(var_idx + 2.0),
+                                   Var_Type::binary));
+    weights.push_back(var_idx + 1.0);
+  }
+  builder.add_con(k_neg_inf, 9.0, vars, weights);
+  Model_Prepare_Options options;
+  options.bound_strengthen = 0;
+  auto prepared = builder.prepare(options);
+
+  Shared_Incumbent incumbent;
+  Local_Search direct_search(&prepared->model_manager());
+  direct_search.set_shared_incumbent(&incumbent);
+  direct_search.set_incumbent_sync_period(7);
+  direct_search.init_data();
+  direct_search.init_state();
+  direct_search.tighten_to_shared_incumbent();
+  bool ok = true;
+  ok &= check(direct_search.m_con_constant[0] == k_inf,
+              "An empty shared incumbent must not tighten the objective");
+  incumbent.publish(-100.0, std::vector<double>(vars.size(), 0.0));
+  direct_search.tighten_to_shared_incumbent();
+  ok &= check(direct_search.m_con_constant[0] ==
+                  -100.0 - direct_search.opt_tolerance(),
+              "Shared best should tighten the objective constraint");
+  ok &= check(direct_search.m_next_incumbent_sync_step ==
+                  direct_search.m_cur_step + 7,
+              "Next shared incumbent read should follow the sync period");
+
+  auto shared = std::make_shared<Shared_Incumbent>();
+  Local_MIP first(prepared);
+  Local_MIP second(prepared);
+  for (Local_MIP* solver : {&first, &second})
+  {
+    solver->set_shared_incumbent(shared);
+    solver->set_incumbent_sync_period(1);
+    solver->set_time_limit(0.1);
+    solver->set_log_obj(false);
+  }
+  first.set_random_seed(1);
+  second.set_random_seed(2);
+  std::exception_ptr first_error;
+  std::exception_ptr second_error;
+  std::thread first_worker(
+      [&]()
+      {
+        try
+        {
+          first.run();
+        }
+        catch (...)
+        {
+          first_error = std::current_exception();
+        }
+      });
+  std::thread second_worker(
+      [&]()
+      {
+        try
+        {
+          second.run();
+        }
+        catch (...)
+        {
+          second_error = std::current_exception();
+        }
+      });
+  first_worker.join();
+  second_worker.join();
+  ok &= check(first_error == nullptr && second_error == nullptr,
+              "Solvers sharing an incumbent should finish without throwing");
+  ok &= check(first.is_feasible() && second.is_feasible() &&
+                  first.get_obj_value() == second.get_obj_value(),
+              "Solvers sharing an incumbent should report the shared best");
+  return ok;
+}
+
+bool test_prepared_snapshot()
+{
+  Model_Builder builder;
+  builder.set_sense(Model_Builder::Sense::maximize);
+  builder.set_obj_offset(3.5);
+  std::vector<int> vars;
+  vars.push_back(builder.add_var("b0", 0.0, 1.0, 2.0, Var_Type::binary));
+  vars.push_back(builder.add_var("b1", 0.0, 1.0, -1.0, Var_Type::binary));
+  vars.push_back(
+      builder.add_var("g", -2.0, 6.0, 1.5, Var_Type::general_integer));
+  vars.push_back(builder.add_var("r", 0.0, 4.5, 0.25, Var_Type::real));
+  builder.add_con(k_neg_inf, 7.0, vars, std::vector<double>{1, 2, 3, 1});
+  builder.add_con(2.0, 2.0, {vars[0], vars[1]}, std::vector<double>{1, 1});
+  builder.add_con(1.0, k_inf, {vars[2], vars[3]}, std::vector<double>{1, -1});
+  Model_Prepare_Options options;
+  options.bound_strengthen = 2;
+  options.split_eq = true;
+  auto prepared = builder.prepare(options);
+
+  const std::string snapshot_file = "tmp_prepared_snapshot.lmsnap";
+  prepared->save(snapshot_file);
+  auto loaded = Prepared_Model::load(snapshot_file);
+  const Model_Manager& original = prepared->model_manager();
+  const Model_Manager& restored = loaded->model_manager();
+  bool ok = true;
+  ok &= check(structure_hash(original) == structure_hash(restored),
+              "A loaded snapshot should reproduce the prepared model");
+  ok &= check(restored.bound_strengthen() == 2 && restored.split_eq(),
+              "A loaded snapshot should keep the preparation options");
+  ok &= check(restored.matrix().nnz() == original.matrix().nnz() &&
+                  restored.matrix().row_num() == original.matrix().row_num(),
+              "A loaded snapshot should rebuild the matrix view");
+  ok &= check(restored.var_name_to_idx() == original.var_name_to_idx() &&
+                  restored.con_name_to_idx() == original.con_name_to_idx(),
+              "A loaded snapshot should keep the name lookups");
+
+  Local_MIP solver(loaded);
+  solver.set_log_obj(false);
+  solver.set_time_limit(0.1);
+  solver.run();
+  ok &= check(solver.is_feasible(),
+              "Solver should run on a model loaded from a snapshot");
+
+  std::string bytes;
+  {
+    std::ifstream file(snapshot_file, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file),
+                 std::istreambuf_iterator<char>());
+  }
+  auto rejects = [&](const std::string& p_bytes)
+  {
+    {
+      std::ofstream file(snapshot_file, std::ios::binary | std::ios::trunc);
+      file.write(p_bytes.data(), static_cast<std::streamsize>(p_bytes.size()));
+    }
+    try
+    {
+      Prepared_Model::load(snapshot_file);
+    }
+    catch (const Solver_Error&)
+    {
+      return true;
+    }
+    return false;
+  };
+  std::string corrupted = bytes;
+  corrupted[corrupted.size() / 2] ^= 0x5a;
+  ok &= check(rejects(corrupted), "A corrupted snapshot should be rejected");
+  ok &= check(rejects(bytes.substr(0, bytes.size() - 8)),
+              "A truncated snapshot should be rejected");
+  std::string other_version = bytes;
+  other_version[8] = static_cast<char>(Model_Snapshot::k_version + 1);
+  ok &= check(rejects(other_version),
+              "A snapshot of another format version should be rejected");
+
+  // Offset of the first entry of a column index array. The payload starts
+  // after the 40-byte header with 16 scalar fields and the objective name,
+  // then the variable names and the per-variable arrays.
+  auto column_entry_offset = [&](bool p_pos_array)
+  {
+    size_t pos = 40 + 16 * 8;
+    auto skip = [&](size_t p_elem_size)
+    {
+      uint64_t size = 0;
+      std::memcpy(&size, bytes.data() + pos, sizeof(size));
+      pos += 8 + ((size * p_elem_size + 7) & ~size_t(7));
+    };
+    for (size_t elem_size : {1, 8, 1, 8, 8, 8, 1, 1, 8})
+      skip(elem_size);
+    if (p_pos_array)
+      skip(sizeof(Model_Idx));
+    return pos + 8;
+  };
+  // Rewrites that entry and repairs the checksum, so only the index
+  // validation can catch a bad value.
+  auto with_column_entry = [&](bool p_pos_array, Model_Idx p_value)
+  {
+    std::string edited = bytes;
+    std::memcpy(edited.data() + column_entry_offset(p_pos_array),
+                &p_value,
+                sizeof(p_value));
+    const uint64_t checksum =
+        Model_Snapshot::checksum(edited.data() + 40, edited.size() - 40);
+    std::memcpy(edited.data() + 32, &checksum, sizeof(checksum));
+    return edited;
+  };
+  Model_Idx stored_con_idx = 0;
+  std::memcpy(&stored_con_idx,
+              bytes.data() + column_entry_offset(false),
+              sizeof(stored_con_idx));
+  ok &= check(!rejects(with_column_entry(false, stored_con_idx)),
+              "Rewriting a column entry unchanged should still load");
+  ok &= check(rejects(with_column_entry(false, 1000)),
+              "A constraint index out of range should be rejected");
+  ok &= check(rejects(with_column_entry(true, 1000)),
+              "A position beyond its row should be rejected");
+  ok &= check(rejects(with_column_entry(false, stored_con_idx + 1)),
+              "A column entry pointing at another row should be rejected");
+  std::remove(snapshot_file.c_str());
+  return ok;
+}
+
 bool test_solver_local_tolerance_context()
 {
   Model_Builder builder;
@@ -790,6 +1064,9 @@ int main()
   ok &= test_builder_preparation();
   ok &= test_prepared_parameter_files();
   ok &= test_parallel_shared_search();
+  ok &= test_portfolio_search();
+  ok &= test_shared_incumbent_cutoff();
+  ok &= test_prepared_snapshot();
   ok &= test_solver_local_tolerance_context();
   ok &= test_prepared_solver_is_one_shot();
   ok &= test_distinct_model_tolerance_contexts();
@@ -39,10 +39,10 @@ std::vector<double> generate_start(const Model_Manager& p_manager,
   std::vector<double> con_activity(p_manager.con_num(), 0.0);
   std::vector<double> con_constant(p_manager.con_num(), 0.0);
   std::vector<size_t> con_weight(p_manager.con_num(), 1);
-  std::vector<size_t> con_unsat_idxs;
-  std::vector<size_t> con_pos_in_unsat_idxs(p_manager.con_num(),
-                                            SIZE_MAX);
-  std::vector<size_t> con_sat_idxs;
+  std::vector<Model_Idx> con_unsat_idxs;
+  std::vector<Model_Idx> con_pos_in_unsat_idxs(p_manager.con_num(),
+                                               k_null_idx);
+  std::vector<Model_Idx> con_sat_idxs;
   std::vector<size_t> var_last_dec_step(p_manager.var_num(), 0);
   std::vector<size_t> var_last_inc_step(p_manager.var_num(), 0);
   std::vector<size_t> var_allow_inc_step(p_manager.var_num(), 0);
@@ -191,8 +191,9 @@ bool test_lock_guided()
       api.add_var("tied_objective", -5.0, 7.0, 2.0);
   const int objective_row_skip =
       api.add_var("objective_row_skip", -6.0, 8.0, 1.0);
+  // Wide enough that the equality below implies no tighter domain.
   const int equality_zero =
-      api.add_var("equality_zero", -5.0, 7.0);
+      api.add_var("equality_zero", -16.0, 10.0);
   const int inferred_skip =
       api.add_var("inferred_skip", -4.0, 6.0);
   const int tiny_coeff = api.add_var("tiny_coeff", -3.0, 8.0, -1.0);
@@ -244,6 +245,8 @@ bool test_lock_guided()
   Model_Prepare_Options options;
   options.bound_strengthen = 2;
   options.split_eq = false;
+  // The lock row holds identical columns, which would be merged.
+  options.dup_presolve = false;
   auto prepared = api.prepare(options);
   const auto& manager = prepared->model_manager();
   bool ok = true;
@@ -300,6 +303,7 @@ bool test_split_equality_locks()
 
   Model_Prepare_Options options;
   options.bound_strengthen = 0;
+  options.split_eq = true;
   auto prepared = api.prepare(options);
   const auto& manager = prepared->model_manager();
   bool ok = true;